@@ -1,3 +1,6 @@
+#ifndef GMRESROUTINE
+#define GMRESROUTINE
+
 
 /** *********************************************************************************
  * @file GMRES.h
@@ -65,8 +68,178 @@
  * ********************************************************************************* */
 
 #include "util.h"
+#include "tensor.h"
+#include "monitor.h"
+#include "checkpoint.h"
 #include <cmath>
 #include <vector>
+#include <utility>
+#include <type_traits>
+
+
+/** ************************************************************************
+ * Compile time test to determine if the Operation class has a method
+ * of the form apply(const Approximation& in,Approximation& out) that
+ * writes the result of the operator into an existing object.
+ *
+ ************************************************************************ */
+template <class Operation,class Approximation>
+class HasApply
+{
+	template <class Test>
+	static auto check(int) -> decltype(std::declval<Test&>().apply(std::declval<const Approximation&>(),
+																   std::declval<Approximation&>()),
+									   std::true_type());
+	template <class Test>
+	static std::false_type check(...);
+
+public:
+	static const bool value = decltype(check<Operation>(0))::value;
+};
+
+
+/** ************************************************************************
+ * Compile time test to determine if the Preconditioner class has a
+ * method of the form solveInto(const Approximation& in,Approximation& out)
+ * that writes the result of the solve into an existing object.
+ *
+ ************************************************************************ */
+template <class Preconditioner,class Approximation>
+class HasSolveInto
+{
+	template <class Test>
+	static auto check(int) -> decltype(std::declval<Test&>().solveInto(std::declval<const Approximation&>(),
+																	   std::declval<Approximation&>()),
+									   std::true_type());
+	template <class Test>
+	static std::false_type check(...);
+
+public:
+	static const bool value = decltype(check<Preconditioner>(0))::value;
+};
+
+
+/** ************************************************************************
+ * Compile time test to determine if the Monitor class has a method of
+ * the form keepGoing() that decides if the solve should continue.
+ *
+ ************************************************************************ */
+template <class Monitor>
+class HasKeepGoing
+{
+	template <class Test>
+	static auto check(int) -> decltype(bool(std::declval<Test&>().keepGoing()),std::true_type());
+	template <class Test>
+	static std::false_type check(...);
+
+public:
+	static const bool value = decltype(check<Monitor>(0))::value;
+};
+
+
+/** ************************************************************************
+ * Apply the linearization to a vector and put the result in out. The
+ * apply method is used if the Operation class defines it. Otherwise
+ * the multiplication operator is used, and the result is copied.
+ *
+ ************************************************************************ */
+template <class Operation,class Approximation>
+void ApplyOperation(Operation* linearization,Approximation& in,Approximation& out,std::true_type)
+{
+	linearization->apply(in,out);
+}
+
+template <class Operation,class Approximation>
+void ApplyOperation(Operation* linearization,Approximation& in,Approximation& out,std::false_type)
+{
+	out = (*linearization)*in;
+}
+
+template <class Operation,class Approximation>
+void ApplyOperation(Operation* linearization,Approximation& in,Approximation& out)
+{
+	ApplyOperation(linearization,in,out,
+				   std::integral_constant<bool,HasApply<Operation,Approximation>::value>());
+}
+
+
+/** ************************************************************************
+ * Apply the preconditioner to a vector and put the result in out. The
+ * solveInto method is used if the Preconditioner class defines
+ * it. Otherwise the solve method is used, and the result is copied.
+ *
+ ************************************************************************ */
+template <class Preconditioner,class Approximation>
+void ApplyPreconditioner(Preconditioner* precond,Approximation& in,Approximation& out,std::true_type)
+{
+	precond->solveInto(in,out);
+}
+
+template <class Preconditioner,class Approximation>
+void ApplyPreconditioner(Preconditioner* precond,Approximation& in,Approximation& out,std::false_type)
+{
+	out = precond->solve(in);
+}
+
+template <class Preconditioner,class Approximation>
+void ApplyPreconditioner(Preconditioner* precond,Approximation& in,Approximation& out)
+{
+	ApplyPreconditioner(precond,in,out,
+						std::integral_constant<bool,HasSolveInto<Preconditioner,Approximation>::value>());
+}
+
+
+/** ************************************************************************
+ * Ask the monitor if the solve should continue. A monitor without a
+ * keepGoing method always lets it continue, and no work is added.
+ *
+ ************************************************************************ */
+template <class Monitor>
+bool KeepGoing(Monitor& monitor,std::true_type)
+{
+	return(monitor.keepGoing());
+}
+
+template <class Monitor>
+bool KeepGoing(Monitor&,std::false_type)
+{
+	return(true);
+}
+
+template <class Monitor>
+bool KeepGoing(Monitor& monitor)
+{
+	return(KeepGoing(monitor,std::integral_constant<bool,HasKeepGoing<Monitor>::value>()));
+}
+
+
+/** ************************************************************************
+ * Calculate the preconditioned residual, P^{-1}(b - L x), for the
+ * current approximation. The vector work is used as scratch space
+ * and is overwritten. The time is given to the monitor as part of the
+ * apply and precondition phases.
+ *
+ ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner,class Monitor>
+void PreconditionedResidual
+(Operation* linearization, //!< Performs the linearization of the PDE on the approximation.
+ Approximation* solution,  //!< The current approximation to the linear system.
+ Approximation* rhs,       //!< The right hand side of the equation to solve.
+ Preconditioner* precond,  //!< The preconditioner used for the linear system.
+ Approximation& work,      //!< Scratch space for the unpreconditioned residual.
+ Approximation& residual,  //!< The preconditioned residual.
+ Monitor& monitor)         //!< Told when each phase starts and ends.
+{
+	monitor.begin(MONITORAPPLY);
+	ApplyOperation(linearization,*solution,work);
+	work *= -1.0;
+	work += *rhs;
+	monitor.end(MONITORAPPLY);
+
+	monitor.begin(MONITORPRECONDITION);
+	ApplyPreconditioner(precond,work,residual);
+	monitor.end(MONITORPRECONDITION);
+}
 
 /** ************************************************************************
  * Update the current approximation to the solution to the linear
@@ -79,9 +252,9 @@
  ************************************************************************ */
 template <class Approximation, class Double >
 void Update
-(Double **H,         //<! The upper diagonal matrix constructed in the GMRES routine.
- Approximation *x,   //<! The current approximation to the linear system.
- Double *s,          //<! The vector e_1 that has been multiplied by the Givens rotations.
+(Tensor<Double,2> &H, //<! The upper diagonal matrix constructed in the GMRES routine.
+ Approximation *x,    //<! The current approximation to the linear system.
+ Tensor<Double,1> &s, //<! The vector e_1 that has been multiplied by the Givens rotations.
  std::vector<Approximation> *v,  //<! The orthogonal basis vectors for the Krylov subspace.
  int dimension)      //<! The number of vectors in the basis for the Krylov subspace.
 {
@@ -91,19 +264,19 @@ void Update
   int lupe;
   for (lupe = dimension; lupe >= 0; --lupe) 
 	  {
-		  s[lupe] = s[lupe]/H[lupe][lupe];
+		  s(lupe) = s(lupe)/H(lupe,lupe);
 		  for (int innerLupe = lupe - 1; innerLupe >= 0; --innerLupe)
 			  {
 				  // Subtract off the parts from the upper diagonal of the
 				  // matrix.
-				  s[innerLupe] -=  s[lupe]*H[innerLupe][lupe];
+				  s(innerLupe) -=  s(lupe)*H(innerLupe,lupe);
 			  }
 	  }
 
   // Finally update the approximation.
 	typename std::vector<Approximation>::iterator ptr = v->begin();
   for (lupe = 0; lupe <= dimension; lupe++)
-	  *x += (*ptr++) * s[lupe];
+	  x->axpy(&(*ptr++),s(lupe));
 }
 
 
@@ -113,9 +286,22 @@ void Update
  * algorithm given in the book Templates for the Solution of Linear
  * Systems: Building Blocks for Iterative Methods, 2nd Edition.
  *
+ * The monitor is told when each phase of an iteration starts and
+ * ends, the estimate of the residual after every iteration, and when
+ * the routine restarts. A NullMonitor adds no work to the routine.
+ * If the monitor has a keepGoing method it is asked after every
+ * Arnoldi step, and if it returns false the approximation is updated
+ * with the basis found so far and the routine stops.
+ *
+ * The checkpoint is asked for the state of an earlier solve of the
+ * same system before the first residual is found. It is given the
+ * state after the update at every restart and after every Arnoldi
+ * step, and it decides when to keep it. A NullCheckpoint adds no work
+ * to the routine.
+ *
  * @return The number of iterations required. Returns zero if it did not converge.
  ************************************************************************ */
-template<class Operation,class Approximation,class Preconditioner,class Double>
+template<class Operation,class Approximation,class Preconditioner,class Double,class Monitor,class Checkpointer>
 int GMRES
 (Operation* linearization, //!< Performs the linearization of the PDE on the approximation.
  Approximation* solution,  //!< The approximation to the linear system. (and initial estimate!)
@@ -123,162 +309,268 @@ int GMRES
  Preconditioner* precond,  //!< The preconditioner used for the linear system.
  int krylovDimension,      //!< The number of vectors to generate in the Krylov subspace.
  int numberRestarts,       //!< Number of times to repeat the GMRES iterations.
- Double tolerance          //!< How small the residual should be to terminate the GMRES iterations.
+ Double tolerance,         //!< How small the residual should be to terminate the GMRES iterations.
+ Monitor& monitor,         //!< Told about the progress of the routine.
+ Checkpointer& checkpoint  //!< Saves the state of the routine and resumes from it.
  )
 {
+	monitor.start(krylovDimension,numberRestarts);
 
 	// Allocate the space for the givens rotations, and the upper
-	// Hessenburg matrix.
-	Double **H      = ArrayUtils<Double>::twotensor(krylovDimension+1,krylovDimension);
+	// Hessenburg matrix. Every entry is written before it is read, so
+	// they are not initialized.
+	Tensor<Double,2> H(TensorUninitialized(),krylovDimension+1,krylovDimension);
 
 	// The Givens rotations include the sine and cosine term. The
 	// cosine term is in column zero, and the sine term is in column
 	// one.
-	Double **givens = ArrayUtils<Double>::twotensor(krylovDimension+1,2);
+	Tensor<Double,2> givens(TensorUninitialized(),krylovDimension+1,2);
 
 	// The vector s the right hand side for the system that the matrix
 	// H satisfies in order to minimize the residual over the Krylov
-	// subspace.
-	Double *s = ArrayUtils<Double>::onetensor(krylovDimension+1);
+	// subspace. It is set at the start of every restart.
+	Tensor<Double,1> s(TensorUninitialized(),krylovDimension+1);
 
 	// Determine the residual and allocate the space for the Krylov
-	// subspace.
+	// subspace. The vector work holds the result of the operator
+	// before the preconditioner is applied.
 	std::vector<Approximation> V(krylovDimension+1,
 								 Approximation(solution->getN()));
-	Approximation residual = precond->solve((*rhs)-(*linearization)*(*solution));
-	Double rho             = residual.norm();
+	Approximation work(solution->getN());
+	Approximation residual(solution->getN());
+	Double rho;
 	Double normRHS         = rhs->norm();
 
 	// variable for keeping track of how many restarts had to be used.
 	int totalRestarts = 0;
 
+	// If the checkpoint has the state of an earlier solve, continue
+	// from it. A solve that stopped within a cycle continues with the
+	// next Arnoldi step, and otherwise the residual is found again.
+	GMRESPosition position;
+	int start = 0;
+	if(checkpoint.resume(*rhs,*solution,V,H,givens,s,position))
+		{
+			totalRestarts  = position.restarts;
+			numberRestarts = position.remaining;
+			start          = position.step;
+			rho            = position.rho;
+		}
+	if(start==0)
+		{
+			PreconditionedResidual(linearization,solution,rhs,precond,work,residual,monitor);
+			rho = residual.norm();
+		}
+
 	if(normRHS < 1.0E-5)
 		normRHS = 1.0;
+	monitor.residual(start+totalRestarts*krylovDimension,rho/normRHS);
 
 	// Go through the requisite number of restarts.
 	int iteration = 1;
 	while( (--numberRestarts >= 0) && (rho > tolerance*normRHS))
 		{
 
-			// The first vector in the Krylov subspace is the normalized
-			// residual.
-			V[0] = residual * (1.0/rho);
-
-			// Need to zero out the s vector in case of restarts
-			// initialize the s vector used to estimate the residual.
-			for(int lupe=0;lupe<=krylovDimension;++lupe)
-				s[lupe] = 0.0;
-			s[0] = rho;
+			if(start==0)
+				{
+					// The first vector in the Krylov subspace is the normalized
+					// residual.
+					V[0]  = residual;
+					V[0] *= (1.0/rho);
+
+					// Need to zero out the s vector in case of restarts
+					// initialize the s vector used to estimate the residual.
+					for(int lupe=0;lupe<=krylovDimension;++lupe)
+						s(lupe) = 0.0;
+					s(0) = rho;
+				}
 
 			// Go through and generate the pre-determined number of vectors
 			// for the Krylov subspace.
-			for( iteration=0;iteration<krylovDimension;++iteration)
+			for( iteration=start;iteration<krylovDimension;++iteration)
 				{
 					// Get the next entry in the vectors that form the basis for
 					// the Krylov subspace.
-					V[iteration+1] = precond->solve((*linearization)*V[iteration]);
+					monitor.begin(MONITORARNOLDI);
+					monitor.begin(MONITORAPPLY);
+					ApplyOperation(linearization,V[iteration],work);
+					monitor.end(MONITORAPPLY);
+					monitor.begin(MONITORPRECONDITION);
+					ApplyPreconditioner(precond,work,V[iteration+1]);
+					monitor.end(MONITORPRECONDITION);
 
 					// Perform the modified Gram-Schmidt method to orthogonalize
 					// the new vector.
+					monitor.begin(MONITORORTHOGONALIZE);
 					int row;
 					typename std::vector<Approximation>::iterator ptr = V.begin();
 					for(row=0;row<=iteration;++row)
 						{
-							H[row][iteration] = Approximation::dot(V[iteration+1], *ptr);
-							//subtract H[row][iteration]*V[row] from the current vector
-							V[iteration+1].axpy(&(*ptr++),-H[row][iteration]);
+							H(row,iteration) = Approximation::dot(V[iteration+1], *ptr);
+							//subtract H(row,iteration)*V[row] from the current vector
+							V[iteration+1].axpy(&(*ptr++),-H(row,iteration));
 						}
 
-					H[iteration+1][iteration] = V[iteration+1].norm();
-					V[iteration+1] *= (1.0/H[iteration+1][iteration]);
+					H(iteration+1,iteration) = V[iteration+1].norm();
+					V[iteration+1] *= (1.0/H(iteration+1,iteration));
+					monitor.end(MONITORORTHOGONALIZE);
 
 					// Apply the Givens Rotations to insure that H is
 					// an upper diagonal matrix. First apply previous
 					// rotations to the current matrix.
+					monitor.begin(MONITORLEASTSQUARES);
 					double tmp;
 					for (row = 0; row < iteration; row++)
 						{
-							tmp = givens[row][0]*H[row][iteration] +
-								givens[row][1]*H[row+1][iteration];
-							H[row+1][iteration] = -givens[row][1]*H[row][iteration] 
-								+ givens[row][0]*H[row+1][iteration];
-							H[row][iteration]  = tmp;
+							tmp = givens(row,0)*H(row,iteration) +
+								givens(row,1)*H(row+1,iteration);
+							H(row+1,iteration) = -givens(row,1)*H(row,iteration) 
+								+ givens(row,0)*H(row+1,iteration);
+							H(row,iteration)  = tmp;
 						}
 
 					// Figure out the next Givens rotation.
-					if(H[iteration+1][iteration] == 0.0)
+					if(H(iteration+1,iteration) == 0.0)
 						{
 							// It is already lower diagonal. Just leave it be....
-							givens[iteration][0] = 1.0;
-							givens[iteration][1] = 0.0;
+							givens(iteration,0) = 1.0;
+							givens(iteration,1) = 0.0;
 						}
-					else if (fabs(H[iteration+1][iteration]) > fabs(H[iteration][iteration]))
+					else if (fabs(H(iteration+1,iteration)) > fabs(H(iteration,iteration)))
 						{
 							// The off diagonal entry has a larger
 							// magnitude. Use the ratio of the
 							// diagonal entry over the off diagonal.
-							tmp = H[iteration][iteration]/H[iteration+1][iteration];
-							givens[iteration][1] = 1.0/sqrt(1.0+tmp*tmp);
-							givens[iteration][0] = tmp*givens[iteration][1];
+							tmp = H(iteration,iteration)/H(iteration+1,iteration);
+							givens(iteration,1) = 1.0/sqrt(1.0+tmp*tmp);
+							givens(iteration,0) = tmp*givens(iteration,1);
 						}
 					else
 						{
 							// The off diagonal entry has a smaller
 							// magnitude. Use the ratio of the off
 							// diagonal entry to the diagonal entry.
-							tmp = H[iteration+1][iteration]/H[iteration][iteration];
-							givens[iteration][0] = 1.0/sqrt(1.0+tmp*tmp);
-							givens[iteration][1] = tmp*givens[iteration][0];
+							tmp = H(iteration+1,iteration)/H(iteration,iteration);
+							givens(iteration,0) = 1.0/sqrt(1.0+tmp*tmp);
+							givens(iteration,1) = tmp*givens(iteration,0);
 						}
 
 					// Apply the new Givens rotation on the
 					// new entry in the uppper Hessenberg matrix.
-					tmp = givens[iteration][0]*H[iteration][iteration] + 
-						givens[iteration][1]*H[iteration+1][iteration];
-					H[iteration+1][iteration] = -givens[iteration][1]*H[iteration][iteration] + 
-						givens[iteration][0]*H[iteration+1][iteration];
-					H[iteration][iteration] = tmp;
+					tmp = givens(iteration,0)*H(iteration,iteration) + 
+						givens(iteration,1)*H(iteration+1,iteration);
+					H(iteration+1,iteration) = -givens(iteration,1)*H(iteration,iteration) + 
+						givens(iteration,0)*H(iteration+1,iteration);
+					H(iteration,iteration) = tmp;
 
 					// Finally apply the new Givens rotation on the s
 					// vector
-					tmp = givens[iteration][0]*s[iteration] + givens[iteration][1]*s[iteration+1];
-					s[iteration+1] = -givens[iteration][1]*s[iteration] + givens[iteration][1]*s[iteration+1];
-					s[iteration] = tmp;
-
-					rho = fabs(s[iteration+1]);
+					tmp = givens(iteration,0)*s(iteration) + givens(iteration,1)*s(iteration+1);
+					s(iteration+1) = -givens(iteration,1)*s(iteration) + givens(iteration,1)*s(iteration+1);
+					s(iteration) = tmp;
+
+					rho = fabs(s(iteration+1));
+					monitor.end(MONITORLEASTSQUARES);
+					monitor.end(MONITORARNOLDI);
+					monitor.residual(iteration+1+totalRestarts*krylovDimension,rho/normRHS);
 					if(rho < tolerance*normRHS)
 						{
 							// We are close enough! Update the approximation.
+							monitor.begin(MONITORUPDATE);
 							Update(H,solution,s,&V,iteration);
-							ArrayUtils<double>::deltwotensor(givens);
-							ArrayUtils<double>::deltwotensor(H);
-							ArrayUtils<double>::delonetensor(s);
+							monitor.end(MONITORUPDATE);
 							//delete [] V;
 							//tolerance = rho/normRHS;
+							monitor.finish(iteration+1+totalRestarts*krylovDimension,rho/normRHS,true);
 							return(iteration+totalRestarts*krylovDimension);
 						}
 
+					checkpoint.save(*solution,V,H,givens,s,
+													GMRESPosition(iteration+1,totalRestarts,numberRestarts+1,rho));
+
+					if(!KeepGoing(monitor))
+						{
+							// The solve was stopped. Keep the best
+							// approximation found so far.
+							monitor.begin(MONITORUPDATE);
+							Update(H,solution,s,&V,iteration);
+							monitor.end(MONITORUPDATE);
+							monitor.finish(iteration+1+totalRestarts*krylovDimension,rho/normRHS,false);
+							return(0);
+						}
+
 				} // for(iteration)
 
 			// We have exceeded the number of iterations. Update the
 			// approximation and start over.
+			start = 0;
 			totalRestarts += 1;
+			monitor.restart();
+			monitor.begin(MONITORRESTART);
+			monitor.begin(MONITORUPDATE);
 			Update(H,solution,s,&V,iteration-1);
-			residual = precond->solve((*linearization)*(*solution) - (*rhs));
+			monitor.end(MONITORUPDATE);
+			checkpoint.save(*solution,V,H,givens,s,GMRESPosition(0,totalRestarts,numberRestarts,0.0));
+			PreconditionedResidual(linearization,solution,rhs,precond,work,residual,monitor);
 			rho = residual.norm();
+			monitor.end(MONITORRESTART);
 
 		} // while(numberRestarts,rho)
 
 
-	ArrayUtils<double>::deltwotensor(givens);
-	ArrayUtils<double>::deltwotensor(H);
-	ArrayUtils<double>::delonetensor(s);
 	//delete [] V;
 	//tolerance = rho/normRHS;
 
+	monitor.finish(totalRestarts*krylovDimension,rho/normRHS,rho < tolerance*normRHS);
 	if(rho < tolerance*normRHS)
 		return(iteration+totalRestarts*krylovDimension);
 
 	return(0);
 }
 
+
+/** ************************************************************************
+ * Implementation of the restarted GMRES algorithm with a monitor and
+ * without a checkpoint.
+ *
+ * @return The number of iterations required. Returns zero if it did not converge.
+ ************************************************************************ */
+template<class Operation,class Approximation,class Preconditioner,class Double,class Monitor>
+int GMRES
+(Operation* linearization, //!< Performs the linearization of the PDE on the approximation.
+ Approximation* solution,  //!< The approximation to the linear system. (and initial estimate!)
+ Approximation* rhs,       //!< the right hand side of the equation to solve.
+ Preconditioner* precond,  //!< The preconditioner used for the linear system.
+ int krylovDimension,      //!< The number of vectors to generate in the Krylov subspace.
+ int numberRestarts,       //!< Number of times to repeat the GMRES iterations.
+ Double tolerance,         //!< How small the residual should be to terminate the GMRES iterations.
+ Monitor& monitor          //!< Told about the progress of the routine.
+ )
+{
+	NullCheckpoint checkpoint;
+	return(GMRES(linearization,solution,rhs,precond,krylovDimension,numberRestarts,tolerance,monitor,checkpoint));
+}
+
+
+/** ************************************************************************
+ * Implementation of the restarted GMRES algorithm without a monitor.
+ *
+ * @return The number of iterations required. Returns zero if it did not converge.
+ ************************************************************************ */
+template<class Operation,class Approximation,class Preconditioner,class Double>
+int GMRES
+(Operation* linearization, //!< Performs the linearization of the PDE on the approximation.
+ Approximation* solution,  //!< The approximation to the linear system. (and initial estimate!)
+ Approximation* rhs,       //!< the right hand side of the equation to solve.
+ Preconditioner* precond,  //!< The preconditioner used for the linear system.
+ int krylovDimension,      //!< The number of vectors to generate in the Krylov subspace.
+ int numberRestarts,       //!< Number of times to repeat the GMRES iterations.
+ Double tolerance          //!< How small the residual should be to terminate the GMRES iterations.
+ )
+{
+	NullMonitor monitor;
+	return(GMRES(linearization,solution,rhs,precond,krylovDimension,numberRestarts,tolerance,monitor));
+}
+
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef ASYNCSOLVEROUTINEDEFINITIONS
+#define ASYNCSOLVEROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file asyncSolve.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Routines to run a GMRES solve on another thread and to stop it early.
+ *
+ * This is the code file for the SolveControl and ControlMonitor
+ * classes and the GMRESAsync routine. The methods that are not
+ * templates are declared inline since the file is included by the
+ * header.
+ *
+ *
+ * @brief Code file for solving a system on another thread.
+ *
+ * ********************************************************************************* */
+
+
+#include <limits>
+#include "asyncSolve.h"
+#include "GMRES.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the SolveControl class.
+ *
+ * The solve is not cancelled and has no deadline.
+ * ************************************************************************ */
+inline SolveControl::SolveControl()
+	: cancelled(false), deadline(std::numeric_limits<std::chrono::steady_clock::rep>::max())
+{
+}
+
+
+/** ************************************************************************
+ * Ask the solve to stop. It stops after the Arnoldi step it is working
+ * on, or before it starts if it is still queued.
+ *
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveControl::cancel()
+{
+	cancelled.store(true);
+}
+
+
+/** ************************************************************************
+ * Give the solve a time after which it should stop.
+ *
+ * @param when The time on the steady clock.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveControl::setDeadline(std::chrono::steady_clock::time_point when)
+{
+	deadline.store(when.time_since_epoch().count());
+}
+
+
+/** ************************************************************************
+ * Give the solve a number of seconds from now after which it should stop.
+ *
+ * @param seconds The time allowed for the solve.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveControl::setTimeout(double seconds)
+{
+	setDeadline(std::chrono::steady_clock::now()+
+							std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+
+/** ************************************************************************
+ * Determine if the solve was cancelled.
+ *
+ * @return True if cancel was called.
+ * ************************************************************************ */
+inline bool SolveControl::isCancelled() const
+{
+	return(cancelled.load());
+}
+
+
+/** ************************************************************************
+ * Determine if the deadline has passed. The clock is not read if there
+ * is no deadline.
+ *
+ * @return True if the deadline has passed.
+ * ************************************************************************ */
+inline bool SolveControl::isExpired() const
+{
+	std::chrono::steady_clock::rep when = deadline.load();
+	if(when == std::numeric_limits<std::chrono::steady_clock::rep>::max())
+		return(false);
+	return(std::chrono::steady_clock::now().time_since_epoch().count() >= when);
+}
+
+
+/** ************************************************************************
+ * Constructor for the ControlMonitor class.
+ *
+ * @param control The control shared with the caller. If it is NULL the
+ *        solve is never stopped.
+ * ************************************************************************ */
+inline ControlMonitor::ControlMonitor(const SolveControl *control) : ReportMonitor(), stopped(false)
+{
+	this->control = control;
+}
+
+
+/** ************************************************************************
+ * The queue used by GMRESAsync when no queue is given.
+ *
+ * It has one worker for every processor and is made the first time it
+ * is needed. The tasks that are still queued are finished when the
+ * program ends.
+ *
+ * @return The queue.
+ * ************************************************************************ */
+inline SolveQueue &AsyncQueue()
+{
+	static SolveQueue queue;
+	return(queue);
+}
+
+
+/** ************************************************************************
+ * Submit a GMRES solve to a queue and return at once.
+ *
+ * The worker makes its own copy of the operator and the
+ * preconditioner for the solve, and they must not be deleted until
+ * the future is ready. The copies are not kept after the solve since
+ * the shared queue lives until the program ends. The initial
+ * approximation and the right hand side are copied when the solve is
+ * submitted, and the solve is built in a node of the queue.
+ *
+ * @param queue The queue that runs the solve.
+ * @param linearization The operator for the system.
+ * @param initial The initial approximation.
+ * @param rhs The right hand side of the system.
+ * @param precond The preconditioner for the system.
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * @param numberRestarts Number of times to repeat the GMRES iterations.
+ * @param tolerance How small the relative residual should be.
+ * @param control Used to cancel the solve or give it a deadline. It may be empty.
+ * @return The future for the approximation, iterations, and report.
+ * ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner>
+std::future<SolveResult<Approximation> > GMRESAsync
+(SolveQueue &queue,const Operation* linearization,const Approximation &initial,const Approximation &rhs,
+ const Preconditioner* precond,int krylovDimension,int numberRestarts,double tolerance,
+ std::shared_ptr<SolveControl> control)
+{
+	return(queue.emplace<SolveResult<Approximation>,AsyncSolve<Operation,Approximation,Preconditioner> >
+				 (linearization,initial,rhs,precond,krylovDimension,numberRestarts,tolerance,control));
+}
+
+
+/** ************************************************************************
+ * Do a solve given to the GMRESAsync routine. It is run by a worker.
+ *
+ * @return The approximation, iterations, and report.
+ * ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner>
+SolveResult<Approximation> AsyncSolve<Operation,Approximation,Preconditioner>::operator()()
+{
+	SolveResult<Approximation> result(x);
+	if(control && !control->keepGoing())
+		{
+			// Stopped before it started.
+			result.stopped = true;
+			return(result);
+		}
+
+	Operation elliptical(*linearization);
+	Preconditioner pre(*precond);
+	ControlMonitor monitor(control.get());
+	result.iterations = GMRES(&elliptical,&result.solution,&b,&pre,
+														krylovDimension,numberRestarts,tolerance,monitor);
+	result.report  = monitor.getReport();
+	result.stopped = monitor.wasStopped();
+	return(result);
+}
+
+
+/** ************************************************************************
+ * Submit a GMRES solve to the shared queue and return at once.
+ *
+ * @param linearization The operator for the system.
+ * @param initial The initial approximation.
+ * @param rhs The right hand side of the system.
+ * @param precond The preconditioner for the system.
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * @param numberRestarts Number of times to repeat the GMRES iterations.
+ * @param tolerance How small the relative residual should be.
+ * @param control Used to cancel the solve or give it a deadline. It may be empty.
+ * @return The future for the approximation, iterations, and report.
+ * ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner>
+std::future<SolveResult<Approximation> > GMRESAsync
+(const Operation* linearization,const Approximation &initial,const Approximation &rhs,
+ const Preconditioner* precond,int krylovDimension,int numberRestarts,double tolerance,
+ std::shared_ptr<SolveControl> control)
+{
+	return(GMRESAsync(AsyncQueue(),linearization,initial,rhs,precond,
+										krylovDimension,numberRestarts,tolerance,control));
+}
+
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef ASYNCSOLVEROUTINE
+#define ASYNCSOLVEROUTINE
+
+
+/** *********************************************************************************
+ * @file asyncSolve.h
+ * @class SolveControl
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Routines to run a GMRES solve on another thread and to stop it early.
+ *
+ * This is the definition (header) file for the SolveControl and
+ * ControlMonitor classes and the GMRESAsync routine. GMRESAsync
+ * submits a solve to a SolveQueue and returns at once with a
+ * std::future that holds the approximation, the number of iterations,
+ * and the SolveReport. If no queue is given a queue with one worker
+ * for every processor is made the first time it is needed.
+ *
+ * A SolveControl is shared by the caller and the solve. The caller
+ * can cancel the solve or give it a deadline. The ControlMonitor
+ * keeps a SolveReport like the ReportMonitor, and its keepGoing
+ * method tells the GMRES routine to stop once the solve is cancelled
+ * or the deadline has passed. The check is made after every Arnoldi
+ * step, and a solve that is stopped keeps the best approximation found
+ * so far. A solve that is cancelled before it starts returns the
+ * initial approximation.
+ *
+ *
+ * @brief Header file for solving a system on another thread.
+ *
+ * ********************************************************************************* */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include "monitor.h"
+#include "solveQueue.h"
+
+class SolveControl
+{
+
+public:
+	SolveControl();                                       //< Default constructor for the class
+
+	void cancel();                                        //< Ask the solve to stop.
+	void setDeadline(std::chrono::steady_clock::time_point when); //< Stop the solve at a given time.
+	void setTimeout(double seconds);                      //< Stop the solve after a number of seconds from now.
+	bool isCancelled() const;                             //< True if cancel was called.
+	bool isExpired() const;                               //< True if the deadline has passed.
+
+	/**
+		 Method to decide if a solve should continue.
+
+		 @return True if it has not been cancelled and the deadline has not passed.
+	*/
+	bool keepGoing() const
+	{
+		return(!isCancelled() && !isExpired());
+	}
+
+private:
+
+	std::atomic<bool> cancelled;                          //< Flag set when the solve is cancelled.
+	std::atomic<std::chrono::steady_clock::rep> deadline; //< The deadline in ticks of the steady clock.
+
+	SolveControl(const SolveControl& oldCopy);            //< A control cannot be copied.
+
+};
+
+
+class ControlMonitor : public ReportMonitor
+{
+
+public:
+	ControlMonitor(const SolveControl *control);          //< Constructor for a monitor that uses a control
+
+	/**
+		 Method called by the GMRES routine after every Arnoldi step. The
+		 first time it tells the solve to stop it records that the solve
+		 was stopped by the control.
+
+		 @return True if the solve should continue.
+	*/
+	bool keepGoing() const
+	{
+		if((control==0) || control->keepGoing())
+			return(true);
+		stopped = true;
+		return(false);
+	}
+
+	/**
+		 Method to determine if the solve was stopped by the control.
+
+		 @return True if keepGoing told the solve to stop.
+	*/
+	bool wasStopped() const
+	{
+		return(stopped);
+	}
+
+private:
+
+	const SolveControl *control;                          //< The control shared with the caller, or NULL.
+	mutable bool stopped;                                 //< Flag set when keepGoing tells the solve to stop.
+
+};
+
+
+/**
+	 The function run by a worker for the GMRESAsync routine. The initial
+	 approximation and the right hand side are copied when it is built.
+*/
+template <class Operation,class Approximation,class Preconditioner>
+struct AsyncSolve
+{
+	AsyncSolve(const Operation* linearization,const Approximation &initial,const Approximation &rhs,
+						 const Preconditioner* precond,int krylovDimension,int numberRestarts,double tolerance,
+						 const std::shared_ptr<SolveControl> &control)
+		: linearization(linearization), x(initial), b(rhs), precond(precond),
+			krylovDimension(krylovDimension), numberRestarts(numberRestarts), tolerance(tolerance),
+			control(control) {}
+
+	SolveResult<Approximation> operator()();            //< Do the solve on the calling worker.
+
+	const Operation *linearization;       //< The operator given to GMRESAsync.
+	Approximation x;                      //< The initial approximation.
+	Approximation b;                      //< The right hand side of the system.
+	const Preconditioner *precond;        //< The preconditioner given to GMRESAsync.
+	int krylovDimension;                  //< The number of vectors in the Krylov subspace.
+	int numberRestarts;                   //< Number of times to repeat the GMRES iterations.
+	double tolerance;                     //< How small the relative residual should be.
+	std::shared_ptr<SolveControl> control; //< The control shared with the caller. It may be empty.
+};
+
+
+SolveQueue &AsyncQueue();                               //< The queue used when no queue is given.
+
+template <class Operation,class Approximation,class Preconditioner>
+std::future<SolveResult<Approximation> > GMRESAsync
+(SolveQueue &queue,const Operation* linearization,const Approximation &initial,const Approximation &rhs,
+ const Preconditioner* precond,int krylovDimension,int numberRestarts,double tolerance,
+ std::shared_ptr<SolveControl> control=std::shared_ptr<SolveControl>());
+
+template <class Operation,class Approximation,class Preconditioner>
+std::future<SolveResult<Approximation> > GMRESAsync
+(const Operation* linearization,const Approximation &initial,const Approximation &rhs,
+ const Preconditioner* precond,int krylovDimension,int numberRestarts,double tolerance,
+ std::shared_ptr<SolveControl> control=std::shared_ptr<SolveControl>());
+
+
+#include "asyncSolve.cpp"
+
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef BATCHEDGMRESROUTINEDEFINITIONS
+#define BATCHEDGMRESROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file batchedGMRES.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to solve a group of independent linear systems together using
+ * the restarted GMRES algorithm.
+ *
+ * This is the code file for the BatchedGMRES class. The steps are the
+ * same as the GMRES routine, and they are done in the same order for
+ * each system. The loops over the systems are the inner loops, and
+ * the choices that differ between the systems are made with the
+ * conditional operator so that the loops can be vectorized.
+ *
+ *
+ * @brief Code file for solving a group of systems with GMRES.
+ *
+ * ********************************************************************************* */
+
+
+#include <cmath>
+#include "batchedGMRES.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the BatchedGMRES class.
+ *
+ * Allocates the space for the Krylov subspace and the least squares
+ * problem of every system. The space is used again for every solve.
+ *
+ * @param size The number of entries in each system.
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * ************************************************************************ */
+template <class number,int width>
+BatchedGMRES<number,width>::BatchedGMRES(int size,int krylovDimension)
+{
+	N      = size;
+	krylov = krylovDimension;
+
+	V      = Tensor<number,2>(krylov+1,N*width);
+	work   = Tensor<number,2>(1,N*width);
+	r      = Tensor<number,2>(1,N*width);
+	H      = Tensor<number,3>(krylov+1,krylov,width);
+	givens = Tensor<number,3>(krylov+1,2,width);
+	s      = Tensor<number,2>(krylov+1,width);
+
+	int lane;
+	for(lane=0;lane<width;++lane)
+		{
+			rho[lane]        = 0.0;
+			normRHS[lane]    = 1.0;
+			active[lane]     = 0.0;
+			iterations[lane] = 0;
+		}
+}
+
+
+/** ************************************************************************
+ * Solve a group of width systems.
+ *
+ * The approximations and the right hand sides are interleaved, and
+ * the approximations are used as the initial estimates. Every system
+ * uses the same test for convergence as the GMRES routine, and the
+ * number of iterations for each one can be found with getIterations
+ * afterwards.
+ *
+ * @param linearization The operator for the systems.
+ * @param solution The interleaved approximations.
+ * @param rhs The interleaved right hand sides.
+ * @param precond The preconditioner for the systems.
+ * @param numberRestarts Number of times to repeat the GMRES iterations.
+ * @param tolerance How small the relative residual should be.
+ * @return The number of systems that converged.
+ * ************************************************************************ */
+template <class number,int width>
+template <class Operation,class Preconditioner>
+int BatchedGMRES<number,width>::solve(Operation* linearization,number *solution,const number *rhs,
+																			Preconditioner* precond,int numberRestarts,number tolerance)
+{
+	int lane;
+	int lupe;
+	int last[width];              // The last column of H used to update each system.
+	int remaining = 0;            // The number of systems that have not converged.
+	int totalRestarts = 0;
+
+	// Find the norm of every right hand side.
+	for(lane=0;lane<width;++lane)
+		{
+			normRHS[lane] = 0.0;
+			active[lane]  = 1.0;
+		}
+	for(lupe=0;lupe<N;++lupe)
+		{
+			const number *row = rhs + lupe*width;
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				normRHS[lane] += row[lane]*row[lane];
+		}
+
+	residual(linearization,solution,rhs,precond);
+	for(lane=0;lane<width;++lane)
+		{
+			normRHS[lane]    = sqrt(normRHS[lane]);
+			if(normRHS[lane] < 1.0E-5)
+				normRHS[lane] = 1.0;
+			active[lane]     = (rho[lane] > tolerance*normRHS[lane]) ? 1.0 : 0.0;
+			iterations[lane] = (active[lane] > 0.0) ? 0 : 1;
+			remaining       += (active[lane] > 0.0) ? 1 : 0;
+		}
+
+	while((--numberRestarts >= 0) && (remaining > 0))
+		{
+			// The first vector in the Krylov subspace is the normalized
+			// residual. A system that has converged starts with zero.
+			number *first = V.slice(0);
+			number scale[width];
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				{
+					scale[lane] = (active[lane] > 0.0) ? 1.0/rho[lane] : 0.0;
+					s(0,lane)   = (active[lane] > 0.0) ? rho[lane] : 0.0;
+					last[lane]  = -1;
+				}
+			for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+				for(lane=0;lane<width;++lane)
+					first[lupe*width+lane] = r(0,lupe*width+lane)*scale[lane];
+			for(lupe=1;lupe<=krylov;++lupe)
+				for(lane=0;lane<width;++lane)
+					s(lupe,lane) = 0.0;
+
+			int step;
+			for(step=0;(step<krylov)&&(remaining>0);++step)
+				{
+					// Get the next vector for every system and find the
+					// next column of each Hessenberg matrix.
+					linearization->applyBatch(V.slice(step),work.data(),width);
+					precond->solveBatch(work.data(),V.slice(step+1),width);
+					orthogonalize(step);
+					rotate(step);
+
+					// Check every system that is still going.
+					for(lane=0;lane<width;++lane)
+						if(active[lane] > 0.0)
+							{
+								rho[lane]  = fabs(s(step+1,lane));
+								last[lane] = step;
+								if(rho[lane] < tolerance*normRHS[lane])
+									{
+										active[lane]     = 0.0;
+										iterations[lane] = step+totalRestarts*krylov;
+										remaining       -= 1;
+									}
+							}
+				}
+
+			// Update every system with the columns found before it
+			// converged, and find the residual again for the systems
+			// that are still going.
+			update(solution,last);
+			if(remaining == 0)
+				break;
+
+			totalRestarts += 1;
+			residual(linearization,solution,rhs,precond);
+			for(lane=0;lane<width;++lane)
+				if((active[lane] > 0.0) && (rho[lane] < tolerance*normRHS[lane]))
+					{
+						active[lane]     = 0.0;
+						iterations[lane] = krylov+totalRestarts*krylov;
+						remaining       -= 1;
+					}
+		}
+
+	return(width-remaining);
+}
+
+
+/** ************************************************************************
+ * Find the preconditioned residual of every system and its norm.
+ *
+ * The norm is only kept for the systems that have not converged. The
+ * residual of the other systems does not change.
+ *
+ * @param linearization The operator for the systems.
+ * @param solution The interleaved approximations.
+ * @param rhs The interleaved right hand sides.
+ * @param precond The preconditioner for the systems.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+template <class Operation,class Preconditioner>
+void BatchedGMRES<number,width>::residual(Operation* linearization,const number *solution,const number *rhs,
+																					Preconditioner* precond)
+{
+	number *w = work.data();
+	number norm[width];
+	int lupe;
+	int lane;
+
+	linearization->applyBatch(solution,w,width);
+	for(lupe=0;lupe<N*width;++lupe)
+		w[lupe] = rhs[lupe] - w[lupe];
+	precond->solveBatch(w,r.data(),width);
+
+	const number *row = r.data();
+	for(lane=0;lane<width;++lane)
+		norm[lane] = 0.0;
+	for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+		for(lane=0;lane<width;++lane)
+			norm[lane] += row[lupe*width+lane]*row[lupe*width+lane];
+
+	for(lane=0;lane<width;++lane)
+		if(active[lane] > 0.0)
+			rho[lane] = sqrt(norm[lane]);
+}
+
+
+/** ************************************************************************
+ * Orthogonalize the newest basis vector of every system against the
+ * earlier ones using the modified Gram-Schmidt method.
+ *
+ * The new vector of a system that has converged is set to zero.
+ *
+ * @param step The column of the Hessenberg matrices to define.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedGMRES<number,width>::orthogonalize(int step)
+{
+	number *next = V.slice(step+1);
+	number dot[width];
+	int row;
+	int lupe;
+	int lane;
+
+	for(row=0;row<=step;++row)
+		{
+			const number *previous = V.slice(row);
+			for(lane=0;lane<width;++lane)
+				dot[lane] = 0.0;
+			for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+				for(lane=0;lane<width;++lane)
+					dot[lane] += next[lupe*width+lane]*previous[lupe*width+lane];
+
+			for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+				for(lane=0;lane<width;++lane)
+					next[lupe*width+lane] += -dot[lane]*previous[lupe*width+lane];
+
+			number *h = &H(row,step,0);
+			for(lane=0;lane<width;++lane)
+				h[lane] = dot[lane];
+		}
+
+	for(lane=0;lane<width;++lane)
+		dot[lane] = 0.0;
+	for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+		for(lane=0;lane<width;++lane)
+			dot[lane] += next[lupe*width+lane]*next[lupe*width+lane];
+
+	number *h = &H(step+1,step,0);
+	number scale[width];
+#pragma omp simd
+	for(lane=0;lane<width;++lane)
+		{
+			h[lane]     = sqrt(dot[lane]);
+			scale[lane] = ((active[lane] > 0.0) && (h[lane] > 0.0)) ? 1.0/h[lane] : 0.0;
+		}
+	for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+		for(lane=0;lane<width;++lane)
+			next[lupe*width+lane] *= scale[lane];
+}
+
+
+/** ************************************************************************
+ * Apply the earlier Givens rotations to the new column of every
+ * Hessenberg matrix, find the new rotation, and apply it to the
+ * column and the rotated right hand side.
+ *
+ * The rotation is found in the same way as the GMRES routine, using
+ * the ratio of the smaller entry to the larger one. If both entries
+ * are zero the rotation is the identity.
+ *
+ * @param step The column of the Hessenberg matrices.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedGMRES<number,width>::rotate(int step)
+{
+	int row;
+	int lane;
+
+	for(row=0;row<step;++row)
+		{
+			number *upper = &H(row,step,0);
+			number *lower = &H(row+1,step,0);
+			const number *c = &givens(row,0,0);
+			const number *sn = &givens(row,1,0);
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				{
+					number tmp  = c[lane]*upper[lane] + sn[lane]*lower[lane];
+					lower[lane] = -sn[lane]*upper[lane] + c[lane]*lower[lane];
+					upper[lane] = tmp;
+				}
+		}
+
+	number *diagonal = &H(step,step,0);
+	number *below    = &H(step+1,step,0);
+	number *c        = &givens(step,0,0);
+	number *sn       = &givens(step,1,0);
+	number *current  = &s(step,0);
+	number *next     = &s(step+1,0);
+#pragma omp simd
+	for(lane=0;lane<width;++lane)
+		{
+			bool larger = fabs(below[lane]) > fabs(diagonal[lane]);
+			number top    = larger ? diagonal[lane] : below[lane];
+			number bottom = larger ? below[lane] : diagonal[lane];
+			number ratio  = top/((bottom == 0.0) ? 1.0 : bottom);
+			number factor = 1.0/sqrt(1.0+ratio*ratio);
+			c[lane]  = larger ? ratio*factor : factor;
+			sn[lane] = larger ? factor : ratio*factor;
+
+			number tmp     = c[lane]*diagonal[lane] + sn[lane]*below[lane];
+			below[lane]    = -sn[lane]*diagonal[lane] + c[lane]*below[lane];
+			diagonal[lane] = tmp;
+
+			tmp           = c[lane]*current[lane] + sn[lane]*next[lane];
+			next[lane]    = -sn[lane]*current[lane] + c[lane]*next[lane];
+			current[lane] = tmp;
+		}
+}
+
+
+/** ************************************************************************
+ * Update the approximation of every system.
+ *
+ * Solves the upper triangular system for the coefficients of each
+ * system in place, and adds the combination of the basis vectors to
+ * the approximation. The columns after the last one of a system are
+ * given a coefficient of zero, and a system with a last column of -1
+ * is not changed.
+ *
+ * @param solution The interleaved approximations.
+ * @param last The last column of H to use for each system.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedGMRES<number,width>::update(number *solution,const int *last)
+{
+	int row;
+	int inner;
+	int lupe;
+	int lane;
+	int top = -1;
+	for(lane=0;lane<width;++lane)
+		top = (last[lane] > top) ? last[lane] : top;
+
+	for(row=top;row>=0;--row)
+		{
+			number *coefficient = &s(row,0);
+			const number *diagonal = &H(row,row,0);
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				coefficient[lane] = (row <= last[lane]) ? coefficient[lane]/diagonal[lane] : 0.0;
+
+			for(inner=row-1;inner>=0;--inner)
+				{
+					number *value = &s(inner,0);
+					const number *h = &H(inner,row,0);
+#pragma omp simd
+					for(lane=0;lane<width;++lane)
+						value[lane] -= coefficient[lane]*h[lane];
+				}
+		}
+
+	for(row=0;row<=top;++row)
+		{
+			const number *basis = V.slice(row);
+			const number *coefficient = &s(row,0);
+			for(lupe=0;lupe<N;++lupe)
+#pragma omp simd
+				for(lane=0;lane<width;++lane)
+					solution[lupe*width+lane] += coefficient[lane]*basis[lupe*width+lane];
+		}
+}
+
+
+#endif
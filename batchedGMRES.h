@@ -0,0 +1,157 @@
+#ifndef BATCHEDGMRESROUTINE
+#define BATCHEDGMRESROUTINE
+
+
+/** *********************************************************************************
+ * @file batchedGMRES.h
+ * @class BatchedGMRES
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to solve a group of independent linear systems together using
+ * the restarted GMRES algorithm.
+ *
+ * This is the definition (header) file for the BatchedGMRES class. A
+ * group of width systems of the same size is advanced in lockstep.
+ * The vectors are interleaved in the same way as the BatchedTridiagonal
+ * class, so that entry k of system l is at position k*width+l, and
+ * every loop over the systems is a vector operation. Each system has
+ * its own Hessenberg matrix, Givens rotations, and residual. A system
+ * that has converged is masked out. Its basis vectors are set to zero
+ * so that it adds nothing to the rest of the cycle, and its
+ * approximation is only updated with the columns found before it
+ * converged. The other systems continue until they converge or the
+ * restarts are used up.
+ *
+ * The Operation class must have a method
+ * applyBatch(const number *in,number *out,int lanes), and the
+ * Preconditioner class must have a method
+ * solveBatch(const number *in,number *out,int lanes). Both act on
+ * lanes interleaved vectors. The in and out vectors are never the
+ * same.
+ *
+ *
+ * @brief Header file for solving a group of systems with GMRES.
+ *
+ * ********************************************************************************* */
+
+#include "tensor.h"
+
+template <class number,int width=8>
+class BatchedGMRES
+{
+
+public:
+	BatchedGMRES(int size,int krylovDimension);                 //< Default constructor for the class
+
+	template <class Operation,class Preconditioner>
+	int solve(Operation* linearization,number *solution,const number *rhs,
+						Preconditioner* precond,int numberRestarts,number tolerance);
+
+	/**
+		 Method to get the number of entries in each system.
+
+		 @return The number of entries in each vector.
+	 */
+	int getSize() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get the number of systems that are solved together.
+
+		 @return The number of systems in each group.
+	 */
+	static int getWidth()
+	{
+		return(width);
+	}
+
+	/**
+		 Method to get the number of iterations a system used in the
+		 last solve. It is the same number the GMRES routine returns.
+
+		 @param lane The system in the group.
+		 @return The number of iterations, or zero if it did not converge.
+	 */
+	int getIterations(int lane) const
+	{
+		return(iterations[lane]);
+	}
+
+	/**
+		 Method to get the relative residual of a system at the end of
+		 the last solve.
+
+		 @param lane The system in the group.
+		 @return The preconditioned residual over the norm of the right hand side.
+	 */
+	number getResidual(int lane) const
+	{
+		return(rho[lane]/normRHS[lane]);
+	}
+
+protected:
+
+	template <class Operation,class Preconditioner>
+	void residual(Operation* linearization,const number *solution,const number *rhs,
+								Preconditioner* precond);                     //< Find the preconditioned residual and its norm.
+	void orthogonalize(int step);                               //< Modified Gram-Schmidt for every system.
+	void rotate(int step);                                      //< Apply the Givens rotations for every system.
+	void update(number *solution,const int *last);              //< Add the correction to every system.
+
+private:
+
+	int N;                             //< The number of entries in each system.
+	int krylov;                        //< The dimension of the Krylov subspace.
+
+	Tensor<number,2> V;                //< The interleaved basis vectors for the Krylov subspace.
+	Tensor<number,2> work;             //< The interleaved result of the operator.
+	Tensor<number,2> r;                //< The interleaved preconditioned residual.
+	Tensor<number,3> H;                //< The Hessenberg matrix for every system.
+	Tensor<number,3> givens;           //< The cosine and sine of the rotations for every system.
+	Tensor<number,2> s;                //< The rotated right hand side for every system.
+
+	number rho[width];                 //< The residual for every system.
+	number normRHS[width];             //< The norm of the right hand side for every system.
+	number active[width];              //< One for a system that has not converged, zero otherwise.
+	int    iterations[width];          //< The number of iterations for every system.
+
+};
+
+
+#include "batchedGMRES.cpp"
+
+
+#endif
@@ -0,0 +1,453 @@
+#ifndef BENCHMARKROUTINEDEFINITIONS
+#define BENCHMARKROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file benchmark.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to time the kernels and the solves used in the examples.
+ *
+ * This is the code file for the Benchmark class. The file is included
+ * by the header, so every method that is not a template is declared
+ * inline.
+ *
+ *
+ * @brief Code file for the benchmark harness.
+ *
+ * ********************************************************************************* */
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#include "benchmark.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the Benchmark class.
+ *
+ * @param runLabel A label written with the results.
+ * @param warmupCalls The number of calls made before the timing starts.
+ * @param samples The number of timed samples.
+ * ************************************************************************ */
+inline Benchmark::Benchmark(const std::string &runLabel,int warmupCalls,int samples)
+{
+	label     = runLabel;
+	bandwidth = 0.0;
+	peakFlops = 0.0;
+	setRepeats(warmupCalls,samples);
+}
+
+
+/** ************************************************************************
+ * Change the number of calls used for the kernels that are run after
+ * this. A smaller number can be used for the kernels that are slow.
+ *
+ * @param warmupCalls The number of calls made before the timing starts.
+ * @param samples The number of timed samples.
+ * ************************************************************************ */
+inline void Benchmark::setRepeats(int warmupCalls,int samples)
+{
+	warmup  = warmupCalls;
+	repeats = (samples>0) ? samples : 1;
+}
+
+
+/** ************************************************************************
+ * Time a kernel.
+ *
+ * The kernel is called warmup times. The time for one call is then
+ * used to decide how many calls to make in each sample so that a
+ * sample takes at least BENCHMARKSAMPLESECONDS.
+ *
+ * @param name The name of the kernel.
+ * @param number The number of grid points.
+ * @param krylovDimension The dimension of the Krylov subspace, or zero.
+ * @param restarts The number of restarts allowed, or zero.
+ * @param kernel The function to time. It returns a double.
+ * @return The results for the kernel.
+ * ************************************************************************ */
+template <class Kernel>
+const BenchmarkResult &Benchmark::run(const std::string &name,int number,
+																			int krylovDimension,int restarts,Kernel kernel)
+{
+	return(run(name,number,krylovDimension,restarts,0.0,0.0,kernel));
+}
+
+
+/** ************************************************************************
+ * Time a kernel that does a known amount of work.
+ *
+ * The flops and bytes are the counts for one call. They are found from
+ * the size of the problem rather than measured.
+ *
+ * @param name The name of the kernel.
+ * @param number The number of grid points.
+ * @param krylovDimension The dimension of the Krylov subspace, or zero.
+ * @param restarts The number of restarts allowed, or zero.
+ * @param flops The number of flops in one call.
+ * @param bytes The number of bytes moved in one call.
+ * @param kernel The function to time. It returns a double.
+ * @return The results for the kernel.
+ * ************************************************************************ */
+template <class Kernel>
+const BenchmarkResult &Benchmark::run(const std::string &name,int number,int krylovDimension,int restarts,
+																			double flops,double bytes,Kernel kernel)
+{
+	BenchmarkResult result;
+	result.name            = name;
+	result.number          = number;
+	result.krylovDimension = krylovDimension;
+	result.restarts        = restarts;
+	result.samples         = repeats;
+	result.value           = 0.0;
+	result.flops           = flops;
+	result.bytes           = bytes;
+
+	int lupe;
+	for(lupe=0;lupe<warmup;++lupe)
+		keep(result.value = kernel());
+
+	// Decide how many calls to make in each sample.
+	double start = seconds();
+	keep(result.value = kernel());
+	double single = seconds()-start;
+	result.calls = 1;
+	if(single<BENCHMARKSAMPLESECONDS)
+		result.calls = (single>0.0) ? (int)std::ceil(BENCHMARKSAMPLESECONDS/single) : 1000;
+
+	std::vector<double> times(repeats);
+	for(lupe=0;lupe<repeats;++lupe)
+		{
+			int inner;
+			start = seconds();
+			for(inner=0;inner<result.calls;++inner)
+				keep(result.value = kernel());
+			times[lupe] = (seconds()-start)/((double)result.calls);
+		}
+
+	std::sort(times.begin(),times.end());
+	double total = 0.0;
+	for(lupe=0;lupe<repeats;++lupe)
+		total += times[lupe];
+
+	result.minimum = times.front();
+	result.maximum = times.back();
+	result.mean    = total/((double)repeats);
+	result.median  = percentile(times,0.5);
+	result.p10     = percentile(times,0.1);
+	result.p90     = percentile(times,0.9);
+	result.p99     = percentile(times,0.99);
+
+	results.push_back(result);
+	return(results.back());
+}
+
+
+/** ************************************************************************
+ * Write the results as comma separated values. The first line gives
+ * the names of the columns.
+ *
+ * @param output The stream to write to.
+ * ************************************************************************ */
+inline void Benchmark::writeCSV(std::ostream &output) const
+{
+	output << "label,name,N,krylov,restarts,samples,calls,"
+				 << "min,median,mean,p10,p90,p99,max,value,flops,bytes" << std::endl;
+
+	std::vector<BenchmarkResult>::const_iterator result;
+	for(result=results.begin();result!=results.end();++result)
+		output << label << ","
+					 << result->name << ","
+					 << result->number << ","
+					 << result->krylovDimension << ","
+					 << result->restarts << ","
+					 << result->samples << ","
+					 << result->calls << ","
+					 << result->minimum << ","
+					 << result->median << ","
+					 << result->mean << ","
+					 << result->p10 << ","
+					 << result->p90 << ","
+					 << result->p99 << ","
+					 << result->maximum << ","
+					 << result->value << ","
+					 << result->flops << ","
+					 << result->bytes << std::endl;
+}
+
+
+/** ************************************************************************
+ * Write the results as a JSON document. The times are in seconds.
+ *
+ * @param output The stream to write to.
+ * ************************************************************************ */
+inline void Benchmark::writeJSON(std::ostream &output) const
+{
+	output << "{" << std::endl
+				 << "  \"label\": \"" << label << "\"," << std::endl
+				 << "  \"bandwidth\": " << bandwidth << "," << std::endl
+				 << "  \"peakFlops\": " << peakFlops << "," << std::endl
+				 << "  \"results\": [" << std::endl;
+
+	std::vector<BenchmarkResult>::const_iterator result;
+	for(result=results.begin();result!=results.end();++result)
+		{
+			output << "    {\"name\": \"" << result->name << "\""
+						 << ", \"N\": " << result->number
+						 << ", \"krylov\": " << result->krylovDimension
+						 << ", \"restarts\": " << result->restarts
+						 << ", \"samples\": " << result->samples
+						 << ", \"calls\": " << result->calls
+						 << ", \"min\": " << result->minimum
+						 << ", \"median\": " << result->median
+						 << ", \"mean\": " << result->mean
+						 << ", \"p10\": " << result->p10
+						 << ", \"p90\": " << result->p90
+						 << ", \"p99\": " << result->p99
+						 << ", \"max\": " << result->maximum
+						 << ", \"value\": " << result->value
+						 << ", \"flops\": " << result->flops
+						 << ", \"bytes\": " << result->bytes << "}";
+			if(result+1!=results.end())
+				output << ",";
+			output << std::endl;
+		}
+
+	output << "  ]" << std::endl
+				 << "}" << std::endl;
+}
+
+
+/** ************************************************************************
+ * Find the memory bandwidth and the flop rate used for the roofline.
+ *
+ * ************************************************************************ */
+inline void Benchmark::measureMachine()
+{
+	bandwidth = streamBandwidth();
+	peakFlops = peakFlopRate();
+}
+
+
+/** ************************************************************************
+ * Find the best flop rate for a kernel with a given number of flops
+ * for every byte it moves. It is the smaller of the flop rate and the
+ * rate the memory can feed the kernel.
+ *
+ * @param intensity The number of flops for every byte.
+ * @return The best flop rate in flops per second.
+ * ************************************************************************ */
+inline double Benchmark::roof(double intensity) const
+{
+	double memory = intensity*bandwidth;
+	return((memory<peakFlops) ? memory : peakFlops);
+}
+
+
+/** ************************************************************************
+ * Write a table that compares every kernel with a known amount of work
+ * to the roofline. The rates use the median time. The bound is memory
+ * if the kernel is to the left of the ridge point and compute
+ * otherwise. The bandwidth is for main memory, so a kernel whose
+ * vectors stay in the cache can have a fraction larger than one.
+ *
+ * @param output The stream to write to.
+ * ************************************************************************ */
+inline void Benchmark::writeRoofline(std::ostream &output) const
+{
+	output << "Bandwidth: " << bandwidth*1.0e-9 << " GB/s  Peak: " << peakFlops*1.0e-9
+				 << " GFLOP/s  Ridge: " << ((bandwidth>0.0) ? peakFlops/bandwidth : 0.0) << " flops/byte" << std::endl;
+	output << "name,N,flops/byte,GFLOP/s,GB/s,roof GFLOP/s,fraction,bound" << std::endl;
+
+	std::vector<BenchmarkResult>::const_iterator result;
+	for(result=results.begin();result!=results.end();++result)
+		{
+			if((result->flops<=0.0) || (result->bytes<=0.0) || (result->median<=0.0))
+				continue;
+
+			double intensity = result->flops/result->bytes;
+			double rate      = result->flops/result->median;
+			double best      = roof(intensity);
+			output << result->name << ","
+						 << result->number << ","
+						 << intensity << ","
+						 << rate*1.0e-9 << ","
+						 << result->bytes/result->median*1.0e-9 << ","
+						 << best*1.0e-9 << ","
+						 << ((best>0.0) ? rate/best : 0.0) << ","
+						 << ((intensity*bandwidth<peakFlops) ? "memory" : "compute") << std::endl;
+		}
+}
+
+
+/** ************************************************************************
+ * Find the memory bandwidth with a STREAM triad, a = b + s c. The
+ * vectors are first touched by the threads that use them. The best of
+ * several passes is used, and each pass moves three vectors.
+ *
+ * @param entries The number of entries in each vector.
+ * @return The bandwidth in bytes per second.
+ * ************************************************************************ */
+inline double Benchmark::streamBandwidth(std::size_t entries)
+{
+	double *a = new double[entries];
+	double *b = new double[entries];
+	double *c = new double[entries];
+	long lupe;
+	long size = (long)entries;
+
+#pragma omp parallel for schedule(static)
+	for(lupe=0;lupe<size;++lupe)
+		{
+			a[lupe] = 0.0;
+			b[lupe] = 1.0;
+			c[lupe] = 2.0;
+		}
+
+	double best = 0.0;
+	int pass;
+	for(pass=0;pass<5;++pass)
+		{
+			double start = seconds();
+#pragma omp parallel for schedule(static)
+			for(lupe=0;lupe<size;++lupe)
+				a[lupe] = b[lupe] + 3.0*c[lupe];
+			double elapsed = seconds()-start;
+			keep(a[size/2]);
+			if((elapsed>0.0) && (3.0*8.0*((double)entries)/elapsed>best))
+				best = 3.0*8.0*((double)entries)/elapsed;
+		}
+
+	delete [] a;
+	delete [] b;
+	delete [] c;
+	return(best);
+}
+
+
+/** ************************************************************************
+ * Find the flop rate with a loop of independent multiply-adds. Every
+ * thread updates its own set of BENCHMARKACCUMULATORS values, so the
+ * loop is not limited by the latency of one chain of operations.
+ *
+ * @return The flop rate in flops per second.
+ * ************************************************************************ */
+inline double Benchmark::peakFlopRate()
+{
+	const long steps = 4000000;
+	double total = 0.0;
+	int threads = 1;
+
+	double start = seconds();
+#pragma omp parallel reduction(+:total)
+	{
+		double accumulator[BENCHMARKACCUMULATORS];
+		int entry;
+		long step;
+		for(entry=0;entry<BENCHMARKACCUMULATORS;++entry)
+			accumulator[entry] = (double)entry;
+
+		for(step=0;step<steps;++step)
+			for(entry=0;entry<BENCHMARKACCUMULATORS;++entry)
+				accumulator[entry] = accumulator[entry]*0.999999 + 1.0e-6;
+
+		for(entry=0;entry<BENCHMARKACCUMULATORS;++entry)
+			total += accumulator[entry];
+	}
+	double elapsed = seconds()-start;
+	keep(total);
+
+#if defined(_OPENMP)
+	threads = omp_get_max_threads();
+#endif
+	if(elapsed<=0.0)
+		return(0.0);
+	return(2.0*((double)steps)*((double)BENCHMARKACCUMULATORS)*((double)threads)/elapsed);
+}
+
+
+/** ************************************************************************
+ * Find a percentile of a set of sorted values. Linear interpolation is
+ * used between the two closest values.
+ *
+ * @param sorted The values in increasing order.
+ * @param fraction The percentile as a fraction between zero and one.
+ * @return The value of the percentile.
+ * ************************************************************************ */
+inline double Benchmark::percentile(const std::vector<double> &sorted,double fraction)
+{
+	if(sorted.empty())
+		return(0.0);
+
+	double position = fraction*((double)(sorted.size()-1));
+	std::size_t below = (std::size_t)position;
+	if(below+1>=sorted.size())
+		return(sorted.back());
+
+	double weight = position-(double)below;
+	return((1.0-weight)*sorted[below] + weight*sorted[below+1]);
+}
+
+
+/** ************************************************************************
+ * Get the current time from a steady clock.
+ *
+ * @return The time in seconds.
+ * ************************************************************************ */
+inline double Benchmark::seconds()
+{
+	return(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+/** ************************************************************************
+ * Write a value to a volatile variable so that the compiler cannot
+ * remove the work used to find it.
+ *
+ * @param value The value to keep.
+ * ************************************************************************ */
+inline void Benchmark::keep(double value)
+{
+	static volatile double sink;
+	sink = value;
+	(void)sink;
+}
+
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef BENCHMARKROUTINE
+#define BENCHMARKROUTINE
+
+
+/** *********************************************************************************
+ * @file benchmark.h
+ * @class Benchmark
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to time the kernels and the solves used in the examples.
+ *
+ * This is the definition (header) file for the Benchmark class. A
+ * kernel is any function or object that can be called with no
+ * arguments and returns a double. The kernel is called a few times to
+ * warm up the caches and then timed over a number of samples. A
+ * kernel that is faster than BENCHMARKSAMPLESECONDS is called several
+ * times within each sample, and the time is divided by the number of
+ * calls. The minimum, median, mean, percentiles, and maximum of the
+ * samples are kept. The results can be written as CSV or JSON so that
+ * the runs of different versions can be compared.
+ *
+ * The value returned by the kernel is written to a volatile variable
+ * so that the compiler cannot remove the work, and the value from the
+ * last call is kept with the results. For a solve it is the number of
+ * iterations.
+ *
+ * A kernel can also be given the number of flops and the number of
+ * bytes it moves in one call. Then the achieved rates are compared to
+ * a roofline for the machine. The roofline uses the bandwidth found
+ * with a STREAM triad and the flop rate found with a loop of
+ * independent multiply-adds. Both probes are compiled with the same
+ * flags as the kernels, so they give the rates that the build can
+ * reach rather than the rates in the data sheet.
+ *
+ *
+ * @brief Header file for the benchmark harness.
+ *
+ * ********************************************************************************* */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// The number of calls made before the samples are timed.
+#define BENCHMARKWARMUP 3
+
+// The number of timed samples.
+#define BENCHMARKREPEATS 21
+
+// The shortest time, in seconds, for one sample. Faster kernels are
+// called more than once within a sample.
+#define BENCHMARKSAMPLESECONDS 5.0e-4
+
+// The number of entries in each vector of the STREAM triad. The three
+// vectors take 96MB, which is larger than the last level cache.
+#define BENCHMARKSTREAMENTRIES 4194304
+
+// The number of independent accumulators used to find the flop rate.
+#define BENCHMARKACCUMULATORS 32
+
+
+/**
+	 The timing results for one kernel. The times are in seconds for a
+	 single call of the kernel.
+ */
+struct BenchmarkResult
+{
+	std::string name;          //< The name of the kernel.
+	int number;                //< The number of grid points.
+	int krylovDimension;       //< The dimension of the Krylov subspace, or zero.
+	int restarts;              //< The number of restarts allowed, or zero.
+	int samples;               //< The number of timed samples.
+	int calls;                 //< The number of calls in each sample.
+	double minimum;            //< The fastest sample.
+	double median;             //< The median of the samples.
+	double mean;               //< The mean of the samples.
+	double p10;                //< The 10th percentile of the samples.
+	double p90;                //< The 90th percentile of the samples.
+	double p99;                //< The 99th percentile of the samples.
+	double maximum;            //< The slowest sample.
+	double value;              //< The value returned by the last call of the kernel.
+	double flops;              //< The number of flops in one call, or zero if it is not known.
+	double bytes;              //< The number of bytes moved in one call, or zero if it is not known.
+};
+
+
+class Benchmark
+{
+
+public:
+	Benchmark(const std::string &label="",int warmup=BENCHMARKWARMUP,int repeats=BENCHMARKREPEATS); //< Default constructor for the class
+
+	template <class Kernel>
+	const BenchmarkResult &run(const std::string &name,int number,
+														 int krylovDimension,int restarts,Kernel kernel); //< Time a kernel.
+	template <class Kernel>
+	const BenchmarkResult &run(const std::string &name,int number,int krylovDimension,int restarts,
+														 double flops,double bytes,Kernel kernel);        //< Time a kernel with a known amount of work.
+
+	void measureMachine();                              //< Find the bandwidth and flop rate for the roofline.
+	double roof(double intensity) const;                //< The best flop rate for a given flops per byte.
+	void writeRoofline(std::ostream &output) const;     //< Write a table comparing every kernel to the roofline.
+	static double streamBandwidth(std::size_t entries=BENCHMARKSTREAMENTRIES); //< Bytes per second for a STREAM triad.
+	static double peakFlopRate();                       //< Flops per second for independent multiply-adds.
+
+	void setRepeats(int warmupCalls,int samples);       //< Change the number of calls for the kernels that follow.
+	void writeCSV(std::ostream &output) const;          //< Write the results as comma separated values.
+	void writeJSON(std::ostream &output) const;         //< Write the results as a JSON document.
+
+	static double percentile(const std::vector<double> &sorted,double fraction); //< A percentile of sorted values.
+	static double seconds();                            //< The current time from a steady clock.
+
+	/**
+		 Method to get the results for every kernel that has been run.
+
+		 @return The vector of results.
+	 */
+	const std::vector<BenchmarkResult> &getResults() const
+	{
+		return(results);
+	}
+
+
+protected:
+	static void keep(double value);                     //< Write a value so that the work is not removed.
+
+
+private:
+
+	std::string label;                    //< A label for the run, for example the version.
+	int warmup;                           //< The number of untimed calls.
+	int repeats;                          //< The number of timed samples.
+	double bandwidth;                     //< The memory bandwidth in bytes per second, or zero.
+	double peakFlops;                     //< The flop rate in flops per second, or zero.
+	std::vector<BenchmarkResult> results; //< The results for every kernel.
+
+};
+
+
+#include "benchmark.cpp"
+
+
+#endif
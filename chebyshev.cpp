@@ -0,0 +1,677 @@
+#ifndef CHEBYSHEVROUTINEDEFINITIONS
+#define CHEBYSHEVROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file chebyshev.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to keep the Chebyshev collocation differentiation matrices
+ * and to share them between the operators that use them.
+ *
+ * This is the code file for the ChebyshevMatrices and ChebyshevCache
+ * classes. It includes the routines that define the first and second
+ * derivative matrices.
+ *
+ *
+ * @brief Code file for the shared Chebyshev differentiation matrices.
+ *
+ * ********************************************************************************* */
+
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include "chebyshev.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the ChebyshevMatrices class.
+ *
+ * Only the grid points are defined. The derivative matrices are
+ * defined the first time they are used.
+ *
+ * @param num The number of grid points to use.
+ * @param gridType The type of grid.
+ * ************************************************************************ */
+template <class number>
+ChebyshevMatrices<number>::ChebyshevMatrices(int num,int gridType)
+{
+	if(gridType != CHEBYSHEVGAUSSLOBATTO)
+		{
+			std::cout << "Error - ChebyshevMatrices. Unknown grid type " << gridType << std::endl;
+			std::exit(2);
+		}
+
+	N    = num;
+	grid = gridType;
+	x    = Tensor<number,1>(TensorUninitialized(),num+1);
+	nodes(x,num);
+}
+
+
+/** ************************************************************************
+ * Destructor for the ChebyshevMatrices class.
+ *
+ * The memory is released by the Tensor class, and a mapped file is
+ * unmapped by the MatrixStore class.
+ * ************************************************************************ */
+template <class number>
+ChebyshevMatrices<number>::~ChebyshevMatrices()
+{
+}
+
+
+/** ************************************************************************
+ * Get the matrix for a given derivative.
+ *
+ * The matrix is built the first time it is asked for. If more than one
+ * thread asks for it at the same time only one of them builds it, and
+ * the others wait until it is done.
+ *
+ * @param order The order of the derivative.
+ * @return The derivative matrix.
+ * ************************************************************************ */
+template <class number>
+const Tensor<number,2> &ChebyshevMatrices<number>::getDerivative(int order) const
+{
+	if((order<1) || (order>CHEBYSHEVDERIVATIVES))
+		{
+			std::cout << "Error - ChebyshevMatrices. Unknown derivative " << order << std::endl;
+			std::exit(2);
+		}
+
+	Derivative &matrix = derivative[order-1];
+	if(!matrix.built.load(std::memory_order_acquire))
+		std::call_once(matrix.once,&ChebyshevMatrices<number>::build,this,order);
+	return(matrix.values);
+}
+
+
+/** ************************************************************************
+ * Define the matrix for a given derivative.
+ *
+ * The matrix is mapped from a file if there is a matching one.
+ * Otherwise it is built and then saved if a directory for the files is
+ * given. Each derivative is kept in its own file so that a matrix that
+ * is not used is not read.
+ *
+ * @param order The order of the derivative.
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::build(int order) const
+{
+	Derivative &matrix = derivative[order-1];
+	char kind[32];
+	std::snprintf(kind,sizeof(kind),"chebyshev%d",order);
+
+	std::string fileName = MatrixStore::fileName(kind,N,grid);
+	if(!(matrix.store.open(fileName,N,grid) &&
+			 matrix.store.find("derivative",matrix.values) &&
+			 (matrix.values.getExtent(0)==N+1)))
+		{
+			// Every entry is written by the build routines, so the
+			// matrix does not need to be initialized.
+			matrix.store.close();
+			matrix.values = Tensor<number,2>(TensorUninitialized(),N+1,N+1);
+			if(order==1)
+				fastCheby1(matrix.values,N);
+			else
+				fastCheby2(matrix.values,N);
+
+			// Save the matrix so that the next process can map it.
+			if(!fileName.empty())
+				{
+					MatrixStore output;
+					output.add("derivative",matrix.values);
+					output.save(fileName,N,grid);
+				}
+		}
+
+	matrix.built.store(true,std::memory_order_release);
+}
+
+
+/** ************************************************************************
+ * Get the shared matrices for a given number of grid points.
+ *
+ * If the matrices for the size and grid type are in use they are
+ * returned. Otherwise they are built. The table only keeps weak
+ * references, so the matrices are deleted when the last shared
+ * pointer to them is released. The table is protected by a lock, so
+ * this can be called from any thread.
+ *
+ * @param num The number of grid points.
+ * @param gridType The type of grid.
+ * @return A shared pointer to the matrices.
+ * ************************************************************************ */
+template <class number>
+std::shared_ptr<const ChebyshevMatrices<number> > ChebyshevCache<number>::get(int num,int gridType)
+{
+	std::lock_guard<std::mutex> guard(lock());
+	std::weak_ptr<const ChebyshevMatrices<number> > &entry = entries()[std::make_pair(num,gridType)];
+	std::shared_ptr<const ChebyshevMatrices<number> > matrices = entry.lock();
+
+	if(!matrices)
+		{
+			matrices = std::make_shared<const ChebyshevMatrices<number> >(num,gridType);
+			entry = matrices;
+		}
+
+	return(matrices);
+}
+
+
+/** ************************************************************************
+ * Determine the number of matrices that are in use.
+ *
+ * Entries for matrices that have been deleted are removed from the
+ * table.
+ *
+ * @return The number of sets of matrices that are in use.
+ * ************************************************************************ */
+template <class number>
+int ChebyshevCache<number>::count()
+{
+	std::lock_guard<std::mutex> guard(lock());
+	typename Entries::iterator entry = entries().begin();
+	int inUse = 0;
+
+	while(entry != entries().end())
+		{
+			if(entry->second.expired())
+				entry = entries().erase(entry);
+			else
+				{
+					inUse += 1;
+					++entry;
+				}
+		}
+
+	return(inUse);
+}
+
+
+/** ************************************************************************
+ * The lock used to protect the table of entries.
+ *
+ * @return A reference to the lock.
+ * ************************************************************************ */
+template <class number>
+std::mutex &ChebyshevCache<number>::lock()
+{
+	static std::mutex tableLock;
+	return(tableLock);
+}
+
+
+/** ************************************************************************
+ * The table of matrices keyed by the number of grid points and the
+ * type of grid.
+ *
+ * @return A reference to the table.
+ * ************************************************************************ */
+template <class number>
+typename ChebyshevCache<number>::Entries &ChebyshevCache<number>::entries()
+{
+	static Entries table;
+	return(table);
+}
+
+
+/** ************************************************************************
+ * The method to initialize the Chebychev Gauss-Lobatto grid points.
+ *
+ * It assumes that the memory for the vector has been allocated. The
+ * values are the same as the ones set by the cheby1 and cheby2
+ * routines.
+ *
+ * @param xVal   The x grid points to initialize.
+ * @param num    The number of grid points to use.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::nodes(Tensor<number,1> &xVal,int num)
+{
+	int i;
+	double dxnum = 1.0/((double) num);
+
+	for (i=1;i<num;++i)
+		xVal(i) = cos(M_PI* ((double) i) * dxnum);
+	xVal(0) = 1.0;
+	xVal(num) = -1.0;
+}
+
+
+/** ************************************************************************
+ * Define the sine and cosine of the angles pi k/(2 num) for
+ * k=0,1,...,2 num.
+ *
+ * These are the only angles used in the derivative matrices. The
+ * values are found from the sine of an angle that is at most pi/4, so
+ * they keep their relative accuracy when they are close to zero.
+ *
+ * @param sine The vector for the values of the sine.
+ * @param cosine The vector for the values of the cosine.
+ * @param num The number of grid points.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::halfAngles(std::vector<double> &sine,std::vector<double> &cosine,int num)
+{
+	int k;
+	double dxnum = 1.0/((double) num);
+	std::vector<double> small(num+1);
+
+	// sin(pi k/(2 num)) for k=0..num, found from the smaller angle.
+	for(k=0;k<=num;++k)
+		{
+			if(2*k<=num)
+				small[k] = sin(M_PI*((double)k)*dxnum*0.5);
+			else
+				small[k] = cos(M_PI*((double)(num-k))*dxnum*0.5);
+		}
+
+	// Use the symmetries about pi/2 for the rest of the angles.
+	sine.resize(2*num+1);
+	cosine.resize(2*num+1);
+	for(k=0;k<=num;++k)
+		{
+			sine[k]         = small[k];
+			sine[2*num-k]   = small[k];
+			cosine[k]       = small[num-k];
+			cosine[2*num-k] = -small[num-k];
+		}
+}
+
+
+/** ************************************************************************
+ * The faster method to initialize the Chebychev collocation first
+ * derivative matrix.
+ *
+ * The off diagonal entries are c_i/c_j (-1)^(i+j)/(x_i-x_j), where
+ * x_i-x_j is written as a product of the sines of half angles that are
+ * looked up in a table. The diagonal entry is the negative of the sum
+ * of the other entries in the row, since the derivative of a constant
+ * is zero. This is more accurate than the closed form of the diagonal
+ * when num is large. Every row is defined on its own, so the rows are
+ * split between the threads.
+ *
+ * @param deriv  The derivative matrix to initialize.
+ * @param num    The number of grid points to use.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::fastCheby1(Tensor<number,2> &deriv,int num)
+{
+	std::vector<double> sine;
+	std::vector<double> cosine;
+	halfAngles(sine,cosine,num);
+
+	// The sign (-1)^j divided by c_j for every column.
+	std::vector<double> column(num+1);
+	int j;
+	for(j=0;j<=num;++j)
+		column[j] = ((j%2==1) ? -1.0 : 1.0)*(((j==0)||(j==num)) ? 0.5 : 1.0);
+
+	const double *s = sine.data();
+	const double *scale = column.data();
+	int i;
+#pragma omp parallel for schedule(static)
+	for(i=0;i<=num;++i)
+		{
+			number *row = &deriv(i,0);
+			int col;
+			double sum = 0.0;
+
+			// The factor 0.5 c_i (-1)^i for the row.
+			double factor = 0.5*((i%2==1) ? -1.0 : 1.0)*(((i==0)||(i==num)) ? 2.0 : 1.0);
+
+			// Left of the diagonal sin(pi(j-i)/(2 num)) is negative.
+			for(col=0;col<i;++col)
+				{
+					double value = -factor*scale[col]/(s[i+col]*s[i-col]);
+					row[col] = value;
+					sum += value;
+				}
+			for(col=i+1;col<=num;++col)
+				{
+					double value = factor*scale[col]/(s[i+col]*s[col-i]);
+					row[col] = value;
+					sum += value;
+				}
+			row[i] = -sum;
+		}
+}
+
+
+/** ************************************************************************
+ * The faster method to initialize the Chebychev collocation second
+ * derivative matrix.
+ *
+ * The entries use the same formulas as the cheby2 routine, but the
+ * sines and cosines are looked up in a table. The diagonal entry is
+ * the negative of the sum of the other entries in the row, since the
+ * second derivative of a constant is zero. Every row is defined on its
+ * own, so the rows are split between the threads.
+ *
+ * @param deriv  The derivative matrix to initialize.
+ * @param num    The number of grid points to use.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::fastCheby2(Tensor<number,2> &deriv,int num)
+{
+	std::vector<double> sine;
+	std::vector<double> cosine;
+	halfAngles(sine,cosine,num);
+	double xnum = (double) num;
+	double ends = 2.0*xnum*xnum+1.0;
+
+	// The sign (-1)^j with the factor for the left and right columns.
+	std::vector<double> column(num+1);
+	int j;
+	for(j=0;j<=num;++j)
+		column[j] = ((j%2==1) ? -1.0 : 1.0)*(((j==0)||(j==num)) ? 0.5 : 1.0);
+
+	const double *s = sine.data();
+	const double *c = cosine.data();
+	const double *scale = column.data();
+	int i;
+#pragma omp parallel for schedule(static)
+	for(i=0;i<=num;++i)
+		{
+			number *row = &deriv(i,0);
+			int col;
+			double sum = 0.0;
+			double sign = (i%2==1) ? -1.0 : 1.0;
+
+			if((i==0) || (i==num))
+				{
+					// The top and bottom rows. For the bottom row the sine
+					// of pi j/(2 num) is replaced by the cosine.
+					for(col=0;col<=num;++col)
+						{
+							if(col==i)
+								continue;
+							double tmp = (i==0) ? s[col] : c[col];
+							tmp *= tmp;
+							double value = sign*scale[col]*(ends*tmp-3.0)/(3.0*tmp*tmp);
+							row[col] = value;
+							sum += value;
+						}
+				}
+
+			else
+				{
+					// The interior rows. The square of the product of the
+					// sines does not depend on the sign of j-i.
+					double xi = c[2*i];
+					double si = s[2*i];
+					for(col=0;col<i;++col)
+						{
+							double tmp = si*s[i+col]*s[i-col];
+							double value = sign*scale[col]*(xi*c[i+col]*c[i-col]-1.0)*0.5/(tmp*tmp);
+							row[col] = value;
+							sum += value;
+						}
+					for(col=i+1;col<=num;++col)
+						{
+							double tmp = si*s[i+col]*s[col-i];
+							double value = sign*scale[col]*(xi*c[i+col]*c[col-i]-1.0)*0.5/(tmp*tmp);
+							row[col] = value;
+							sum += value;
+						}
+				}
+
+			row[i] = -sum;
+		}
+}
+
+
+/** ************************************************************************
+ * The method to initialize the Chebychev collocation first derivative matrix.
+ * 
+ * It assumes that the memory for the matrix has been allocated. The
+ * values of the matrix are initialized. Note that this does not make
+ * use of the current state of the values for the object, and it can
+ * be called to initialize the values of any matrix.
+ *
+ * @param deriv  A pointer to the derivative matrix to initialize.
+ * @param xVal   The x grid points to initialize.
+ * @param num    The number of grid points to use.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::cheby1(Tensor<number,2> &deriv,Tensor<number,1> &xVal,int num)
+
+/*
+      **********************************************
+       Subroutine to initialize the Chebychev first
+       derivitive matrix.  It also initializes the
+       XVAL vector.  Note that up to and including
+       (num) subscripts are used.
+      **********************************************
+*/
+
+{
+  int i,j;
+  double xnum,dxnum;
+  double tmp;
+
+  // helper variables/factors used in various formulas.
+  xnum = ((double) num);
+  dxnum = 1.0/xnum;
+
+  // define the values of x.
+  for (i=1;i<num;++i)
+     xVal(i) = cos(M_PI* ((double) i) * dxnum);
+  xVal(0) = 1.0;
+  xVal(num) = -1.0;
+
+  for (i=0;i<num;++i) // go through every row.
+      {
+          for (j=i;j<=num;++j) // fill in the values for this row.
+              {
+                  if ((i==0) && (j==0))
+                      {
+                          // this is the upper left entry in the matrix
+                          deriv(0,0) = (2.0*xnum*xnum + 1.0)/6.0;
+                          deriv(num,num) = -deriv(0,0);
+                      }
+
+                  else if (i==j)
+                      {
+                          // this is a diagonal entry in the matrix.
+                          tmp = 1.0/sin(M_PI*((double)i)*dxnum);
+                          deriv(i,i) = -xVal(i)*tmp*tmp*0.5;
+                      }
+
+                  else
+                      {
+                          // This is an off diagonal entry.
+                          deriv(i,j) =
+                              0.5/(sin(M_PI*((double)(i+j))*dxnum*0.5)*sin(M_PI*((double)(-i+j))*dxnum*0.5));
+                          // Add a mult. factor for the top and bottom
+                          // rows as well as the left and right
+                          // columns.
+                          if (i%num == 0)
+                              deriv(i,j) *= 2.0;
+                          if (j%num == 0)
+                              deriv(i,j) *= 0.5;
+                          if ((i+j)%2 == 1)
+                              deriv(i,j) *= -1.0;
+
+                          // The matrix is anti-symmetric so fill in
+                          // the opposite side of the matrix.
+                          deriv(num-i,num-j) = - deriv(i,j);
+                      }
+              }
+      }
+
+}
+
+
+
+/** ************************************************************************
+ * The method to initialize the Chebychev collocation second derivative matrix.
+ * 
+ * It assumes that the memory for the matrix has been allocated. The
+ * values of the matrix are initialized. Note that this does not make
+ * use of the current state of the values for the object, and it can
+ * be called to initialize the values of any matrix.
+ *
+ * @param deriv  A pointer to the derivative matrix to initialize.
+ * @param xVal   The x grid points to initialize.
+ * @param num    The number of grid points to use.
+ * @return N/A
+ * ************************************************************************ */
+template <class number>
+void ChebyshevMatrices<number>::cheby2(Tensor<number,2> &deriv,Tensor<number,1> &xVal,int num)
+
+
+/*
+     *****************************************************
+       Subroutine to initialize the second derivitive
+       Chebychev matrix.  It also initializes the X
+       vector.  Note that up to and including the num
+       subscript is accessed.
+    ******************************************************
+
+*/
+
+{
+  double xnum,dxnum;
+  int i,j;
+  double tmp;
+
+  // helper variables/factors used in various formulas.
+  xnum = (double) num;
+  dxnum = 1.0/xnum;
+
+  // Define the values of x
+  for (i=1;i<num;++i)
+     xVal(i) = cos(M_PI*((double) i)*dxnum);
+  xVal(0) = 1.0;
+  xVal(num) = -1.0;
+
+  for (i=0;i<=num/2;++i) // go through each row.
+      {
+          for (j=0;j<=num;++j) // go through each column.
+              {
+
+                  if (((i==0) && (j==0)) ||
+                      ((i==num) && (j==num)))
+                      // fill in the top left and bottom right entries
+                      // in the matrix.
+                      deriv(i,j) = (xnum*xnum*xnum*xnum-1.0)/15.0;
+
+                  else if (i==0)
+                      {
+                          // This is the top row.
+                          tmp = sin(M_PI*((double)j)*dxnum*0.5);
+                          tmp *= tmp;
+                          deriv(i,j) = ((2.0*xnum*xnum+1.0)
+                                         *tmp-3.0)/(3.0*tmp*tmp);
+                          // The sign of the values are alternating
+                          if (j%2 == 1)
+                              deriv(i,j) *= -1.0;
+
+                          if ((j==0) || (j==num))
+                              // include the multipler for the left and right columns.
+                              deriv(i,j) *= 0.5;
+                      }
+
+                  else if (i==num)
+                      {
+                          // This is the bottom row.
+                          tmp = cos(M_PI*((double)j)*dxnum*0.5);
+                          tmp *= tmp;
+                          deriv(i,j) = ((2.0*xnum*xnum+1.0)
+                                         *tmp-3.0)/(3*tmp*tmp);
+
+                          // The sign of the values are alternating.
+                          if ((num+j)%2 == 1)
+                               deriv(i,j) *= -1.0;
+
+                           // Include the multipler for the left and right columns.
+                           if ((j==0) || (j==num))
+                               deriv(i,j) *= 0.5;
+
+                       }
+
+                   else if (i==j)
+                       {
+                           // This is the diagonal entry.
+                           tmp = sin(M_PI*((double)i)*dxnum);
+                           tmp *= tmp;
+                           deriv(i,j) = -((xnum*xnum-1.0)*tmp+3.0)
+                               /(3.0*tmp*tmp);
+                       }
+
+                   else
+                       {
+                           // This is an off diagonal entry.
+                           tmp = sin(M_PI*((double)i)*dxnum);
+                           tmp *= sin(M_PI*((double)(i+j))*dxnum*0.5);
+                           tmp *= sin(M_PI*((double)(-i+j))*dxnum*0.5);
+                           tmp *= tmp;
+                           deriv(i,j) = (cos(M_PI*((double)i)*dxnum)*
+                                          cos(M_PI*((double)(i+j))*dxnum*0.5) *
+                                          cos(M_PI*((double)(i-j))*dxnum*0.5) - 1.0)*0.5/tmp;
+
+                           // The signs of the values are alternating
+                           if ((i+j)%2 == 1)
+                               deriv(i,j) *= -1.0;
+
+                           // Include the multiplier for the left and right columns.
+                           if ((j==0) || (j==num))
+                               deriv(i,j) *= 0.5;
+                       }
+
+               }
+        }
+
+
+   // The matrix is symmetric so fill in the rest of the matrix.
+   for (i=num/2+1;i<=num;++i)
+       for (j=0;j<=num;++j)
+           deriv(i,j) = deriv(num-i,num-j);
+
+}
+
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef CHEBYSHEVROUTINE
+#define CHEBYSHEVROUTINE
+
+
+/** *********************************************************************************
+ * @file chebyshev.h
+ * @class ChebyshevMatrices
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to keep the Chebyshev collocation differentiation matrices
+ * and to share them between the operators that use them.
+ *
+ * This is the definition (header) file for the ChebyshevMatrices and
+ * ChebyshevCache classes. A ChebyshevMatrices object holds the grid
+ * points and the first and second derivative matrices for a given
+ * number of grid points. It cannot be changed once it is
+ * constructed. The ChebyshevCache class hands out shared pointers to
+ * these objects. Every request for the same number of grid points and
+ * the same grid type gets the same object as long as one of them is
+ * still in use, and the object is deleted when the last one is
+ * released. A derivative matrix is not built until it is first asked
+ * for, so a matrix that is never used takes no time or memory.
+ *
+ * If a directory is given for the MatrixStore class then the matrices
+ * are read from a file that is mapped into memory, and the file is
+ * written the first time the matrices are built.
+ *
+ *
+ * @brief Header file for the shared Chebyshev differentiation matrices.
+ *
+ * ********************************************************************************* */
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "tensor.h"
+#include "store.h"
+
+// The types of grids. The Gauss-Lobatto grid is x_j = cos(pi j/N).
+#define CHEBYSHEVGAUSSLOBATTO 0
+
+// The number of derivative matrices that can be built. The matrix for
+// derivative k is built the first time it is used.
+#define CHEBYSHEVDERIVATIVES 2
+
+
+template <class number>
+class ChebyshevMatrices
+{
+
+public:
+	ChebyshevMatrices(int num,int gridType=CHEBYSHEVGAUSSLOBATTO); //< Constructor that builds the matrices
+	~ChebyshevMatrices();                                          //< Destructor for the class
+
+	// Define the routines that initialize the grid points and the first
+	// and second derivative matrices. The cheby routines evaluate every
+	// entry directly, and the chebyshevCheck example checks the fast
+	// routines against them.
+	static void nodes(Tensor<number,1> &xVal,int num);
+	static void cheby1(Tensor<number,2> &deriv,Tensor<number,1> &xVal,int num);
+	static void cheby2(Tensor<number,2> &deriv,Tensor<number,1> &xVal,int num);
+
+	// Define the faster routines used to build the matrices. They only
+	// evaluate O(num) trigonometric functions, and the rows are split
+	// between the threads.
+	static void fastCheby1(Tensor<number,2> &deriv,int num);
+	static void fastCheby2(Tensor<number,2> &deriv,int num);
+
+	/**
+		 Method to get the number of grid points.
+
+		 @return The largest index of a grid point.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get the type of grid.
+
+		 @return The grid type.
+	 */
+	int getGrid() const
+	{
+		return(grid);
+	}
+
+	/**
+		 Method to get the grid points.
+
+		 @return The vector of grid points.
+	 */
+	const Tensor<number,1> &getNodes() const
+	{
+		return(x);
+	}
+
+	const Tensor<number,2> &getDerivative(int order) const;      //< The matrix for a derivative, built on first use.
+
+	/**
+		 Method to get the first derivative matrix.
+
+		 @return The first derivative matrix.
+	 */
+	const Tensor<number,2> &getFirst() const
+	{
+		return(getDerivative(1));
+	}
+
+	/**
+		 Method to get the second derivative matrix.
+
+		 @return The second derivative matrix.
+	 */
+	const Tensor<number,2> &getSecond() const
+	{
+		return(getDerivative(2));
+	}
+
+	/**
+		 Method to determine whether or not a derivative matrix has
+		 been built.
+
+		 @param order The order of the derivative.
+		 @return True if the matrix has been built or mapped.
+	 */
+	bool isBuilt(int order) const
+	{
+		return(derivative[order-1].built.load(std::memory_order_acquire));
+	}
+
+
+protected:
+
+	/**
+		 A derivative matrix and the flag used to build it once.
+	 */
+	struct Derivative
+	{
+		Derivative() : built(false) {}
+		std::once_flag    once;      //< Flag used to build the matrix once.
+		std::atomic<bool> built;     //< Set once the matrix is available.
+		Tensor<number,2>  values;    //< The derivative matrix.
+		MatrixStore       store;     //< The mapped file when the matrix is a view of a file.
+	};
+
+	void build(int order) const;                                    //< Define the matrix for a derivative.
+	static void halfAngles(std::vector<double> &sine,std::vector<double> &cosine,int num); //< sin and cos of pi k/(2 num).
+
+
+private:
+	ChebyshevMatrices(const ChebyshevMatrices& oldCopy);            //< The matrices are shared rather than copied.
+
+	int N;                   //< The number of grid points in the approximation.
+	int grid;                //< The type of grid.
+	Tensor<number,1> x;      //< The grid points.
+	mutable Derivative derivative[CHEBYSHEVDERIVATIVES]; //< The derivative matrices.
+
+};
+
+
+template <class number>
+class ChebyshevCache
+{
+
+public:
+	static std::shared_ptr<const ChebyshevMatrices<number> > get(int num,int gridType=CHEBYSHEVGAUSSLOBATTO);
+	static int count();                                             //< The number of matrices that are in use.
+
+protected:
+	typedef std::map<std::pair<int,int>,std::weak_ptr<const ChebyshevMatrices<number> > > Entries;
+	static std::mutex &lock();                                      //< Lock for the table of entries.
+	static Entries &entries();                                      //< The table of matrices keyed by size and grid.
+
+};
+
+
+#include "chebyshev.cpp"
+
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef CHECKPOINTROUTINEDEFINITIONS
+#define CHECKPOINTROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file checkpoint.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to save the state of a GMRES solve to a file so that it can
+ * be resumed.
+ *
+ * This is the code file for the Checkpoint class. The file is
+ * included by the header, so every method that is not a template is
+ * declared inline.
+ *
+ *
+ * @brief Code file for saving and resuming a GMRES solve.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "checkpoint.h"
+
+
+/** ************************************************************************
+ * Constructor for a checkpoint kept in a file.
+ *
+ * @param name The name of the file. If it is empty nothing is read or written.
+ * @param steps The number of Arnoldi steps between checkpoints within a cycle, or zero to only write at a restart.
+ * ************************************************************************ */
+inline Checkpoint::Checkpoint(const std::string &name,int steps)
+{
+	fileName = name;
+	interval = steps;
+	writes   = 0;
+	resumed  = false;
+	rhsKey   = 0;
+}
+
+
+/** ************************************************************************
+ * Read the state of an earlier solve of the same system.
+ *
+ * The header is checked against the system, and the approximation is
+ * only changed once the whole file has been read and its checksum
+ * matches. If the file was written within a cycle, the basis vectors
+ * up to the next step and the small matrices are read as well.
+ *
+ * @param rhs The right hand side of the system.
+ * @param solution The approximation, which is replaced by the one in the file.
+ * @param V The basis for the Krylov subspace.
+ * @param H The Hessenberg matrix.
+ * @param givens The Givens rotations.
+ * @param s The right hand side of the least squares problem.
+ * @param position Set to the place in the solve where the file was written.
+ * @return True if the state was read.
+ * ************************************************************************ */
+template <class Approximation,class Double>
+bool Checkpoint::resume(const Approximation &rhs,Approximation &solution,std::vector<Approximation> &V,
+												Tensor<Double,2> &H,Tensor<Double,2> &givens,Tensor<Double,1> &s,
+												GMRESPosition &position)
+{
+	resumed = false;
+	if(fileName.empty())
+		return(false);
+	rhsKey  = checksum(rhs.data(),rhs.getSize()*sizeof(Double),14695981039346656037ULL);
+
+	std::FILE *fp = std::fopen(fileName.c_str(),"rb");
+	if(fp==NULL)
+		return(false);
+
+	CheckpointHeader header;
+	std::uint64_t vectorBytes = solution.getSize()*sizeof(Double);
+	std::uint64_t matrixBytes = (H.getSize()+givens.getSize()+s.getSize())*sizeof(Double);
+	bool valid = (std::fread(&header,sizeof(CheckpointHeader),1,fp)==1)
+		&& (std::memcmp(header.magic,"GMRESCKP",8)==0)
+		&& (header.version==CHECKPOINTVERSION)
+		&& (header.byteOrder==0x01020304)
+		&& (header.numberBytes==sizeof(Double))
+		&& (header.number==solution.getN())
+		&& (header.krylovDimension==H.getExtent(1))
+		&& (header.step>=0) && (header.step<H.getExtent(1))
+		&& (header.vectorBytes==vectorBytes)
+		&& (header.matrixBytes==matrixBytes)
+		&& (header.rhsKey==rhsKey);
+
+	// The approximation is read into a separate block so that it is
+	// left alone if the file is damaged. The basis is only used after
+	// a successful resume.
+	std::vector<Double> values(valid ? solution.getSize() : 0);
+	if(valid)
+		valid = (std::fread(values.data(),1,vectorBytes,fp)==vectorBytes);
+
+	int lupe;
+	for(lupe=0;valid&&(lupe<=header.step)&&(header.step>0);++lupe)
+		valid = (std::fread(V[lupe].data(),1,vectorBytes,fp)==vectorBytes);
+	if(valid && (header.step>0))
+		valid = (std::fread(H.data(),sizeof(Double),H.getSize(),fp)==H.getSize())
+			&& (std::fread(givens.data(),sizeof(Double),givens.getSize(),fp)==givens.getSize())
+			&& (std::fread(s.data(),sizeof(Double),s.getSize(),fp)==s.getSize());
+	std::fclose(fp);
+
+	if(valid)
+		{
+			std::uint64_t key = header.key;
+			header.key = 0;
+			std::uint64_t hash = checksum(&header,sizeof(CheckpointHeader),14695981039346656037ULL);
+			hash = checksum(values.data(),vectorBytes,hash);
+			for(lupe=0;(lupe<=header.step)&&(header.step>0);++lupe)
+				hash = checksum(V[lupe].data(),vectorBytes,hash);
+			if(header.step>0)
+				{
+					hash = checksum(H.data(),H.getSize()*sizeof(Double),hash);
+					hash = checksum(givens.data(),givens.getSize()*sizeof(Double),hash);
+					hash = checksum(s.data(),s.getSize()*sizeof(Double),hash);
+				}
+			valid = (hash==key);
+		}
+	if(!valid)
+		return(false);
+
+	std::memcpy(solution.data(),values.data(),vectorBytes);
+	position = GMRESPosition(header.step,header.restarts,header.remaining,header.rho);
+	resumed  = true;
+	return(true);
+}
+
+
+/** ************************************************************************
+ * Write the state of the solve if it is time to. The file is always
+ * written at a restart. Within a cycle it is written after every
+ * interval Arnoldi steps, but not after the last step of a cycle since
+ * the restart follows.
+ *
+ * @param solution The approximation at the start of the cycle, or after the update at a restart.
+ * @param V The basis for the Krylov subspace.
+ * @param H The Hessenberg matrix.
+ * @param givens The Givens rotations.
+ * @param s The right hand side of the least squares problem.
+ * @param position The place in the solve.
+ * ************************************************************************ */
+template <class Approximation,class Double>
+void Checkpoint::save(const Approximation &solution,const std::vector<Approximation> &V,
+											const Tensor<Double,2> &H,const Tensor<Double,2> &givens,const Tensor<Double,1> &s,
+											const GMRESPosition &position)
+{
+	if(fileName.empty())
+		return;
+	if((position.step>0) &&
+		 ((interval<=0) || (position.step%interval!=0) || (position.step>=H.getExtent(1))))
+		return;
+
+	CheckpointHeader header;
+	std::memset(&header,0,sizeof(CheckpointHeader));
+	std::memcpy(header.magic,"GMRESCKP",8);
+	header.version         = CHECKPOINTVERSION;
+	header.byteOrder       = 0x01020304;
+	header.numberBytes     = sizeof(Double);
+	header.number          = solution.getN();
+	header.krylovDimension = H.getExtent(1);
+	header.step            = position.step;
+	header.restarts        = position.restarts;
+	header.remaining       = position.remaining;
+	header.vectorBytes     = solution.getSize()*sizeof(Double);
+	header.matrixBytes     = (H.getSize()+givens.getSize()+s.getSize())*sizeof(Double);
+	header.rho             = position.rho;
+	header.rhsKey          = rhsKey;
+
+	std::size_t vectorBytes = (std::size_t)header.vectorBytes;
+	std::uint64_t hash = checksum(&header,sizeof(CheckpointHeader),14695981039346656037ULL);
+	hash = checksum(solution.data(),vectorBytes,hash);
+	int lupe;
+	for(lupe=0;(lupe<=position.step)&&(position.step>0);++lupe)
+		hash = checksum(V[lupe].data(),vectorBytes,hash);
+	if(position.step>0)
+		{
+			hash = checksum(H.data(),H.getSize()*sizeof(Double),hash);
+			hash = checksum(givens.data(),givens.getSize()*sizeof(Double),hash);
+			hash = checksum(s.data(),s.getSize()*sizeof(Double),hash);
+		}
+	header.key = hash;
+
+	// Write everything to a temporary file and then replace the old
+	// checkpoint.
+	char suffix[32];
+	std::snprintf(suffix,sizeof(suffix),".%ld.tmp",(long)getpid());
+	std::string temporary = fileName + suffix;
+	std::FILE *fp = std::fopen(temporary.c_str(),"wb");
+	if(fp==NULL)
+		return;
+
+	bool written = (std::fwrite(&header,sizeof(CheckpointHeader),1,fp)==1)
+		&& (std::fwrite(solution.data(),1,vectorBytes,fp)==vectorBytes);
+	for(lupe=0;written&&(lupe<=position.step)&&(position.step>0);++lupe)
+		written = (std::fwrite(V[lupe].data(),1,vectorBytes,fp)==vectorBytes);
+	if(written && (position.step>0))
+		written = (std::fwrite(H.data(),sizeof(Double),H.getSize(),fp)==H.getSize())
+			&& (std::fwrite(givens.data(),sizeof(Double),givens.getSize(),fp)==givens.getSize())
+			&& (std::fwrite(s.data(),sizeof(Double),s.getSize(),fp)==s.getSize());
+
+	written = (std::fclose(fp)==0) && written;
+	if(written)
+		written = (std::rename(temporary.c_str(),fileName.c_str())==0);
+	if(!written)
+		std::remove(temporary.c_str());
+	else
+		writes += 1;
+}
+
+
+/** ************************************************************************
+ * Delete the file, usually once the solve has converged.
+ *
+ * @return True if the file was removed.
+ * ************************************************************************ */
+inline bool Checkpoint::remove()
+{
+	if(fileName.empty())
+		return(false);
+	return(std::remove(fileName.c_str())==0);
+}
+
+
+/** ************************************************************************
+ * Add a block of bytes to a 64 bit FNV-1a checksum.
+ *
+ * @param data The bytes to add.
+ * @param bytes The number of bytes.
+ * @param hash The current value of the checksum.
+ * @return The new value of the checksum.
+ * ************************************************************************ */
+inline std::uint64_t Checkpoint::checksum(const void *data,std::size_t bytes,std::uint64_t hash)
+{
+	const unsigned char *current = (const unsigned char *)data;
+	std::size_t lupe;
+	for(lupe=0;lupe<bytes;++lupe)
+		{
+			hash ^= (std::uint64_t)current[lupe];
+			hash *= 1099511628211ULL;
+		}
+	return(hash);
+}
+
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef CHECKPOINTROUTINE
+#define CHECKPOINTROUTINE
+
+
+/** *********************************************************************************
+ * @file checkpoint.h
+ * @class Checkpoint
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to save the state of a GMRES solve to a file so that it can
+ * be resumed.
+ *
+ * This is the definition (header) file for the NullCheckpoint and
+ * Checkpoint classes. A checkpoint can be passed to the GMRES routine
+ * after the monitor. The routine asks the checkpoint to resume when it
+ * starts, and it offers the state of the solve at every restart and
+ * after every Arnoldi step. The NullCheckpoint class does nothing, and
+ * it is the one used when none is given.
+ *
+ * The Checkpoint class keeps the state in one binary file. At a
+ * restart the file holds the approximation and the number of restarts.
+ * If an interval is given, the file is also written within a cycle
+ * after every interval Arnoldi steps, and then it holds the basis for
+ * the Krylov subspace, the Hessenberg matrix, the Givens rotations,
+ * and the vector s as well. A solve that resumes from the file
+ * continues with the same values that the interrupted solve would
+ * have used.
+ *
+ * The header of the file has the size of the problem, the dimension
+ * of the subspace, a checksum of the right hand side, and a checksum
+ * of the whole file. A file that does not match the system being
+ * solved, or that is damaged, is ignored and the solve starts from the
+ * beginning. The file is written to a temporary name and then renamed,
+ * so a solve that is stopped while writing leaves the last complete
+ * checkpoint. A Checkpoint with an empty file name does nothing, and
+ * the examples take the name from the environment variable given by
+ * CHECKPOINTENVIRONMENT. The Approximation class must have the data() and
+ * getSize() methods that give its values as one block of memory.
+ *
+ *
+ * @brief Header file for saving and resuming a GMRES solve.
+ *
+ * ********************************************************************************* */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tensor.h"
+
+#define CHECKPOINTVERSION 1
+
+// The environment variable the examples use for the name of the file.
+#define CHECKPOINTENVIRONMENT "GMRES_CHECKPOINT"
+
+// The number of Arnoldi steps between checkpoints used by the examples.
+#define CHECKPOINTINTERVAL 50
+
+
+/**
+	 The place in a GMRES solve where a checkpoint is taken.
+ */
+struct GMRESPosition
+{
+	/**
+		 Constructor for a position in a solve.
+
+		 @param next The next Arnoldi step in the cycle, zero at a restart.
+		 @param done The number of restarts that are finished.
+		 @param left The value of the restart counter to continue with.
+		 @param estimate The estimate of the residual.
+	 */
+	GMRESPosition(int next=0,int done=0,int left=0,double estimate=0.0) :
+		step(next), restarts(done), remaining(left), rho(estimate) {}
+
+	int step;                   //< The next Arnoldi step in the cycle, zero at a restart.
+	int restarts;               //< The number of restarts that are finished.
+	int remaining;              //< The value of the restart counter to continue with.
+	double rho;                 //< The estimate of the residual within a cycle.
+};
+
+
+/**
+	 The header at the start of a checkpoint file.
+ */
+struct CheckpointHeader
+{
+	char magic[8];              //< The string GMRESCKP.
+	std::uint32_t version;      //< The version of the layout of the file.
+	std::uint32_t byteOrder;    //< The value 0x01020304 written in the byte order of the machine.
+	std::uint32_t numberBytes;  //< The size of one value.
+	std::int32_t number;        //< The number of grid points.
+	std::int32_t krylovDimension; //< The dimension of the Krylov subspace.
+	std::int32_t step;          //< The next Arnoldi step in the cycle.
+	std::int32_t restarts;      //< The number of restarts that are finished.
+	std::int32_t remaining;     //< The value of the restart counter to continue with.
+	std::uint64_t vectorBytes;  //< The bytes in one approximation.
+	std::uint64_t matrixBytes;  //< The bytes in the Hessenberg matrix, the rotations, and s.
+	double rho;                 //< The estimate of the residual within a cycle.
+	std::uint64_t rhsKey;       //< A checksum of the right hand side.
+	std::uint64_t key;          //< A checksum of the header and the data.
+};
+
+
+/**
+	 The checkpoint that does nothing. The solve always starts from the
+	 beginning and nothing is saved.
+ */
+class NullCheckpoint
+{
+
+public:
+	template <class Approximation,class Double>
+	bool resume(const Approximation&,Approximation&,std::vector<Approximation>&,
+							Tensor<Double,2>&,Tensor<Double,2>&,Tensor<Double,1>&,GMRESPosition&)
+	{
+		return(false);
+	}
+
+	template <class Approximation,class Double>
+	void save(const Approximation&,const std::vector<Approximation>&,
+						const Tensor<Double,2>&,const Tensor<Double,2>&,const Tensor<Double,1>&,const GMRESPosition&) {}
+
+};
+
+
+class Checkpoint
+{
+
+public:
+	Checkpoint(const std::string &name,int steps=0); //< Constructor for a checkpoint kept in a file
+
+	template <class Approximation,class Double>
+	bool resume(const Approximation &rhs,Approximation &solution,std::vector<Approximation> &V,
+							Tensor<Double,2> &H,Tensor<Double,2> &givens,Tensor<Double,1> &s,
+							GMRESPosition &position);                //< Read the state of an earlier solve.
+
+	template <class Approximation,class Double>
+	void save(const Approximation &solution,const std::vector<Approximation> &V,
+						const Tensor<Double,2> &H,const Tensor<Double,2> &givens,const Tensor<Double,1> &s,
+						const GMRESPosition &position);              //< Write the state if it is time to.
+
+	bool remove();                                        //< Delete the file.
+
+	/**
+		 Method to get the name of the file.
+
+		 @return The name of the file.
+	 */
+	const std::string &getFileName() const
+	{
+		return(fileName);
+	}
+
+	/**
+		 Method to get the number of Arnoldi steps between checkpoints
+		 within a cycle.
+
+		 @return The number of steps, or zero if the file is only written at a restart.
+	 */
+	int getInterval() const
+	{
+		return(interval);
+	}
+
+	/**
+		 Method to get the number of times the file was written.
+
+		 @return The number of checkpoints written.
+	 */
+	int getWrites() const
+	{
+		return(writes);
+	}
+
+	/**
+		 Method to determine whether or not the last solve was resumed
+		 from the file.
+
+		 @return True if the state was read from the file.
+	 */
+	bool isResumed() const
+	{
+		return(resumed);
+	}
+
+
+protected:
+	static std::uint64_t checksum(const void *data,std::size_t bytes,std::uint64_t hash); //< FNV-1a checksum.
+
+
+private:
+
+	std::string fileName;       //< The name of the file.
+	int interval;               //< The number of Arnoldi steps between checkpoints within a cycle.
+	int writes;                 //< The number of times the file was written.
+	bool resumed;               //< True if the last solve was resumed.
+	std::uint64_t rhsKey;       //< The checksum of the right hand side of the current solve.
+
+};
+
+
+#include "checkpoint.cpp"
+
+
+#endif
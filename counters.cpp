@@ -0,0 +1,351 @@
+#ifndef COUNTERSROUTINEDEFINITIONS
+#define COUNTERSROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file counters.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to read the hardware performance counters during a GMRES
+ * solve.
+ *
+ * This is the code file for the PerformanceCounters and
+ * CounterMonitor classes. The file is included by the header, so
+ * every method is declared inline.
+ *
+ *
+ * @brief Code file for the hardware performance counters.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstring>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "counters.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the PerformanceCounters class.
+ *
+ * A group of counters is opened on every thread of the OpenMP team,
+ * inside a parallel region, so the threads that already exist are
+ * counted. Each group also follows the threads its thread creates
+ * later, and only the time spent in user space is counted. A counter
+ * that cannot be opened is marked as unavailable.
+ * ************************************************************************ */
+inline PerformanceCounters::PerformanceCounters()
+{
+	threads = 1;
+#if defined(_OPENMP)
+	threads = omp_get_max_threads();
+#endif
+	descriptor.assign(threads*COUNTEREVENTS,-1);
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+#pragma omp parallel num_threads(threads)
+	{
+		int thread = 0;
+#if defined(_OPENMP)
+		thread = omp_get_thread_num();
+#endif
+		openGroup(&descriptor[thread*COUNTEREVENTS]);
+	}
+#endif
+}
+
+
+/** ************************************************************************
+ * Destructor for the PerformanceCounters class.
+ *
+ * The counters that were opened are closed.
+ * ************************************************************************ */
+inline PerformanceCounters::~PerformanceCounters()
+{
+#if defined(__linux__)
+	int lupe;
+	for(lupe=(int)descriptor.size()-1;lupe>=0;--lupe)
+		if(descriptor[lupe]>=0)
+			close(descriptor[lupe]);
+#endif
+}
+
+
+/** ************************************************************************
+ * Open the counters for the calling thread as one group.
+ *
+ * The first counter that can be opened is the leader of the group, and
+ * the others are scheduled on the processor only when the leader is,
+ * so every counter in the group sees the same part of the run when the
+ * kernel has to share the hardware counters. Each counter also reports
+ * the time it was enabled and the time it was running so that its
+ * value can be scaled.
+ *
+ * @param group The array of descriptors for the thread. An entry is -1
+ *        if the counter could not be opened.
+ * ************************************************************************ */
+inline void PerformanceCounters::openGroup(int group[COUNTEREVENTS])
+{
+#if defined(__linux__) && defined(SYS_perf_event_open)
+	unsigned long long config[COUNTEREVENTS];
+	config[COUNTERCYCLES]          = PERF_COUNT_HW_CPU_CYCLES;
+	config[COUNTERINSTRUCTIONS]    = PERF_COUNT_HW_INSTRUCTIONS;
+	config[COUNTERCACHEREFERENCES] = PERF_COUNT_HW_CACHE_REFERENCES;
+	config[COUNTERCACHEMISSES]     = PERF_COUNT_HW_CACHE_MISSES;
+
+	int leader = -1;
+	int lupe;
+	for(lupe=0;lupe<COUNTEREVENTS;++lupe)
+		{
+			struct perf_event_attr attributes;
+			std::memset(&attributes,0,sizeof(attributes));
+			attributes.type           = PERF_TYPE_HARDWARE;
+			attributes.size           = sizeof(attributes);
+			attributes.config         = config[lupe];
+			attributes.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv     = 1;
+			attributes.inherit        = 1;
+			group[lupe] = (int)syscall(SYS_perf_event_open,&attributes,0,-1,leader,0);
+			if(group[lupe]<0)
+				group[lupe] = -1;
+			else if(leader<0)
+				leader = group[lupe];
+		}
+#else
+	int lupe;
+	for(lupe=0;lupe<COUNTEREVENTS;++lupe)
+		group[lupe] = -1;
+#endif
+}
+
+
+/** ************************************************************************
+ * Read the current value of every counter. The values are the sums
+ * over the threads, and each one is scaled by the time it was enabled
+ * over the time it was running. The value of a counter that is not
+ * available is zero.
+ *
+ * @param values The array the values are written into.
+ * ************************************************************************ */
+inline void PerformanceCounters::read(unsigned long long values[COUNTEREVENTS]) const
+{
+	int lupe;
+	for(lupe=0;lupe<COUNTEREVENTS;++lupe)
+		values[lupe] = 0;
+
+#if defined(__linux__)
+	int thread;
+	for(thread=0;thread<threads;++thread)
+		for(lupe=0;lupe<COUNTEREVENTS;++lupe)
+			{
+				// The value, the time enabled, and the time running.
+				unsigned long long sample[3];
+				int fd = descriptor[thread*COUNTEREVENTS+lupe];
+				if((fd<0) || (::read(fd,sample,sizeof(sample))!=(ssize_t)sizeof(sample)) || (sample[2]==0))
+					continue;
+				values[lupe] += (unsigned long long)(((double)sample[0])*((double)sample[1])/((double)sample[2]));
+			}
+#endif
+}
+
+
+/** ************************************************************************
+ * Get a short name for an event.
+ *
+ * @param event The event.
+ * @return The name of the event.
+ * ************************************************************************ */
+inline const char *PerformanceCounters::eventName(int event)
+{
+	switch(event)
+		{
+		case COUNTERCYCLES:
+			return("cycles");
+		case COUNTERINSTRUCTIONS:
+			return("instructions");
+		case COUNTERCACHEREFERENCES:
+			return("LLC references");
+		case COUNTERCACHEMISSES:
+			return("LLC misses");
+		}
+	return("unknown");
+}
+
+
+/** ************************************************************************
+ * Base constructor  for the CounterMonitor class.
+ *
+ * The counters are opened when the monitor is created. No flops are
+ * known for any phase.
+ * ************************************************************************ */
+inline CounterMonitor::CounterMonitor()
+{
+	int phase;
+	int event;
+	for(phase=0;phase<MONITORPHASES;++phase)
+		{
+			for(event=0;event<COUNTEREVENTS;++event)
+				{
+					count[phase][event]      = 0;
+					counterStart[phase][event] = 0;
+				}
+			flopsPerCall[phase] = 0.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Called when the solve starts. The counts from any previous solve are
+ * cleared.
+ *
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * @param numberRestarts The largest number of restarts.
+ * ************************************************************************ */
+inline void CounterMonitor::start(int krylovDimension,int numberRestarts)
+{
+	ReportMonitor::start(krylovDimension,numberRestarts);
+	int phase;
+	int event;
+	for(phase=0;phase<MONITORPHASES;++phase)
+		for(event=0;event<COUNTEREVENTS;++event)
+			count[phase][event] = 0;
+}
+
+
+/** ************************************************************************
+ * Called when a phase starts. The counters are read after the clock
+ * so that the time to read them is not counted.
+ *
+ * @param phase The phase that is starting.
+ * ************************************************************************ */
+inline void CounterMonitor::begin(int phase)
+{
+	ReportMonitor::begin(phase);
+	counters.read(counterStart[phase]);
+}
+
+
+/** ************************************************************************
+ * Called when a phase ends. The change in every counter is added to
+ * the totals for the phase.
+ *
+ * The values are scaled by the time each group was running, and the
+ * scale changes when the counters are multiplexed, so a scaled value
+ * can be smaller than the one read when the phase started. The change
+ * is taken to be zero in that case rather than letting the unsigned
+ * difference wrap around.
+ *
+ * @param phase The phase that is ending.
+ * ************************************************************************ */
+inline void CounterMonitor::end(int phase)
+{
+	unsigned long long values[COUNTEREVENTS];
+	counters.read(values);
+	ReportMonitor::end(phase);
+
+	int event;
+	for(event=0;event<COUNTEREVENTS;++event)
+		if(values[event] > counterStart[phase][event])
+			count[phase][event] += values[event]-counterStart[phase][event];
+}
+
+
+/** ************************************************************************
+ * Set the number of floating point operations in one call of a phase.
+ * This is needed to find the number of bytes per flop.
+ *
+ * @param phase The phase.
+ * @param flops The number of flops in one call.
+ * ************************************************************************ */
+inline void CounterMonitor::setFlops(int phase,double flops)
+{
+	flopsPerCall[phase] = flops;
+}
+
+
+/** ************************************************************************
+ * Find the number of instructions per cycle for a phase.
+ *
+ * @param phase The phase.
+ * @return The instructions per cycle, or zero if it is not known.
+ * ************************************************************************ */
+inline double CounterMonitor::instructionsPerCycle(int phase) const
+{
+	if(count[phase][COUNTERCYCLES]==0)
+		return(0.0);
+	return(((double)count[phase][COUNTERINSTRUCTIONS])/((double)count[phase][COUNTERCYCLES]));
+}
+
+
+/** ************************************************************************
+ * Estimate the number of bytes moved from memory during a phase. Every
+ * miss in the last level cache is taken to move one cache line. This
+ * is not a measure of the memory bandwidth. Write backs, hardware
+ * prefetches and lines brought in by other cores are not counted as
+ * misses; the uncore or offcore events that do count them depend on
+ * the processor, so they are not used.
+ *
+ * @param phase The phase.
+ * @return The number of bytes, or zero if it is not known.
+ * ************************************************************************ */
+inline double CounterMonitor::memoryBytes(int phase) const
+{
+	return(((double)count[phase][COUNTERCACHEMISSES])*((double)COUNTERLINEBYTES));
+}
+
+
+/** ************************************************************************
+ * Find the number of bytes moved from memory for every flop in a
+ * phase.
+ *
+ * @param phase The phase.
+ * @return The bytes per flop, or zero if it is not known.
+ * ************************************************************************ */
+inline double CounterMonitor::bytesPerFlop(int phase) const
+{
+	double flops = flopsPerCall[phase]*((double)getReport().calls[phase]);
+	if((flops<=0.0) || !counters.isAvailable(COUNTERCACHEMISSES))
+		return(0.0);
+	return(memoryBytes(phase)/flops);
+}
+
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef COUNTERSROUTINE
+#define COUNTERSROUTINE
+
+
+/** *********************************************************************************
+ * @file counters.h
+ * @class CounterMonitor
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to read the hardware performance counters during a GMRES
+ * solve.
+ *
+ * This is the definition (header) file for the PerformanceCounters
+ * and CounterMonitor classes. The PerformanceCounters class opens the
+ * Linux perf_event_open counters for the cycles, the instructions,
+ * the references to the last level cache, and the misses in the last
+ * level cache. One group of counters is opened for every thread in the
+ * OpenMP team, and each group also follows the threads created later
+ * by its thread. The counters in a group are scheduled together, and
+ * the values are scaled by the time the group was running, so the
+ * ratios stay sensible when the kernel shares the hardware counters
+ * between more events than it has. A counter that the machine or the
+ * kernel does not allow is marked as unavailable and the others are
+ * still used. On systems other than Linux no counter is available.
+ *
+ * The CounterMonitor class is a monitor for the GMRES routine. It
+ * does everything a ReportMonitor does and also adds the change in
+ * every counter to the phase that is running. The derived values are
+ * the instructions per cycle, the bytes moved from memory, estimated
+ * as a cache line for every miss in the last level cache, and the
+ * bytes per flop when the number of flops for a call of a phase is
+ * given. The estimate leaves out write backs and prefetches, so it is
+ * a lower bound on the traffic and not a bandwidth measurement.
+ *
+ *
+ * @brief Header file for the hardware performance counters.
+ *
+ * ********************************************************************************* */
+
+#include <vector>
+#include "monitor.h"
+
+// The events that are counted.
+#define COUNTERCYCLES          0
+#define COUNTERINSTRUCTIONS    1
+#define COUNTERCACHEREFERENCES 2
+#define COUNTERCACHEMISSES     3
+#define COUNTEREVENTS          4
+
+// The number of bytes moved for every miss in the last level cache.
+// This is only used to estimate the traffic from memory.
+#define COUNTERLINEBYTES 64
+
+
+class PerformanceCounters
+{
+
+public:
+	PerformanceCounters();                                   //< Default constructor for the class
+	~PerformanceCounters();                                  //< Destructor for the class
+
+	void read(unsigned long long values[COUNTEREVENTS]) const; //< The current value of every counter.
+	static const char *eventName(int event);                 //< A short name for an event.
+
+	/**
+		 Method to determine whether or not a counter could be opened.
+
+		 @param event The event.
+		 @return True if the counter is being read.
+	 */
+	bool isAvailable(int event) const
+	{
+		int thread;
+		for(thread=0;thread<threads;++thread)
+			if(descriptor[thread*COUNTEREVENTS+event]>=0)
+				return(true);
+		return(false);
+	}
+
+	/**
+		 Method to determine whether or not any counter could be opened.
+
+		 @return True if at least one counter is being read.
+	 */
+	bool isAvailable() const
+	{
+		int lupe;
+		for(lupe=0;lupe<COUNTEREVENTS;++lupe)
+			if(isAvailable(lupe))
+				return(true);
+		return(false);
+	}
+
+
+private:
+	PerformanceCounters(const PerformanceCounters& oldCopy);  //< The counters cannot be shared by copying.
+	PerformanceCounters& operator=(const PerformanceCounters& oldCopy);
+
+	static void openGroup(int group[COUNTEREVENTS]);          //< Open the counters for the calling thread.
+
+	int threads;                     //< The number of threads with their own counters.
+	std::vector<int> descriptor;     //< The file descriptor for every thread and counter, or -1.
+
+};
+
+
+class CounterMonitor : public ReportMonitor
+{
+
+public:
+	CounterMonitor();                                        //< Default constructor for the class
+
+	void start(int krylovDimension,int numberRestarts);      //< Called when the solve starts.
+	void begin(int phase);                                   //< Called when a phase starts.
+	void end(int phase);                                     //< Called when a phase ends.
+	void setFlops(int phase,double flops);                   //< The number of flops in one call of a phase.
+
+	double instructionsPerCycle(int phase) const;            //< Instructions divided by cycles.
+	double memoryBytes(int phase) const;                     //< Bytes estimated from the cache misses.
+	double bytesPerFlop(int phase) const;                    //< Bytes from memory for each flop.
+
+	/**
+		 Method to get the total change in a counter during a phase.
+
+		 @param phase The phase.
+		 @param event The event.
+		 @return The total count.
+	 */
+	unsigned long long getCount(int phase,int event) const
+	{
+		return(count[phase][event]);
+	}
+
+	/**
+		 Method to get the counters used by the monitor.
+
+		 @return The counters.
+	 */
+	const PerformanceCounters &getCounters() const
+	{
+		return(counters);
+	}
+
+
+private:
+
+	PerformanceCounters counters;                            //< The hardware counters.
+	unsigned long long count[MONITORPHASES][COUNTEREVENTS];  //< The total for each phase and event.
+	unsigned long long counterStart[MONITORPHASES][COUNTEREVENTS]; //< The counters when each phase was last entered.
+	double flopsPerCall[MONITORPHASES];                      //< The flops in one call of each phase.
+
+};
+
+
+#include "counters.cpp"
+
+
+#endif
@@ -0,0 +1,142 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+/* *********************************************************************************
+ *
+ * Solve the one dimensional example on another thread. Three solves
+ * are submitted using GMRESAsync. The first one runs while this
+ * thread defines the right hand side of the next system, the second
+ * one is given a deadline that is too short for it to converge, and
+ * the third one is cancelled. The result of each one is written when
+ * its future is ready.
+ *
+ * Usage: asyncSolver [-n N] [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "../GMRES.h"
+#include "../options.h"
+#include "../asyncSolve.h"
+
+#include <iostream>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <cmath>
+
+
+/** ************************************************************************
+ * Define the same right hand side as the systemSolver example.
+ *
+ * @param elliptical The operator that gives the grid points.
+ * @param b The right hand side to define.
+ * @return N/A
+ * ************************************************************************ */
+void assemble(const Poisson &elliptical,Solution &b)
+{
+	int lupe;
+	b = 0.0;
+	for(lupe=1;lupe<elliptical.getN();++lupe)
+		{
+			double xgrid = elliptical.getX(lupe);
+			b(lupe) = 90.0*pow(xgrid,8.0)-2.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Wait for a solve and write its result.
+ *
+ * @param name The name of the solve.
+ * @param future The future for the solve.
+ * @return N/A
+ * ************************************************************************ */
+void report(const char *name,std::future<SolveResult<Solution> > &future)
+{
+	SolveResult<Solution> result = future.get();
+	std::cout << name << ","
+						<< result.solution.getN() << ","
+						<< result.iterations << ","
+						<< result.report.converged << ","
+						<< result.stopped << ","
+						<< result.report.residual << ","
+						<< result.report.totalSeconds << std::endl;
+}
+
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(256,41,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+	int number = options.getNumber();
+
+	Poisson elliptical(number);
+	Preconditioner pre(number);
+	Solution x(number);
+	Solution b(number);
+	assemble(elliptical,b);
+
+	Poisson nextElliptical(2*number);
+	Preconditioner nextPre(2*number);
+	Solution nextX(2*number);
+	Solution nextB(2*number);
+
+	std::cout << "solve,N,iterations,converged,stopped,residual,time" << std::endl;
+
+	// Define the next system while the first one is solved.
+	std::future<SolveResult<Solution> > first =
+		GMRESAsync(&elliptical,x,b,&pre,options.getKrylovDimension(),options.getRestarts(),options.getTolerance());
+	assemble(nextElliptical,nextB);
+	report("overlapped",first);
+
+	// Give the larger system a deadline that is too short.
+	std::shared_ptr<SolveControl> control = std::make_shared<SolveControl>();
+	control->setTimeout(0.01);
+	std::future<SolveResult<Solution> > second =
+		GMRESAsync(&nextElliptical,nextX,nextB,&nextPre,
+							 options.getKrylovDimension(),options.getRestarts(),options.getTolerance(),control);
+	report("deadline",second);
+
+	// Cancel a solve.
+	control = std::make_shared<SolveControl>();
+	std::future<SolveResult<Solution> > third =
+		GMRESAsync(&nextElliptical,nextX,nextB,&nextPre,
+							 options.getKrylovDimension(),options.getRestarts(),options.getTolerance(),control);
+	control->cancel();
+	report("cancelled",third);
+
+	return(0);
+}
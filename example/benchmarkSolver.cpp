@@ -0,0 +1,192 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+
+/* *********************************************************************************
+ *
+ * Benchmarks for the one dimensional example. The vector operations,
+ * the operator, the preconditioner, and complete GMRES solves are
+ * timed for several numbers of grid points, dimensions of the Krylov
+ * subspace, and numbers of restarts.
+ *
+ * Usage: benchmarkSolver [csv|json|roofline] [label]
+ *
+ * The roofline format measures the bandwidth and the flop rate of the
+ * machine, times only the kernels whose flops and bytes are known,
+ * and writes a table comparing each one to the roofline.
+ *
+ * The results are written to the standard output.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "../GMRES.h"
+#include "../pool.h"
+#include "../benchmark.h"
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <vector>
+
+
+/** ************************************************************************
+ * Time the update of the approximation at the end of a GMRES cycle
+ * for a subspace of a given dimension. The triangular system is solved
+ * in place, so the coefficients are reset before every call. The basis
+ * vectors are copies of one vector, and the coefficients are small so
+ * the approximation does not grow.
+ *
+ * @param bench The benchmark that keeps the results.
+ * @param number The number of grid points.
+ * @param dimension The dimension of the Krylov subspace.
+ * @param basis The vector used for every basis vector.
+ * @param x The approximation that is updated.
+ * ************************************************************************ */
+void benchmarkUpdate(Benchmark &bench,int number,int dimension,const Solution &basis,Solution &x)
+{
+	std::vector<Solution> V(dimension,basis);
+	Tensor<double,2> H(dimension+1,dimension);
+	Tensor<double,1> s(dimension+1);
+	int row;
+	int col;
+	for(row=0;row<dimension;++row)
+		{
+			H(row,row) = 2.0;
+			for(col=row+1;col<dimension;++col)
+				H(row,col) = 0.1;
+		}
+
+	double n     = (double)(V[0].getN()+1);
+	double k     = (double)dimension;
+	double flops = k*k + k + 2.0*k*n;
+	double bytes = 24.0*k*n + 8.0*k*k;
+	x = 0.0;
+	bench.run("update",number,dimension,0,flops,bytes,[&]()
+						{
+							int lupe;
+							for(lupe=0;lupe<dimension;++lupe)
+								s(lupe) = 1.0e-9;
+							Update(H,&x,s,&V,dimension-1);
+							return(s(0));
+						});
+}
+
+
+int main(int argc,char **argv)
+{
+	std::string format = (argc>1) ? argv[1] : "csv";
+	std::string label  = (argc>2) ? argv[2] : "";
+	bool roofline      = (format=="roofline");
+	Benchmark bench(label);
+	if(roofline)
+		bench.measureMachine();
+
+	int sizes[]    = {32,64,128,256,512};
+	int krylov[]   = {10,20,41};
+	int restarts[] = {1,10};
+	int size;
+	int dimension;
+	int restart;
+
+	for(size=0;size<5;++size)
+		{
+			int number = sizes[size];
+			Poisson elliptical(number);
+			Preconditioner pre(number);
+			Solution u(number);
+			Solution v(number);
+			Solution w(number);
+			Solution x(number);
+			Solution b(number);
+
+			// Use the same right hand side as the systemSolver example.
+			int lupe;
+			for(lupe=0;lupe<=number;++lupe)
+				{
+					double xgrid = elliptical.getX(lupe);
+					u(lupe) = sin(M_PI*xgrid);
+					v(lupe) = cos(M_PI*xgrid);
+					b(lupe) = 90.0*pow(xgrid,8.0)-2.0;
+				}
+			b(0)      = 0.0;
+			b(number) = 0.0;
+
+			// The flops and bytes for one call of each kernel. A vector
+			// has n entries. The operator multiplies the N-1 interior rows
+			// of the dense second derivative matrix, and the preconditioner
+			// is a forward and a backwards tridiagonal solve.
+			double n        = (double)(number+1);
+			double interior = (double)(number-1);
+			double applyFlops = 2.0*interior*n;
+			double applyBytes = 8.0*interior*n + 16.0*n;
+			double solveFlops = 6.0*n;
+			double solveBytes = 64.0*n;
+
+			bench.setRepeats(BENCHMARKWARMUP,BENCHMARKREPEATS);
+			bench.run("dot",number,0,0,2.0*n,16.0*n,[&]() { return(Solution::dot(u,v)); });
+			bench.run("norm",number,0,0,2.0*n,8.0*n,[&]() { return(u.norm()); });
+			bench.run("axpy",number,0,0,2.0*n,24.0*n,[&]() { w.axpy(&u,1.0e-6); return(w.getEntry(1)); });
+			bench.run("operator",number,0,0,applyFlops,applyBytes+16.0*n,[&]() { w = elliptical*u; return(w.getEntry(1)); });
+			bench.run("apply",number,0,0,applyFlops,applyBytes,[&]() { elliptical.apply(u,w); return(w.getEntry(1)); });
+			bench.run("precondition",number,0,0,solveFlops,solveBytes+16.0*n,[&]() { w = pre.solve(u); return(w.getEntry(1)); });
+			bench.run("solveInto",number,0,0,solveFlops,solveBytes,[&]() { pre.solveInto(u,w); return(w.getEntry(1)); });
+			for(dimension=0;dimension<3;++dimension)
+				benchmarkUpdate(bench,number,krylov[dimension],u,x);
+
+			// Every solve starts from zero. The value is the number of
+			// iterations, or zero if the solve did not converge. The
+			// solves are slow, so fewer samples are taken.
+			if(roofline)
+				continue;
+			bench.setRepeats(1,5);
+			for(dimension=0;dimension<3;++dimension)
+				for(restart=0;restart<2;++restart)
+					bench.run("gmres",number,krylov[dimension],restarts[restart],[&]()
+										 {
+											 MemoryPoolScope scope;
+											 x = 0.0;
+											 return((double)GMRES(&elliptical,&x,&b,&pre,
+																						krylov[dimension],restarts[restart],1.0e-8));
+										 });
+		}
+
+	if(roofline)
+		bench.writeRoofline(std::cout);
+	else if(format=="json")
+		bench.writeJSON(std::cout);
+	else
+		bench.writeCSV(std::cout);
+
+	return(0);
+}
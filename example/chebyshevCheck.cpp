@@ -0,0 +1,113 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Check that the fast routines used to build the Chebyshev derivative
+ * matrices give the same matrices as the reference routines. The
+ * reference routines, cheby1 and cheby2, evaluate every entry
+ * directly, and the fast routines, fastCheby1 and fastCheby2, are the
+ * ones used by the ChebyshevMatrices class.
+ *
+ * Usage: chebyshevCheck
+ *
+ * The largest difference for each number of grid points is written
+ * relative to the largest entry of the reference matrix. If any of
+ * them is bigger than CHEBYSHEVCHECK an error is written and the
+ * program returns one.
+ *
+ * ********************************************************************************* */
+
+#include "../chebyshev.h"
+
+#include <iostream>
+#include <cmath>
+
+// The largest difference allowed between the fast and the reference
+// matrices relative to the largest entry.
+#define CHEBYSHEVCHECK 1.0e-10
+
+
+/** ************************************************************************
+ * Find the largest difference between two matrices relative to the
+ * largest entry of the reference matrix.
+ *
+ * @param fast The matrix from the fast routine.
+ * @param reference The matrix from the reference routine.
+ * @param number The number of grid points.
+ * @return The relative difference.
+ * ************************************************************************ */
+double relativeDifference(const Tensor<double,2> &fast,const Tensor<double,2> &reference,int number)
+{
+	double largest    = 0.0;
+	double difference = 0.0;
+	int row;
+	int col;
+	for(row=0;row<=number;++row)
+		for(col=0;col<=number;++col)
+			{
+				if(fabs(reference(row,col)) > largest)
+					largest = fabs(reference(row,col));
+				if(fabs(fast(row,col)-reference(row,col)) > difference)
+					difference = fabs(fast(row,col)-reference(row,col));
+			}
+	return(difference/largest);
+}
+
+
+int main(int argc,char **argv)
+{
+	int sizes[] = {2,3,8,17,32,64,65,128,256,512};
+	int size;
+	int status = 0;
+
+	std::cout << "N,first,second" << std::endl;
+	for(size=0;size<10;++size)
+		{
+			int number = sizes[size];
+			Tensor<double,2> reference(number+1,number+1);
+			Tensor<double,2> fast(number+1,number+1);
+			Tensor<double,1> grid(number+1);
+
+			ChebyshevMatrices<double>::cheby1(reference,grid,number);
+			ChebyshevMatrices<double>::fastCheby1(fast,number);
+			double first = relativeDifference(fast,reference,number);
+
+			ChebyshevMatrices<double>::cheby2(reference,grid,number);
+			ChebyshevMatrices<double>::fastCheby2(fast,number);
+			double second = relativeDifference(fast,reference,number);
+
+			std::cout << number << "," << first << "," << second << std::endl;
+			if((first > CHEBYSHEVCHECK) || (second > CHEBYSHEVCHECK))
+				{
+					std::cerr << "Error - the fast derivative matrices for N=" << number
+										<< " differ from the reference matrices." << std::endl;
+					status = 1;
+				}
+		}
+
+	return(status);
+}
@@ -0,0 +1,179 @@
+#ifndef FIXEDPOISSONDEFINITIONS
+#define FIXEDPOISSONDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file fixedPoisson.cpp
+ * @class FixedPoisson
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the operator and its linearization for a PDE
+ * when the number of grid points is known when the program is
+ * compiled.
+ *
+ * This is the code file for the FixedPoisson class. The class is a
+ * template, so this file is included by the header.
+ *
+ *
+ * @brief code file for the fixed size operator associated with a PDE.
+ *
+ * ********************************************************************************* */
+
+
+#include "fixedPoisson.h"
+
+#include <cstdlib>
+#include <iostream>
+
+
+// The matrices are used by reference, so they must be defined outside
+// of the class as well.
+template <int N>
+constexpr FixedChebyshev<N> FixedPoisson<N>::matrices;
+
+
+/** ************************************************************************
+ * Base constructor  for the FixedPoisson class.
+ *
+ * The size is given so that the class can be used in place of the
+ * Poisson class, and it must be the same as the template parameter.
+ *
+ * @param size The number of grid points used in the approximation.
+ * ************************************************************************ */
+template <int N>
+FixedPoisson<N>::FixedPoisson(int size)
+{
+	if(size != N)
+		{
+			std::cout << "Error - FixedPoisson. The size " << size
+								<< " is not the fixed size " << N << std::endl;
+			std::exit(2);
+		}
+}
+
+
+/** ************************************************************************
+ * The operator acting on an approximation.
+ *
+ * @param vector The approximation to multiply.
+ * @return The result of the operator acting on the approximation.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N> FixedPoisson<N>::operator*(const FixedSolution<N>& vector)
+{
+	FixedSolution<N> result(N);
+	apply(vector,result);
+	return(result);
+}
+
+
+/** ************************************************************************
+ * The operator acting on an approximation written into an existing
+ * object.
+ *
+ * The first and last rows return the boundary values, and the other
+ * rows are the second derivative. The input and the result must be
+ * different objects.
+ *
+ * @param vector The approximation to multiply.
+ * @param result The object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void FixedPoisson<N>::apply(const FixedSolution<N>& vector,FixedSolution<N>& result)
+{
+	const double *in = vector.data();
+	double *out = result.data();
+	int lupe;
+	int innerLupe;
+
+	out[0] = in[0];
+	for(lupe=1;lupe<N;++lupe)
+		{
+			const double *row = matrices.second[lupe];
+			double tmp = row[0]*in[0];
+			for(innerLupe=1;innerLupe<=N;++innerLupe)
+				tmp += row[innerLupe]*in[innerLupe];
+			out[lupe] = tmp;
+		}
+	out[N] = in[N];
+}
+
+
+/** ************************************************************************
+ * The operator acting on a group of interleaved vectors.
+ *
+ * Entry k of vector l is at position k*lanes+l, and the same is true
+ * of the result. The operations for each vector are the same, and in
+ * the same order, as the apply method. The input and the result must
+ * be different.
+ *
+ * @param in The interleaved vectors to multiply.
+ * @param out The interleaved vectors the result is written into.
+ * @param lanes The number of vectors.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void FixedPoisson<N>::applyBatch(const double *in,double *out,int lanes)
+{
+	int lupe;
+	int innerLupe;
+	int lane;
+
+#pragma omp simd
+	for(lane=0;lane<lanes;++lane)
+		{
+			out[lane]         = in[lane];
+			out[N*lanes+lane] = in[N*lanes+lane];
+		}
+
+	for(lupe=1;lupe<N;++lupe)
+		{
+			const double *row = matrices.second[lupe];
+			double *result = out + lupe*lanes;
+#pragma omp simd
+			for(lane=0;lane<lanes;++lane)
+				result[lane] = row[0]*in[lane];
+			for(innerLupe=1;innerLupe<=N;++innerLupe)
+				{
+					const double *column = in + innerLupe*lanes;
+#pragma omp simd
+					for(lane=0;lane<lanes;++lane)
+						result[lane] += row[innerLupe]*column[lane];
+				}
+		}
+}
+
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef FIXEDPOISSONCLASS
+#define FIXEDPOISSONCLASS
+
+
+/** *********************************************************************************
+ * @file fixedPoisson.h
+ * @class FixedPoisson
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the operator and its linearization for a PDE
+ * when the number of grid points is known when the program is
+ * compiled.
+ *
+ * This is the definition (header) file for the FixedPoisson class. It
+ * has the same methods as the Poisson class that are used by the
+ * GMRES routine, and it acts on a FixedSolution of the same size. The
+ * grid points and the second derivative matrix are found by the
+ * compiler and are shared by every operator of the same size.
+ * The applyBatch method acts on a group of interleaved vectors for
+ * the BatchedGMRES class.
+ *
+ *
+ * @brief header file for the fixed size operator associated with a PDE.
+ *
+ * ********************************************************************************* */
+
+#include "fixedSolution.h"
+#include "../fixedChebyshev.h"
+
+template <int N>
+class FixedPoisson
+{
+
+public:
+	FixedPoisson(int size=N);        //< Default constructor for the FixedPoisson Class.
+
+	// Basic algebraic operators associated with the linearization of the operator.
+	FixedSolution<N> operator*(const FixedSolution<N>& vector);            //< The linearized operator acting on a given approximation.
+	void apply(const FixedSolution<N>& vector,FixedSolution<N>& result);   //< The linearized operator written into an existing approximation.
+	void applyBatch(const double *in,double *out,int lanes);              //< The linearized operator acting on interleaved vectors.
+
+	/**
+		 Method to get the value of the linearization at a given row and column.
+
+		 @param row The row number in the matrix
+		 @param column The column number in the matrix.
+		 @return The value within the matrix at the given row and column.
+	 */
+	double operator()(int row,int column) const
+	{
+		return(matrices.second[row][column]);
+	}
+
+	/**
+		 Method to get the value of the x coordinate for a given row number.
+
+		 @param row The row number you want to access.
+		 @return The value of x at the given row number.
+	 */
+	double getX(int row) const
+	{
+		return(matrices.nodes[row]);
+	}
+
+	/**
+		 Method to get the number of elements that are in the approximation.
+
+		 @return The number of elements in the grid.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get one of the elements from the second derivative matrix.
+
+		 @param row The row number in the matrix
+		 @param col The column number in the matrix.
+		 @return The value within the matrix at the given row and column.
+	 */
+	double getD2(int row,int col) const
+	{
+		return(matrices.second[row][col]);
+	}
+
+private:
+
+	// The grid points and the second derivative matrix are found when
+	// the program is compiled.
+	static constexpr FixedChebyshev<N> matrices = FixedChebyshev<N>();
+
+};
+
+
+#include "fixedPoisson.cpp"
+
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef FIXEDPRECONDITIONERDEFINITIONS
+#define FIXEDPRECONDITIONERDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file fixedPreconditioner.cpp
+ * @class FixedPreconditioner
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the preconditioner for the linearized
+ * operator associated with a PDE when the number of grid points is
+ * known when the program is compiled.
+ *
+ * This is the code file for the FixedPreconditioner class. The class
+ * is a template, so this file is included by the header.
+ *
+ *
+ * @brief code file for the fixed size preconditioner for the
+ * linearized PDE.
+ *
+ * ********************************************************************************* */
+
+
+#include "fixedPreconditioner.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+/** ************************************************************************
+ * Base constructor  for the FixedPreconditioner class.
+ *
+ * Finds the Cholesky decomposition of the second order finite
+ * difference operator in the same way as the Preconditioner class.
+ *
+ * @param size The number of grid points used in the approximation.
+ * ************************************************************************ */
+template <int N>
+FixedPreconditioner<N>::FixedPreconditioner(int size)
+{
+	if(size != N)
+		{
+			std::cout << "Error - FixedPreconditioner. The size " << size
+								<< " is not the fixed size " << N << std::endl;
+			std::exit(2);
+		}
+
+	int lupe;
+	double m = 0.0;
+	double r = 2.0 + m;
+	for(lupe=0;lupe<=N;++lupe)
+		{
+			diagonal[lupe] = sqrt(r);
+			r = (r*(2+m)-1)/r;
+		}
+
+	lower[0] = 0.0;
+	for(lupe=1;lupe<=N;++lupe)
+		lower[lupe] = -1.0/diagonal[lupe-1];
+	intermediate.fill(0.0);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner.
+ *
+ * @param current The right hand side of the system.
+ * @return The solution to the preconditioned system.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N> FixedPreconditioner<N>::solve(const FixedSolution<N> &current)
+{
+	FixedSolution<N> multiplied(N);
+	solveInto(current,multiplied);
+	return(multiplied);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner and write the result into an existing object.
+ *
+ * The result must be a different object than the right hand side.
+ *
+ * @param current The right hand side of the system.
+ * @param multiplied The object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void FixedPreconditioner<N>::solveInto(const FixedSolution<N> &current,FixedSolution<N> &multiplied)
+{
+	// Perform the forward solve to invert the first part of the
+	// Cholesky decomposition.
+	int lupe;
+	intermediate[0] = current.getEntry(0)/diagonal[0];
+	for(lupe=1;lupe<=N;++lupe)
+		intermediate[lupe] = (current.getEntry(lupe)-lower[lupe]*intermediate[lupe-1])/diagonal[lupe];
+
+	// Perform the backwards solve for the Cholesky decomposition.
+	multiplied(N) = intermediate[N]/diagonal[N];
+	for(lupe=N-1;lupe>=0;--lupe)
+		multiplied(lupe) = (intermediate[lupe]-multiplied(lupe+1)*lower[lupe+1])/diagonal[lupe];
+
+	// Restore the boundary conditions.
+	multiplied(0) = current.getEntry(0);
+	multiplied(N) = current.getEntry(N);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner for a group of interleaved vectors.
+ *
+ * Entry k of vector l is at position k*lanes+l. The forward solve is
+ * written into the result, and the backwards solve is done in place,
+ * so no scratch space is needed. The operations for each vector are
+ * the same, and in the same order, as the solveInto method. The
+ * result must be different than the right hand side.
+ *
+ * @param current The interleaved right hand sides.
+ * @param multiplied The interleaved vectors the result is written into.
+ * @param lanes The number of vectors.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void FixedPreconditioner<N>::solveBatch(const double *current,double *multiplied,int lanes)
+{
+	int lupe;
+	int lane;
+
+	// Perform the forward solve.
+#pragma omp simd
+	for(lane=0;lane<lanes;++lane)
+		multiplied[lane] = current[lane]/diagonal[0];
+	for(lupe=1;lupe<=N;++lupe)
+		{
+			const double *in = current + lupe*lanes;
+			const double *previous = multiplied + (lupe-1)*lanes;
+			double *out = multiplied + lupe*lanes;
+#pragma omp simd
+			for(lane=0;lane<lanes;++lane)
+				out[lane] = (in[lane]-lower[lupe]*previous[lane])/diagonal[lupe];
+		}
+
+	// Perform the backwards solve.
+	double *row = multiplied + N*lanes;
+#pragma omp simd
+	for(lane=0;lane<lanes;++lane)
+		row[lane] = row[lane]/diagonal[N];
+	for(lupe=N-1;lupe>=0;--lupe)
+		{
+			const double *next = multiplied + (lupe+1)*lanes;
+			double *out = multiplied + lupe*lanes;
+#pragma omp simd
+			for(lane=0;lane<lanes;++lane)
+				out[lane] = (out[lane]-next[lane]*lower[lupe+1])/diagonal[lupe];
+		}
+
+	// Restore the boundary conditions.
+#pragma omp simd
+	for(lane=0;lane<lanes;++lane)
+		{
+			multiplied[lane]         = current[lane];
+			multiplied[N*lanes+lane] = current[N*lanes+lane];
+		}
+}
+
+
+#endif
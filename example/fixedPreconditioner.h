@@ -0,0 +1,97 @@
+#ifndef FIXEDPRECONDITIONERCLASS
+#define FIXEDPRECONDITIONERCLASS
+
+
+/** *********************************************************************************
+ * @file fixedPreconditioner.h
+ * @class FixedPreconditioner
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the preconditioner for the linearized
+ * operator associated with a PDE when the number of grid points is
+ * known when the program is compiled.
+ *
+ * This is the definition (header) file for the FixedPreconditioner
+ * class. It uses the same Cholesky decomposition of the finite
+ * difference operator as the Preconditioner class, but the entries and
+ * the scratch space are kept in std::array objects that are part of
+ * the object.
+ * The solveBatch method solves the system for a group of interleaved
+ * vectors for the BatchedGMRES class.
+ *
+ *
+ * @brief header file for the fixed size preconditioner for the
+ * linearized PDE.
+ *
+ * ********************************************************************************* */
+
+#include <array>
+#include "fixedSolution.h"
+
+template <int N>
+class FixedPreconditioner
+{
+
+public:
+	FixedPreconditioner(int size=N);              //< Default constructor for the class
+
+	FixedSolution<N> solve(const FixedSolution<N> &current);    //< Method to solve the
+                                                              //< system associated with
+                                                              //< the preconditioner.
+	void solveInto(const FixedSolution<N> &current,FixedSolution<N> &multiplied); //< Solve the system and write the result into an existing object.
+	void solveBatch(const double *current,double *multiplied,int lanes);           //< Solve the system for interleaved vectors.
+
+	/**
+		 Method to get the number of elements that are used for the approximation.
+
+		 @return The number of grid points used in the approximation.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+private:
+
+	std::array<double,N+1> diagonal;      //< The diagonal of the Cholesky decomposition.
+	std::array<double,N+1> lower;         //< The entries below the diagonal of the Cholesky decomposition.
+	std::array<double,N+1> intermediate;  //< Scratch space for the forward solve.
+
+};
+
+
+#include "fixedPreconditioner.cpp"
+
+
+#endif
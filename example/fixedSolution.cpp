@@ -0,0 +1,202 @@
+#ifndef FIXEDSOLUTIONDEFINITIONS
+#define FIXEDSOLUTIONDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file fixedSolution.cpp
+ * @class FixedSolution
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the approximation of a PDE when the number
+ * of grid points is known when the program is compiled.
+ *
+ * This is the code file for the FixedSolution class. The class is a
+ * template, so this file is included by the header.
+ *
+ *
+ * @brief code file for the fixed size approximation of a PDE.
+ *
+ * ********************************************************************************* */
+
+
+#include "fixedSolution.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+/** ************************************************************************
+ * Base constructor  for the FixedSolution class.
+ *
+ * The size is given so that the class can be used in place of the
+ * Solution class, and it must be the same as the template parameter.
+ *
+ * @param size The number of grid points used in the approximation.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N>::FixedSolution(int size)
+{
+	if(size != N)
+		{
+			std::cout << "Error - FixedSolution. The size " << size
+								<< " is not the fixed size " << N << std::endl;
+			std::exit(2);
+		}
+	solution.fill(0.0);
+}
+
+
+/** ************************************************************************
+ * Assignment operator for the FixedSolution class. Sets every entry to
+ * the same value.
+ *
+ * @param value The value to set every entry to.
+ * @return The current object.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N>& FixedSolution<N>::operator=(const double& value)
+{
+	solution.fill(value);
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * Multiply every entry by a scalar.
+ *
+ * @param value The value to multiply each entry by.
+ * @return The current object.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N>& FixedSolution<N>::operator*=(const double& value)
+{
+	int lupe;
+	for(lupe=0;lupe<=N;++lupe)
+		solution[lupe] *= value;
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * Subtract another approximation from this one.
+ *
+ * @param vector The approximation to subtract.
+ * @return The current object.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N>& FixedSolution<N>::operator-=(const FixedSolution<N>& vector)
+{
+	int lupe;
+	for(lupe=0;lupe<=N;++lupe)
+		solution[lupe] -= vector.solution[lupe];
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * Add another approximation to this one.
+ *
+ * @param vector The approximation to add.
+ * @return The current object.
+ * ************************************************************************ */
+template <int N>
+FixedSolution<N>& FixedSolution<N>::operator+=(const FixedSolution<N>& vector)
+{
+	int lupe;
+	for(lupe=0;lupe<=N;++lupe)
+		solution[lupe] += vector.solution[lupe];
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * The dot product of two approximations.
+ *
+ * @param v1 The first approximation.
+ * @param v2 The second approximation.
+ * @return The sum of the products of the entries.
+ * ************************************************************************ */
+template <int N>
+double FixedSolution<N>::dot(const FixedSolution<N>& v1,const FixedSolution<N>& v2)
+{
+	int lupe;
+	double dotProduct = 0.0;
+	for(lupe=0;lupe<=N;++lupe)
+		dotProduct += v1.solution[lupe]*v2.solution[lupe];
+	return(dotProduct);
+}
+
+
+/** ************************************************************************
+ * The l2 norm of an approximation.
+ *
+ * @param v1 The approximation.
+ * @return The square root of the dot product with itself.
+ * ************************************************************************ */
+template <int N>
+double FixedSolution<N>::norm(const FixedSolution<N>& v1)
+{
+	return(sqrt(dot(v1,v1)));
+}
+
+/** ************************************************************************
+ * The l2 norm of this approximation.
+ *
+ * @return The square root of the dot product with itself.
+ * ************************************************************************ */
+template <int N>
+double FixedSolution<N>::norm()
+{
+	return(sqrt(dot(*this,*this)));
+}
+
+
+/** ************************************************************************
+ * Add a multiple of another approximation to this one.
+ *
+ * @param vector The approximation to add.
+ * @param multiplier The scalar to multiply the other approximation by.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void FixedSolution<N>::axpy(FixedSolution<N>* vector,double multiplier)
+{
+	int lupe;
+	for(lupe=0;lupe<=N;++lupe)
+		solution[lupe] += multiplier*vector->solution[lupe];
+}
+
+
+#endif
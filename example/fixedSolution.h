@@ -0,0 +1,170 @@
+#ifndef FIXEDSOLUTIONCLASS
+#define FIXEDSOLUTIONCLASS
+
+
+/** *********************************************************************************
+ * @file fixedSolution.h
+ * @class FixedSolution
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of the approximation of a PDE when the number
+ * of grid points is known when the program is compiled.
+ *
+ * This is the definition (header) file for the FixedSolution
+ * class. It has the same methods as the Solution class that are used
+ * by the GMRES routine, but the values are kept in a std::array that
+ * is part of the object. No memory is allocated for a new vector, and
+ * every loop has a length that is known to the compiler so that it can
+ * be unrolled and vectorized. This is meant for small grids, where
+ * the time to allocate the memory and the overhead of the loops are a
+ * large part of the work.
+ *
+ *
+ * @brief header file for the fixed size approximation of a PDE.
+ *
+ * ********************************************************************************* */
+
+#include <array>
+#include <cstddef>
+
+template <int N>
+class FixedSolution
+{
+
+public:
+	FixedSolution(int size=N);               //< Default constructor for the class
+
+	// Now define the operators associated with the class.
+	FixedSolution& operator=(const double& value);          //< Assignment operator for assigning a single value to all elements.
+	FixedSolution& operator*=(const double& value);         //< Operator for scalar multiplication in place.
+	FixedSolution& operator-=(const FixedSolution& vector); //< Operator for subtracting another FixedSolution object.
+	FixedSolution& operator+=(const FixedSolution& vector); //< Operator for adding another FixedSolution object.
+
+	/** Definition of the dot product of two approximation vectors. */
+	static double dot (const FixedSolution& v1,const FixedSolution& v2);
+
+	/** Definition of the l2 norm of an approximation vector. */
+	static double norm(const FixedSolution& v1);
+	double norm();
+
+	/** Definition of the axpy procedure. */
+	void axpy(FixedSolution* vector,double multiplier);
+
+	/**
+		 The parenthesis operator for access to the data elements.
+
+		 @param row The entry in the vector.
+		 @return A reference to the entry.
+	*/
+	double& operator()(int row)
+	{
+		return(solution[row]);
+	}
+
+	/**
+	   Method to get the number of elements used for the approximation.
+
+	   @return The number of elements in the approximation.
+	*/
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+	   Method to get the value of the approximation at a certain grid point.
+
+	   @param row The grid point where you want the height of the function.
+	   @return The approximation at the given grid point.
+	*/
+	double getEntry(int row) const
+	{
+		return(solution[row]);
+	}
+
+	/**
+		 Method to set the value of the entry in a row of the solution.
+
+		 @param value The value to set the given row to.
+		 @param row The entry in the vector to change.
+		 @return N/A
+	*/
+	void setEntry(double value,int row)
+	{
+		solution[row] = value;
+	}
+
+	/**
+		 Method to get the values of the approximation as one block of
+		 memory.
+
+		 @return The first value in the block.
+	*/
+	double *data()
+	{
+		return(solution.data());
+	}
+
+	/**
+		 Method to get the values of the approximation as one block of
+		 memory that cannot be changed.
+
+		 @return The first value in the block.
+	*/
+	const double *data() const
+	{
+		return(solution.data());
+	}
+
+	/**
+		 Method to get the number of values in the block given by data().
+
+		 @return The number of values.
+	*/
+	std::size_t getSize() const
+	{
+		return(N+1);
+	}
+
+private:
+
+	std::array<double,N+1> solution;  //< The vector that contains the approximation.
+
+};
+
+
+#include "fixedSolution.cpp"
+
+
+#endif
@@ -0,0 +1,151 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+/* *********************************************************************************
+ *
+ * Solve the one dimensional example on small grids using the fixed
+ * size classes, and compare the results and the times with the
+ * Solution, Poisson, and Preconditioner classes. The sizes must be
+ * known when the program is compiled, so they are given in the main
+ * routine. Each system is solved a number of times and the average
+ * time for one solve is given.
+ *
+ * Usage: fixedSolver [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * One line of comma separated values is written for every size.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "fixedPoisson.h"
+#include "fixedSolution.h"
+#include "fixedPreconditioner.h"
+#include "../GMRES.h"
+#include "../options.h"
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// The number of times each system is solved to find the time.
+#define FIXEDREPEATS 2000
+
+
+/** ************************************************************************
+ * Solve the system with the fixed size classes and with the classes
+ * that are sized when the program is run. The number of iterations,
+ * the largest difference between the two approximations, the largest
+ * difference in the second derivative matrices, and the average time
+ * for one solve with each set of classes are written.
+ *
+ * @param options The parameters for the GMRES routine.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void compare(const SolverOptions &options)
+{
+	FixedPoisson<N> fixedOperator;
+	FixedPreconditioner<N> fixedPre;
+	FixedSolution<N> fixedX;
+	FixedSolution<N> fixedB;
+
+	Poisson elliptical(N);
+	Preconditioner pre(N);
+	Solution x(N);
+	Solution b(N);
+
+	// Use the same right hand side as the systemSolver example.
+	int lupe;
+	int innerLupe;
+	for(lupe=1;lupe<N;++lupe)
+		{
+			double xgrid = elliptical.getX(lupe);
+			b(lupe)      = 90.0*pow(xgrid,8.0)-2.0;
+			fixedB(lupe) = b(lupe);
+		}
+
+	double matrixDifference = 0.0;
+	for(lupe=0;lupe<=N;++lupe)
+		for(innerLupe=0;innerLupe<=N;++innerLupe)
+			matrixDifference = fmax(matrixDifference,
+															fabs(fixedOperator.getD2(lupe,innerLupe)-elliptical.getD2(lupe,innerLupe)));
+
+	int fixedIterations = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(lupe=0;lupe<FIXEDREPEATS;++lupe)
+		{
+			fixedX = 0.0;
+			fixedIterations = GMRES(&fixedOperator,&fixedX,&fixedB,&fixedPre,
+															options.getKrylovDimension(),options.getRestarts(),options.getTolerance());
+		}
+	double fixedTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	int iterations = 0;
+	start = std::chrono::steady_clock::now();
+	for(lupe=0;lupe<FIXEDREPEATS;++lupe)
+		{
+			x = 0.0;
+			iterations = GMRES(&elliptical,&x,&b,&pre,
+												 options.getKrylovDimension(),options.getRestarts(),options.getTolerance());
+		}
+	double time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	double difference = 0.0;
+	for(lupe=0;lupe<=N;++lupe)
+		difference = fmax(difference,fabs(x(lupe)-fixedX(lupe)));
+
+	std::cout << N << ","
+						<< fixedIterations << ","
+						<< iterations << ","
+						<< difference << ","
+						<< matrixDifference << ","
+						<< fixedTime/FIXEDREPEATS << ","
+						<< time/FIXEDREPEATS << std::endl;
+}
+
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(NUMBER,41,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+
+	std::cout << "N,fixed iterations,iterations,difference,matrix difference,fixed solve,solve" << std::endl;
+	compare<8>(options);
+	compare<16>(options);
+	compare<24>(options);
+	compare<32>(options);
+
+	return(0);
+}
@@ -0,0 +1,173 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+/* *********************************************************************************
+ *
+ * Solve a large number of small independent one dimensional problems
+ * using the BatchedGMRES class, and compare the results and the times
+ * with solving each problem on its own with the GMRES routine. Every
+ * problem has a different right hand side, so the problems converge
+ * after a different number of iterations. The problems are solved in
+ * groups of LOCKSTEPWIDTH, and the values of each group are
+ * interleaved.
+ *
+ * Usage: lockstepSolver [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * One line of comma separated values is written for every size.
+ *
+ * ********************************************************************************* */
+
+#include "fixedPoisson.h"
+#include "fixedSolution.h"
+#include "fixedPreconditioner.h"
+#include "../GMRES.h"
+#include "../batchedGMRES.h"
+#include "../options.h"
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// The number of problems that are solved together.
+#define LOCKSTEPWIDTH 8
+
+// The number of problems solved for every size.
+#define LOCKSTEPSYSTEMS 4096
+
+
+/** ************************************************************************
+ * The right hand side for one of the problems. It is the right hand
+ * side of the systemSolver example with a different multiple and
+ * frequency of a sine added for each problem.
+ *
+ * @param x The grid point.
+ * @param problem The number of the problem.
+ * @return The value of the right hand side.
+ * ************************************************************************ */
+double forcing(double x,int problem)
+{
+	return(90.0*pow(x,8.0)-2.0 + ((double)(problem%9))*sin(((double)(problem%13))*M_PI*x));
+}
+
+
+/** ************************************************************************
+ * Solve every problem on its own and in groups. The number of problems
+ * whose iteration counts differ, the largest difference between the
+ * approximations, and the time for every problem to be solved each
+ * way are written.
+ *
+ * @param options The parameters for the GMRES routine.
+ * @return N/A
+ * ************************************************************************ */
+template <int N>
+void compare(const SolverOptions &options)
+{
+	FixedPoisson<N> elliptical;
+	FixedPreconditioner<N> pre;
+	BatchedGMRES<double,LOCKSTEPWIDTH> batched(N+1,options.getKrylovDimension());
+	int groups = LOCKSTEPSYSTEMS/LOCKSTEPWIDTH;
+
+	// Define the interleaved right hand sides for every group.
+	std::vector<double> rhs((N+1)*LOCKSTEPSYSTEMS,0.0);
+	std::vector<double> x((N+1)*LOCKSTEPSYSTEMS,0.0);
+	int group;
+	int lane;
+	int lupe;
+	for(group=0;group<groups;++group)
+		for(lane=0;lane<LOCKSTEPWIDTH;++lane)
+			for(lupe=1;lupe<N;++lupe)
+				rhs[(group*(N+1)+lupe)*LOCKSTEPWIDTH+lane] =
+					forcing(elliptical.getX(lupe),group*LOCKSTEPWIDTH+lane);
+
+	// Solve each problem on its own.
+	std::vector<int> iterations(LOCKSTEPSYSTEMS);
+	std::vector<FixedSolution<N> > single(LOCKSTEPSYSTEMS,FixedSolution<N>());
+	FixedSolution<N> b;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(group=0;group<groups;++group)
+		for(lane=0;lane<LOCKSTEPWIDTH;++lane)
+			{
+				for(lupe=0;lupe<=N;++lupe)
+					b(lupe) = rhs[(group*(N+1)+lupe)*LOCKSTEPWIDTH+lane];
+				iterations[group*LOCKSTEPWIDTH+lane] =
+					GMRES(&elliptical,&single[group*LOCKSTEPWIDTH+lane],&b,&pre,
+								options.getKrylovDimension(),options.getRestarts(),options.getTolerance());
+			}
+	double time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	// Solve the problems in groups.
+	int mismatch = 0;
+	int converged = 0;
+	start = std::chrono::steady_clock::now();
+	for(group=0;group<groups;++group)
+		{
+			converged += batched.solve(&elliptical,&x[group*(N+1)*LOCKSTEPWIDTH],
+																 &rhs[group*(N+1)*LOCKSTEPWIDTH],&pre,
+																 options.getRestarts(),options.getTolerance());
+			for(lane=0;lane<LOCKSTEPWIDTH;++lane)
+				mismatch += (batched.getIterations(lane) != iterations[group*LOCKSTEPWIDTH+lane]) ? 1 : 0;
+		}
+	double batchedTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	double difference = 0.0;
+	for(group=0;group<groups;++group)
+		for(lane=0;lane<LOCKSTEPWIDTH;++lane)
+			for(lupe=0;lupe<=N;++lupe)
+				difference = fmax(difference,
+													fabs(x[(group*(N+1)+lupe)*LOCKSTEPWIDTH+lane]
+															 -single[group*LOCKSTEPWIDTH+lane](lupe)));
+
+	std::cout << N << ","
+						<< LOCKSTEPSYSTEMS << ","
+						<< converged << ","
+						<< mismatch << ","
+						<< difference << ","
+						<< batchedTime << ","
+						<< time << std::endl;
+}
+
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(32,41,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+
+	std::cout << "N,systems,converged,iteration mismatches,difference,batched solve,solve" << std::endl;
+	compare<8>(options);
+	compare<16>(options);
+	compare<24>(options);
+	compare<32>(options);
+
+	return(0);
+}
@@ -58,6 +58,9 @@
 #define NUMBER 64
 #endif
 
+#include <memory>
+#include "../chebyshev.h"
+
 class Solution;
 
 class Poisson
@@ -69,8 +72,9 @@ public:
 	~Poisson();                        //< Destructor for the Poisson Class.
 
 	// Basic algebraic operators associated with the linearization of the operator.
-	double& operator()(int row,int column);     //< The value of the linearization for the operator at a given row and column.
+	double operator()(int row,int column) const; //< The value of the linearization for the operator at a given row and column.
 	Solution operator*(class Solution vector);  //< The linearized operator acting on a given Solution.
+	void apply(const Solution& vector,Solution& result); //< The linearized operator written into an existing Solution.
 
 	
 	/**
@@ -81,7 +85,7 @@ public:
 	 */
 	double getX(int row) const
 	{
-		return(x[row]);
+		return(matrices->getNodes()(row));
 	}
 
 	/**
@@ -103,7 +107,7 @@ public:
 	 */
 	double getD1(int row,int col) const
 	{
-		return(d1[row][col]);
+		return(matrices->getFirst()(row,col));
 	}
 
 
@@ -116,26 +120,16 @@ public:
 	 */
 	double getD2(int row,int col) const
 	{
-		return(d2[row][col]);
+		return(matrices->getSecond()(row,col));
 	}
 
-protected:
-
-	// Define the routines that initialize the first and second
-	// derivative matrices.
-	void cheby1(double **deriv,double *x,int num);   //< Method to define the first derivative matrix
-	void cheby2(double **deriv,double *x,int num);   //< Method to define the second derivative matrix
-
-
 private:
 
-	// Define the resolution of the approximation. Also define the
-	// first derivative matrix (d) and the second derivative matrix
-	// (d2). The grid points are given by x.
+	// Define the resolution of the approximation. The grid points and
+	// the first and second derivative matrices are shared with every
+	// other operator of the same size.
 	int N;        //< The number of grid points in the approximation.
-	double **d1;  //< Pointer to the first derivative matrix.
-	double **d2;  //< Pointer to the second derivative matrix.
-	double *x;    //< Pointer to the set of x grid points
+	std::shared_ptr<const ChebyshevMatrices<double> > matrices;  //< The grid points and derivative matrices.
 
 
 };
@@ -67,15 +67,23 @@
 Preconditioner::Preconditioner(int number)
 {
 	setN(number);
-	// allocate the vector with the lower diagonal matrix entries for
-	// the Cholesky decomposition of the second order finite
-	// difference operator for the same equation.
-	vector = ArrayUtils<double>::twotensor(number+1,2);
-
 	// Allocate the vector required to keep the intermediate results
 	// of the solver when doing the backwards and forward solve from
 	// the Cholesky decomposition.
-	intermediate = ArrayUtils<double>::onetensor(number+1);
+	intermediate = Tensor<double,1>(number+1);
+
+	// Use the decomposition in the file if there is one for this
+	// size. The decomposition does not depend on the grid.
+	std::string fileName = MatrixStore::fileName("cholesky",number,0);
+	if(store.open(fileName,number,0) &&
+		 store.find("cholesky",vector) && (vector.getExtent(0)==number+1))
+		return;
+	store.close();
+
+	// allocate the vector with the lower diagonal matrix entries for
+	// the Cholesky decomposition of the second order finite
+	// difference operator for the same equation.
+	vector = Tensor<double,2>(number+1,2);
 
 	// Define the values for the Cholesky decomposition of the finite
 	// difference operator. This is the Cholesky decomposition of the
@@ -86,15 +94,22 @@ Preconditioner::Preconditioner(int number)
 	double r = 2.0 + m;
 	for(lupe=0;lupe<=number;++lupe)
 		{
-			vector[lupe][0] = sqrt(r);
+			vector(lupe,0) = sqrt(r);
 			r = (r*(2+m)-1)/r;
 		}
 
 	for(lupe=1;lupe<=number;++lupe)
 		{
-			vector[lupe][1] = -1.0/vector[lupe-1][0];
+			vector(lupe,1) = -1.0/vector(lupe-1,0);
 		}
 
+	// Save the decomposition so that the next process can map it.
+	if(!fileName.empty())
+		{
+			MatrixStore output;
+			output.add("cholesky",vector);
+			output.save(fileName,number,0);
+		}
 }
 
 
@@ -106,16 +121,10 @@ Preconditioner::Preconditioner(int number)
 Preconditioner::Preconditioner(const Preconditioner& oldCopy)
 {
 	setN(oldCopy.getN());
-	// Allocate the vector for the preconditioner, and copy it over.
-	vector = ArrayUtils<double>::twotensor(getN()+1,2);
-	intermediate = ArrayUtils<double>::onetensor(getN()+1);
-
-	int lupe;
-	for(lupe=getN();lupe>=0;--lupe)
-		{
-			vector[lupe][0] = oldCopy.getValue(lupe,0);
-			vector[lupe][1] = oldCopy.getValue(lupe,1);
-		}
+	// Copy the vector for the preconditioner, and allocate the
+	// scratch space. A copy of a view of a file owns its own memory.
+	vector = oldCopy.vector;
+	intermediate = Tensor<double,1>(getN()+1);
 }
 
 /** ************************************************************************
@@ -123,8 +132,7 @@ Preconditioner::Preconditioner(const Preconditioner& oldCopy)
  *  ************************************************************************ */
 Preconditioner::~Preconditioner()
 {
-	ArrayUtils<double>::deltwotensor(vector);
-	ArrayUtils<double>::delonetensor(intermediate);
+	// The memory is released by the Tensor class.
 }
 
 /** ************************************************************************
@@ -141,29 +149,47 @@ Preconditioner::~Preconditioner()
  * ************************************************************************ */
 Solution Preconditioner::solve(const Solution &current)
 {
-	Solution multiplied(current);
+	Solution multiplied(current.getN());
+	solveInto(current,multiplied);
+	return(multiplied);
+}
+
 
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner and write the result into an existing object.
+ * 
+ * Performs the same solve as the solve method, but the result is
+ * written into the Solution object passed to it, and no new memory is
+ * allocated. The result must be a different object than the right
+ * hand side.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @param multiplied The Solution object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+void Preconditioner::solveInto(const Solution &current,Solution &multiplied)
+{
 	// Perform the forward solve to invert the first part of the
 	// Cholesky decomposition.
 	int lupe;
-	intermediate[0] = current.getEntry(0)/vector[0][0];
+	intermediate(0) = current.getEntry(0)/vector(0,0);
 	for(lupe=1;lupe<=getN();++lupe)
-		intermediate[lupe] = 
-			(current.getEntry(lupe)-vector[lupe][1]*intermediate[lupe-1])
-			/vector[lupe][0];
+		intermediate(lupe) = 
+			(current.getEntry(lupe)-vector(lupe,1)*intermediate(lupe-1))
+			/vector(lupe,0);
 
 	// Perform the backwards solve for the Cholesky decomposition.
-	multiplied(getN()) = intermediate[getN()]/vector[getN()][0];
+	multiplied(getN()) = intermediate(getN())/vector(getN(),0);
 	for(lupe=getN()-1;lupe>=0;--lupe)
-		multiplied(lupe) = (intermediate[lupe]-multiplied(lupe+1)*vector[lupe+1][1])
-			/vector[lupe][0];
+		multiplied(lupe) = (intermediate(lupe)-multiplied(lupe+1)*vector(lupe+1,1))
+			/vector(lupe,0);
 
 	// The previous solves wiped out the boundary conditions. Restore
 	// the left and right boundaru condition before sending the result
 	// back.
 	multiplied(0) = current.getEntry(0);
 	multiplied(getN()) = current.getEntry(getN());
-	return(multiplied);
 }
 
 
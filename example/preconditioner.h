@@ -57,6 +57,9 @@
 #define NUMBER 64
 #endif
 
+#include "../tensor.h"
+#include "../store.h"
+
 class Solution;
 
 class Preconditioner
@@ -70,6 +73,7 @@ public:
 	Solution solve(const Solution &vector);    //< Method to solve the
                                                    //< system associated with
                                                    //< the preconditioner.
+	void solveInto(const Solution &vector,Solution &multiplied); //< Solve the system and write the result into an existing Solution.
 
 	
 	/**
@@ -102,7 +106,7 @@ public:
 	 */
 	double getValue(int row,int col) const
 	{
-		return(vector[row][col]);
+		return(vector(row,col));
 	}
 
 
@@ -112,10 +116,11 @@ protected:
 private:
 
 	int N;                //< The number of grid points associated with the approximation.
-	double **vector;      //< The vector that has the reciprocol of the diagonal entries
+	Tensor<double,2> vector;        //< The vector that has the reciprocol of the diagonal entries
                               //< of the operator.
-	double *intermediate; //< Vector used for the intermediate results
+	Tensor<double,1> intermediate;  //< Vector used for the intermediate results
                               //< in the backwards solve for inverting the preconditioner.
+	MatrixStore store;              //< The mapped file when the factors are a view of a file.
 
 };
 
@@ -0,0 +1,174 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+/* *********************************************************************************
+ *
+ * Solve a large number of independent one dimensional problems with a
+ * SolveQueue. The problems cycle through a list of grid sizes, so the
+ * number of iterations and the time for each solve differ. The
+ * problems are solved first with one worker and then with one worker
+ * for every processor. Each set is solved twice, and the second pass
+ * shows the number of blocks taken from the system once the memory
+ * pools hold the space for a solve.
+ *
+ * Usage: queueSolver [-n N[,N...]] [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * One line of comma separated values is written for every number of workers.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "../GMRES.h"
+#include "../pool.h"
+#include "../options.h"
+#include "../solveQueue.h"
+
+#include <iostream>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <cmath>
+
+// The number of problems that are solved.
+#define QUEUESOLVES 1000
+
+
+/** ************************************************************************
+ * Submit every problem to the queue and wait for the results.
+ *
+ * @param queue The queue that runs the solves.
+ * @param operators The operator for each size.
+ * @param preconditioners The preconditioner for each size.
+ * @param rhs The right hand side for each size.
+ * @param expected The number of iterations for each size.
+ * @param options The parameters for the GMRES routine.
+ * @return The number of solves whose iterations differ from the expected number.
+ * ************************************************************************ */
+int solveAll(SolveQueue &queue,
+						 std::vector<std::unique_ptr<Poisson> > &operators,
+						 std::vector<std::unique_ptr<Preconditioner> > &preconditioners,
+						 std::vector<std::unique_ptr<Solution> > &rhs,
+						 const std::vector<int> &expected,
+						 const SolverOptions &options)
+{
+	int sizes = (int)operators.size();
+	std::vector<std::future<SolveResult<Solution> > > results;
+	results.reserve(QUEUESOLVES);
+
+	int lupe;
+	for(lupe=0;lupe<QUEUESOLVES;++lupe)
+		{
+			int which = lupe%sizes;
+			Solution initial(operators[which]->getN());
+			results.push_back(queue.solve(operators[which].get(),initial,*rhs[which],
+																		preconditioners[which].get(),
+																		options.getKrylovDimension(),options.getRestarts(),options.getTolerance()));
+		}
+
+	int mismatch = 0;
+	for(lupe=0;lupe<QUEUESOLVES;++lupe)
+		if(results[lupe].get().iterations != expected[lupe%sizes])
+			mismatch += 1;
+	return(mismatch);
+}
+
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(32,41,10,1.0E-8);
+	int defaults[] = {16,24,32,48,64};
+	options.setSizes(std::vector<int>(defaults,defaults+5));
+	if(!options.parse(argc,argv))
+		return(2);
+
+	// Define the operator, preconditioner, and right hand side for
+	// every size, and solve each one once to get the number of
+	// iterations.
+	std::vector<std::unique_ptr<Poisson> > operators;
+	std::vector<std::unique_ptr<Preconditioner> > preconditioners;
+	std::vector<std::unique_ptr<Solution> > rhs;
+	std::vector<int> expected;
+	std::vector<int>::const_iterator size;
+	for(size=options.getSizes().begin();size!=options.getSizes().end();++size)
+		{
+			int number = *size;
+			operators.push_back(std::unique_ptr<Poisson>(new Poisson(number)));
+			preconditioners.push_back(std::unique_ptr<Preconditioner>(new Preconditioner(number)));
+			rhs.push_back(std::unique_ptr<Solution>(new Solution(number)));
+
+			int lupe;
+			for(lupe=1;lupe<number;++lupe)
+				{
+					double xgrid = operators.back()->getX(lupe);
+					(*rhs.back())(lupe) = 90.0*pow(xgrid,8.0)-2.0;
+				}
+
+			Solution x(number);
+			expected.push_back(GMRES(operators.back().get(),&x,rhs.back().get(),preconditioners.back().get(),
+															 options.getKrylovDimension(),options.getRestarts(),options.getTolerance()));
+		}
+
+	std::cout << "workers,solves,time,speedup,steals,system allocations,mismatches" << std::endl;
+	double serial = 0.0;
+	int workers[] = {1,0};
+	int lupe;
+	for(lupe=0;lupe<2;++lupe)
+		{
+			// The inputs and the results are copied by this thread, and
+			// they use a pool as well.
+			MemoryPoolScope scope;
+			SolveQueue queue(workers[lupe]);
+			solveAll(queue,operators,preconditioners,rhs,expected,options);
+
+			unsigned long systemCalls = MemoryPool::getTotalSystemAllocations();
+			unsigned long steals = queue.getSteals();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			int mismatch = solveAll(queue,operators,preconditioners,rhs,expected,options);
+			double time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+			systemCalls = MemoryPool::getTotalSystemAllocations()-systemCalls;
+			if(lupe==0)
+				serial = time;
+
+			std::cout << queue.getWorkers() << ","
+								<< QUEUESOLVES << ","
+								<< time << ","
+								<< serial/time << ","
+								<< queue.getSteals()-steals << ","
+								<< systemCalls << ","
+								<< mismatch << std::endl;
+		}
+
+	return(0);
+}
@@ -29,13 +29,18 @@
  * ********************************************************************************* */
 
 
-#define NUMBER 64
 #include "poisson.h"
 #include "solution.h"
 #include "preconditioner.h"
 #include "../GMRES.h"
+#include "../pool.h"
+#include "../monitor.h"
+#include "../counters.h"
+#include "../trace.h"
+#include "../options.h"
 
 #include <iostream>
+#include <fstream>
 #include <cmath>
 
 #define DERIVPOWER 50.0
@@ -43,18 +48,24 @@
 int main(int argc,char **argv)
 {
 
-    Poisson *elliptical = new Poisson;   // The operator to invert.
-	Solution *x = new Solution(NUMBER);  // The approximation to calculate.
-	Solution *b = new Solution(NUMBER);  // The forcing function for the r.h.s.
+	// Read the number of grid points and the parameters for the solver.
+	SolverOptions options(NUMBER,41,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+	int number = options.getNumber();   // The number of grid points.
+
+    Poisson *elliptical = new Poisson(number); // The operator to invert.
+	Solution *x = new Solution(number);  // The approximation to calculate.
+	Solution *b = new Solution(number);  // The forcing function for the r.h.s.
 	Preconditioner *pre = 
-		new Preconditioner(NUMBER);      // The preconditioner for the system.
+		new Preconditioner(number);      // The preconditioner for the system.
 
-	int restart = 10;                    // Number of restarts to allow
-	int krylovDim = 41;                  // Dimension of the Krylov subspace
-	double tol = 1.0E-8;                 // How close to make the approximation.
+	int restart = options.getRestarts(); // Number of restarts to allow
+	int krylovDim = options.getKrylovDimension(); // Dimension of the Krylov subspace
+	double tol = options.getTolerance(); // How close to make the approximation.
 
 	int lupe;
-	for(lupe=0;lupe<=NUMBER;++lupe)
+	for(lupe=0;lupe<=number;++lupe)
 		{
 			// initialize the r.h.s to be something we know the
 			// solution for. Also, set the initial approximation if
@@ -67,16 +78,69 @@ int main(int argc,char **argv)
 
 	// Set the boundary conditions separately.
 	(*b)(0) = 0.0;
-	(*b)(NUMBER) = -0.0;
+	(*b)(number) = -0.0;
 
-	// Find an approximation to the system!
-	int result= GMRES(elliptical,x,b,pre,krylovDim,restart,tol);
+	// Find an approximation to the system! The temporary vectors used
+	// within the solve are drawn from a pool that is released at the
+	// end of the solve. The monitor keeps the time spent in each phase
+	// and reads the hardware counters if they are available. The flops
+	// are given for the phases where they are known.
+	CounterMonitor monitor;
+	monitor.setFlops(MONITORAPPLY,2.0*(number-1)*(number+1));
+	monitor.setFlops(MONITORPRECONDITION,6.0*(number+1));
+	int result;
+	unsigned long poolRequests;
+	unsigned long poolFresh;
+	unsigned long systemCalls = MemoryPool::getTotalSystemAllocations();
+	{
+		MemoryPoolScope scope;
+		result       = GMRES(elliptical,x,b,pre,krylovDim,restart,tol,monitor);
+		poolRequests = scope.getPool()->getRequests();
+		poolFresh    = scope.getPool()->getFresh();
+	}
+	systemCalls = MemoryPool::getTotalSystemAllocations()-systemCalls;
 
 	std::cout << "Iterations: " << result << " residual: " << tol << std::endl;
+	std::cout << "Allocations: " << poolRequests << " from the pool, "
+			  << poolFresh << " new blocks, " << systemCalls << " system calls" << std::endl;
+
+	const SolveReport &report = monitor.getReport();
+	std::cout << "Restarts: " << report.restarts << " relative residual: " << report.residual
+			  << " time: " << report.totalSeconds << " s" << std::endl;
+	int phase;
+	for(phase=0;phase<MONITORPHASES;++phase)
+		std::cout << "  " << SolveReport::phaseName(phase) << ": " << report.seconds[phase] << " s, "
+				  << report.cycles[phase] << " cycles, " << report.calls[phase] << " calls" << std::endl;
+
+	if(monitor.getCounters().isAvailable())
+		for(phase=0;phase<MONITORPHASES;++phase)
+			std::cout << "  " << SolveReport::phaseName(phase) << ": IPC " << monitor.instructionsPerCycle(phase)
+					  << ", LLC misses " << monitor.getCount(phase,COUNTERCACHEMISSES)
+					  << ", estimated bytes/flop " << monitor.bytesPerFlop(phase) << std::endl;
+	else
+		std::cout << "Performance counters are not available." << std::endl;
+
+	// If a file name is given, solve the system again from zero and
+	// write a timeline of every phase that can be opened in a trace
+	// viewer.
+	if(!options.getTraceFile().empty())
+		{
+			Tracer tracer;
+			TraceMonitor tracing(tracer);
+			Solution traced(number);
+			traced = 0.0;
+			{
+				MemoryPoolScope scope;
+				GMRES(elliptical,&traced,b,pre,krylovDim,restart,tol,tracing);
+			}
+			std::ofstream traceFile(options.getTraceFile().c_str());
+			tracer.writeJSON(traceFile);
+			std::cout << "Trace: " << options.getTraceFile() << ", " << tracer.getDropped() << " events dropped" << std::endl;
+		}
 #define SOLUTION
 #ifdef SOLUTION
 //std::cout << "x,approx,true," << result << std::endl;
-	for(lupe=0;lupe<=NUMBER;++lupe)
+	for(lupe=0;lupe<=number;++lupe)
 		{
 			//if(lupe%5 == 0)
 			//	std::cout << std::endl;
@@ -91,13 +155,13 @@ int main(int argc,char **argv)
 #endif
 
 	/*
-	for(lupe=0;lupe<=NUMBER;++lupe)
+	for(lupe=0;lupe<=number;++lupe)
 		{
 			double xgrid = elliptical.getX(lupe);
 			b(lupe) = pow(xgrid,60.0);
 		}
 	y = elliptical*b;
-	for(lupe=0;lupe<=NUMBER;++lupe)
+	for(lupe=0;lupe<=number;++lupe)
 		{
 			if(lupe%5 == 0)
 				std::cout << std::endl;
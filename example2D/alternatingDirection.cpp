@@ -0,0 +1,480 @@
+
+/** *********************************************************************************
+ *
+ * @file alternatingDirection.cpp
+ * @class AlternatingDirection
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of an alternating direction implicit (ADI)
+ * preconditioner for the linearized operator associated with a PDE.
+ *
+ * This is the source file for the AlternatingDirection class. It
+ * includes the routines to define the finite difference operator on
+ * the Chebyshev grid, the Cholesky decompositions for every shift,
+ * the optimal shifts, and the Peaceman-Rachford sweeps.
+ *
+ *
+ * @brief Basic operations associated with the ADI preconditioner.
+ *
+ * ********************************************************************************* */
+
+
+
+
+#include "alternatingDirection.h"
+#include "solution.h"
+#include "../util.h"
+#include "../trace.h"
+
+#include <cmath>
+
+
+/** ************************************************************************
+ * Base constructor  for the AlternatingDirection class.
+ *
+ *
+ * @param number The number of grid points used in the approximation.
+ * @param numberSteps The number of Peaceman-Rachford steps for each solve.
+ * ************************************************************************ */
+AlternatingDirection::AlternatingDirection(int number,int numberSteps)
+{
+	N = number;
+	steps = numberSteps;
+
+	// Allocate the space for the one dimensional operator and the
+	// Cholesky decomposition for every shift.
+	shift   = ArrayUtils<double>::onetensor(steps);
+	weight  = ArrayUtils<double>::onetensor(N+1);
+	upper   = ArrayUtils<double>::onetensor(N+1);
+	centre  = ArrayUtils<double>::onetensor(N+1);
+
+	// Allocate the space used in the sweeps. The boundary entries are
+	// never written and remain zero.
+	rhs     = ArrayUtils<double>::twotensor(N+1,N+1);
+	iterate = ArrayUtils<double>::twotensor(N+1,N+1);
+	half    = ArrayUtils<double>::twotensor(N+1,N+1);
+	lines   = ArrayUtils<double>::twotensor(N+1,N+1);
+
+	int lupe;
+	for(lupe=0;lupe<steps;++lupe)
+		factors.push_back(new BatchedTridiagonal<double>(N-1));
+
+	defineDifferences();
+	defineBounds();
+	defineShifts();
+
+	for(lupe=0;lupe<steps;++lupe)
+		factor(factors[lupe],shift[lupe]);
+}
+
+
+/** ************************************************************************
+ *	Copy constructor  for the AlternatingDirection class.
+ *
+ *	@param oldCopy The AlternatingDirection class member to make a copy of.
+ * ************************************************************************ */
+AlternatingDirection::AlternatingDirection(const AlternatingDirection& oldCopy)
+{
+	N = oldCopy.getN();
+	steps = oldCopy.getSteps();
+	lowerBound = oldCopy.getLowerBound();
+	upperBound = oldCopy.getUpperBound();
+
+	shift   = ArrayUtils<double>::onetensor(steps);
+	weight  = ArrayUtils<double>::onetensor(N+1);
+	upper   = ArrayUtils<double>::onetensor(N+1);
+	centre  = ArrayUtils<double>::onetensor(N+1);
+	rhs     = ArrayUtils<double>::twotensor(N+1,N+1);
+	iterate = ArrayUtils<double>::twotensor(N+1,N+1);
+	half    = ArrayUtils<double>::twotensor(N+1,N+1);
+	lines   = ArrayUtils<double>::twotensor(N+1,N+1);
+
+	// The finite difference operator is cheap to define. Copy the
+	// shifts and the decompositions.
+	defineDifferences();
+	int lupe;
+	for(lupe=0;lupe<steps;++lupe)
+		{
+			shift[lupe] = oldCopy.getShift(lupe);
+			factors.push_back(new BatchedTridiagonal<double>(*oldCopy.factors[lupe]));
+		}
+}
+
+/** ************************************************************************
+ *	Destructor for the AlternatingDirection class.
+ *  ************************************************************************ */
+AlternatingDirection::~AlternatingDirection()
+{
+	ArrayUtils<double>::delonetensor(shift);
+	ArrayUtils<double>::delonetensor(weight);
+	ArrayUtils<double>::delonetensor(upper);
+	ArrayUtils<double>::delonetensor(centre);
+	int lupe;
+	for(lupe=0;lupe<steps;++lupe)
+		delete factors[lupe];
+	ArrayUtils<double>::deltwotensor(rhs);
+	ArrayUtils<double>::deltwotensor(iterate);
+	ArrayUtils<double>::deltwotensor(half);
+	ArrayUtils<double>::deltwotensor(lines);
+}
+
+
+/** ************************************************************************
+ * Define the second order finite difference operator on the Chebyshev grid.
+ *
+ * The approximation to -u'' at the grid point x_i is
+ *   2/(h_{i-1}+h_i) ( (u_i-u_{i+1})/h_i + (u_i-u_{i-1})/h_{i-1} )
+ * where h_i = x_i - x_{i+1}. This is written as W^{-1} S u where W is
+ * diagonal with entries (h_{i-1}+h_i)/2 and S is symmetric and
+ * positive definite. The upper vector holds the coupling between the
+ * points i and i+1.
+ *
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::defineDifferences()
+{
+	int lupe;
+	double xnum = (double)N;
+	double h;
+	double previous = 0.0;
+
+	for(lupe=0;lupe<N;++lupe)
+		{
+			h = cos(M_PI*((double)lupe)/xnum) - cos(M_PI*((double)(lupe+1))/xnum);
+			upper[lupe] = -1.0/h;
+			if(lupe > 0)
+				{
+					weight[lupe] = 0.5*(previous+h);
+					centre[lupe] = 1.0/previous + 1.0/h;
+				}
+			previous = h;
+		}
+}
+
+
+/** ************************************************************************
+ * Find the Cholesky decomposition of the matrix S + rho W.
+ *
+ * Only the interior points, 1 through N-1, are used so row k of the
+ * decomposition corresponds to the grid point k+1.
+ *
+ * @param cholesky The space for the decomposition.
+ * @param rho The shift to use.
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::factor(BatchedTridiagonal<double> *cholesky,double rho)
+{
+	int lupe;
+	double *diagonal = lines[0];
+	double *offDiagonal = lines[1];
+	for(lupe=1;lupe<N;++lupe)
+		{
+			diagonal[lupe-1] = centre[lupe]+rho*weight[lupe];
+			offDiagonal[lupe-1] = upper[lupe];
+		}
+	cholesky->factor(diagonal,offDiagonal);
+
+	for(lupe=0;lupe<=N;++lupe)
+		diagonal[lupe] = offDiagonal[lupe] = 0.0;
+}
+
+
+/** ************************************************************************
+ * Find the bounds for the eigenvalues of W^{-1} S.
+ *
+ * The smallest eigenvalue is found using inverse iteration with the
+ * unshifted Cholesky decomposition. The upper bound comes from the
+ * Gershgorin circles.
+ *
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::defineBounds()
+{
+	int lupe;
+	int iteration;
+	double *x = lines[2];
+	double *y = lines[3];
+	double numerator;
+	double denominator;
+
+	// Use the space for the first decomposition to find the
+	// smallest eigenvalue.
+	factor(factors[0],0.0);
+	for(lupe=1;lupe<N;++lupe)
+		x[lupe] = 1.0;
+
+	lowerBound = 1.0;
+	for(iteration=0;iteration<30;++iteration)
+		{
+			// Solve S y = W x and then use the Rayleigh quotient
+			// y'Sy/y'Wy = y'Wx/y'Wy.
+			for(lupe=1;lupe<N;++lupe)
+				y[lupe] = weight[lupe]*x[lupe];
+			factors[0]->solve(y+1,1,1);
+
+			numerator = 0.0;
+			denominator = 0.0;
+			for(lupe=1;lupe<N;++lupe)
+				{
+					numerator   += y[lupe]*weight[lupe]*x[lupe];
+					denominator += y[lupe]*weight[lupe]*y[lupe];
+				}
+			lowerBound = numerator/denominator;
+
+			denominator = 1.0/sqrt(denominator);
+			for(lupe=1;lupe<N;++lupe)
+				x[lupe] = y[lupe]*denominator;
+		}
+
+	upperBound = lowerBound;
+	for(lupe=1;lupe<N;++lupe)
+		{
+			double bound = (centre[lupe] + fabs(upper[lupe-1]) + fabs(upper[lupe]))/weight[lupe];
+			if(bound > upperBound)
+				upperBound = bound;
+		}
+
+	for(lupe=0;lupe<=N;++lupe)
+		x[lupe] = y[lupe] = 0.0;
+}
+
+
+/** ************************************************************************
+ * Find the optimal Peaceman-Rachford shifts.
+ *
+ * For a spectrum in [a,b] Wachspress showed that the optimal shifts
+ * for J steps are b dn((2j-1)K/(2J),k), j=1..J, where dn is the Jacobi
+ * elliptic function with modulus k = sqrt(1-(a/b)^2) and K is the
+ * complete elliptic integral of the first kind. Both are found using
+ * the arithmetic-geometric mean (Abramowitz and Stegun 16.4).
+ *
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::defineShifts()
+{
+	double ratio = lowerBound/upperBound;
+	double a[32];
+	double c[32];
+	double b = ratio;
+	double tmp;
+	int levels = 0;
+
+	// Perform the arithmetic-geometric mean.
+	a[0] = 1.0;
+	c[0] = sqrt(1.0-ratio*ratio);
+	while((fabs(c[levels]) > 1.0E-15) && (levels < 31))
+		{
+			a[levels+1] = 0.5*(a[levels]+b);
+			c[levels+1] = 0.5*(a[levels]-b);
+			b = sqrt(a[levels]*b);
+			levels += 1;
+		}
+	double quarterPeriod = M_PI/(2.0*a[levels]);
+
+	int lupe;
+	int level;
+	for(lupe=0;lupe<steps;++lupe)
+		{
+			// Find the amplitude with the descending recursion and
+			// then the value of dn.
+			double u = ((double)(2*lupe+1))*quarterPeriod/((double)(2*steps));
+			double phi = ldexp(a[levels]*u,levels);
+			double previous = phi;
+			for(level=levels;level>0;--level)
+				{
+					previous = phi;
+					tmp = c[level]/a[level]*sin(phi);
+					phi = 0.5*(phi + asin(tmp));
+				}
+			shift[lupe] = upperBound*cos(phi)/cos(previous-phi);
+		}
+}
+
+
+/** ************************************************************************
+ * Perform the first half of a Peaceman-Rachford step.
+ *
+ * Solves (H + rho I) v = f - (V - rho I) u, where H is the operator in
+ * the first index and V is the operator in the second index. Each
+ * column is an independent tridiagonal system. Entry row of column
+ * col is at half[row][col] so the columns are already interleaved,
+ * and they are solved in place.
+ *
+ * @param step The Peaceman-Rachford step which determines the shift.
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::sweepColumns(int step)
+{
+	double rho = shift[step];
+	int row;
+	int col;
+
+	Tracer *tracer = Tracer::active();
+#pragma omp parallel private(col)
+	{
+		TraceSpan span(tracer,"sweep columns");
+#pragma omp for
+		for(row=1;row<N;++row)
+			{
+				double explicitPart;
+				for(col=1;col<N;++col)
+					{
+						explicitPart = (centre[col]*iterate[row][col] + upper[col-1]*iterate[row][col-1]
+										+ upper[col]*iterate[row][col+1])/weight[col];
+						half[row][col] = weight[row]*(rhs[row][col] - explicitPart + rho*iterate[row][col]);
+					}
+			}
+	}
+
+	factors[step]->solve(&half[1][1],N+1,N-1);
+}
+
+
+/** ************************************************************************
+ * Perform the second half of a Peaceman-Rachford step.
+ *
+ * Solves (V + rho I) u = f - (H - rho I) v, where H is the operator in
+ * the first index and V is the operator in the second index. Each
+ * row is an independent tridiagonal system. The right hand sides are
+ * transposed into the scratch space so that they are interleaved.
+ *
+ * @param step The Peaceman-Rachford step which determines the shift.
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::sweepRows(int step)
+{
+	double rho = shift[step];
+	int row;
+	int col;
+
+	Tracer *tracer = Tracer::active();
+#pragma omp parallel private(row)
+	{
+		TraceSpan span(tracer,"sweep rows");
+#pragma omp for
+		for(col=1;col<N;++col)
+			{
+				double explicitPart;
+				for(row=1;row<N;++row)
+					{
+						explicitPart = (centre[row]*half[row][col] + upper[row-1]*half[row-1][col]
+										+ upper[row]*half[row+1][col])/weight[row];
+						lines[col][row] = weight[col]*(rhs[row][col] - explicitPart + rho*half[row][col]);
+					}
+			}
+	}
+
+	factors[step]->solve(&lines[1][1],N+1,N-1);
+
+#pragma omp parallel private(col)
+	{
+		TraceSpan span(tracer,"transpose rows");
+#pragma omp for
+		for(row=1;row<N;++row)
+			for(col=1;col<N;++col)
+				iterate[row][col] = lines[col][row];
+	}
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner.
+ *
+ * The boundary values are left as they are. On the interior a fixed
+ * number of Peaceman-Rachford steps, starting from zero, are used to
+ * approximate the inverse of the finite difference operator. Since
+ * the finite difference operator approximates -u_xx-u_yy the sign of
+ * the right hand side is changed.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @return A Solution class member that is the solution to the
+ *         preconditioned system.
+ * ************************************************************************ */
+Solution AlternatingDirection::solve(const Solution &current)
+{
+	Solution multiplied(current.getN());
+	solveInto(current,multiplied);
+	return(multiplied);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner and write the result into an existing object.
+ *
+ * Performs the same solve as the solve method, but the result is
+ * written into the Solution object passed to it, and no new memory is
+ * allocated. The result must be a different object than the right
+ * hand side.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @param multiplied The Solution object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+void AlternatingDirection::solveInto(const Solution &current,Solution &multiplied)
+{
+	int row;
+	int col;
+	int lupe;
+
+	for(row=1;row<N;++row)
+		for(col=1;col<N;++col)
+			{
+				rhs[row][col] = -current.getEntry(row,col);
+				iterate[row][col] = 0.0;
+			}
+
+	for(lupe=0;lupe<steps;++lupe)
+		{
+			sweepColumns(lupe);
+			sweepRows(lupe);
+		}
+
+	for(row=1;row<N;++row)
+		for(col=1;col<N;++col)
+			multiplied(row,col) = iterate[row][col];
+
+	// The boundary values are passed through unchanged.
+	for(col=0;col<=N;++col)
+		{
+			multiplied(0,col) = current.getEntry(0,col);
+			multiplied(N,col) = current.getEntry(N,col);
+		}
+	for(row=1;row<N;++row)
+		{
+			multiplied(row,0) = current.getEntry(row,0);
+			multiplied(row,N) = current.getEntry(row,N);
+		}
+}
@@ -0,0 +1,171 @@
+#ifndef ALTERNATINGDIRECTIONCLASS
+#define ALTERNATINGDIRECTIONCLASS
+
+
+/** *********************************************************************************
+ * @file alternatingDirection.h
+ * @class AlternatingDirection
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of an alternating direction implicit (ADI)
+ * preconditioner for the linearized operator associated with a PDE.
+ *
+ * This is the definition (header) file for the AlternatingDirection
+ * class. The preconditioner approximates the inverse of the second
+ * order finite difference Laplacian on the Chebyshev grid using the
+ * Peaceman-Rachford iteration. Every half step is a set of
+ * independent tridiagonal solves along the rows or the columns of the
+ * grid, and each one uses the same Cholesky forward and backwards
+ * solve as the one dimensional preconditioner. The lines are solved
+ * together using the BatchedTridiagonal class. The shifts are the
+ * optimal Peaceman-Rachford parameters given by Wachspress.
+ *
+ *
+ * @brief header file for the basic operations associated with the
+ * ADI preconditioner for the linearized PDE.
+ *
+ * ********************************************************************************* */
+
+#include <vector>
+#include "../tridiagonal.h"
+
+#define NUMBER 64
+
+class Solution;
+
+class AlternatingDirection
+{
+
+public:
+	AlternatingDirection(int number=NUMBER,int steps=6);         //< Default constructor for the class
+	AlternatingDirection(const AlternatingDirection& oldCopy);   //< Constructor for making a copy/duplicate
+	~AlternatingDirection();                                     //< Destructor for the class
+
+	Solution solve(const Solution &current);    //< Method to solve the
+                                                //< system associated with
+                                                //< the preconditioner.
+	void solveInto(const Solution &current,Solution &multiplied); //< Solve the system and write the result into an existing Solution.
+
+	/**
+		 Method to get the number of elements that are used for the approximation.
+
+		 @return The number of grid points used in the approximation.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get the number of Peaceman-Rachford steps in one
+		 application of the preconditioner.
+
+		 @return The number of shifts.
+	 */
+	int getSteps() const
+	{
+		return(steps);
+	}
+
+	/**
+		 Method to get the value of the shift for a given step.
+
+		 @param step The Peaceman-Rachford step.
+		 @return The shift used for the step.
+	 */
+	double getShift(int step) const
+	{
+		return(shift[step]);
+	}
+
+	/**
+		 Method to get the lower bound of the spectrum of the one
+		 dimensional finite difference operator.
+
+		 @return The smallest eigenvalue.
+	 */
+	double getLowerBound() const
+	{
+		return(lowerBound);
+	}
+
+	/**
+		 Method to get the upper bound of the spectrum of the one
+		 dimensional finite difference operator.
+
+		 @return The bound for the largest eigenvalue.
+	 */
+	double getUpperBound() const
+	{
+		return(upperBound);
+	}
+
+
+protected:
+
+	// Define the routines used to set up the preconditioner.
+	void defineDifferences();                         //< Define the finite difference operator on the Chebyshev grid.
+	void factor(BatchedTridiagonal<double> *cholesky,double rho); //< Cholesky decomposition of S + rho W.
+	void defineBounds();                              //< Find the bounds of the spectrum of W^{-1} S.
+	void defineShifts();                              //< Find the optimal Peaceman-Rachford shifts.
+
+	// Define the routines used to apply the preconditioner.
+	void sweepColumns(int step);                      //< Implicit in the first index, explicit in the second.
+	void sweepRows(int step);                         //< Implicit in the second index, explicit in the first.
+
+
+private:
+
+	int N;                  //< The number of grid points associated with the approximation.
+	int steps;              //< The number of Peaceman-Rachford steps.
+	double lowerBound;      //< The smallest eigenvalue of the one dimensional operator.
+	double upperBound;      //< Upper bound of the eigenvalues of the one dimensional operator.
+	double *shift;          //< The Peaceman-Rachford shifts.
+
+	double *weight;         //< The diagonal matrix W, half the sum of the adjacent spacings.
+	double *upper;          //< The off diagonal of the symmetric matrix S.
+	double *centre;         //< The diagonal of the symmetric matrix S.
+	std::vector<BatchedTridiagonal<double>*> factors; //< The decomposition of S + shift W for every shift.
+
+	double **rhs;           //< The right hand side of the finite difference system.
+	double **iterate;       //< The current ADI iterate.
+	double **half;          //< The ADI iterate after the first half step.
+	double **lines;         //< Scratch space for the interleaved line solves.
+
+};
+
+
+
+
+#endif
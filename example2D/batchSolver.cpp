@@ -0,0 +1,134 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+
+/* *********************************************************************************
+ *
+ * Solve the two dimensional example for a list of grid sizes in one
+ * process. The Chebyshev matrices for every size are kept until the
+ * end, so a size that is repeated, or that is a coarse level of the
+ * multigrid preconditioner, uses the matrices that were already
+ * built. The preconditioner is chosen when the program is compiled in
+ * the same way as the systemSolver example.
+ *
+ * Usage: batchSolver [-n N[,N...]] [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * One line of comma separated values is written for every size.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "multigrid.h"
+#include "alternatingDirection.h"
+#include "../GMRES.h"
+#include "../pool.h"
+#include "../monitor.h"
+#include "../chebyshev.h"
+#include "../options.h"
+
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cmath>
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(NUMBER,500,10,1.0E-8);
+	int defaults[] = {16,32,48,64};
+	options.setSizes(std::vector<int>(defaults,defaults+4));
+	if(!options.parse(argc,argv))
+		return(2);
+
+	std::vector<std::shared_ptr<const ChebyshevMatrices<double> > > matrices;
+	std::cout << "N,iterations,restarts,residual,error,setup,solve,matrices" << std::endl;
+
+	// One pool is used for every size so that the blocks released by
+	// one solve are kept for the solves that follow it.
+	MemoryPoolScope scope;
+	std::vector<int>::const_iterator size;
+	for(size=options.getSizes().begin();size!=options.getSizes().end();++size)
+		{
+			int number = *size;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			matrices.push_back(ChebyshevCache<double>::get(number));
+			Poisson elliptical(number);
+#ifdef MULTIGRID
+			Multigrid pre(number);
+#elif defined(ALTERNATINGDIRECTION)
+			AlternatingDirection pre(number);
+#else
+			Preconditioner pre(number);
+#endif
+			Solution x(number);
+			Solution b(number);
+
+			// Use the same right hand side as the systemSolver example.
+			int row;
+			int col;
+			for(row=1;row<number;++row)
+				for(col=1;col<number;++col)
+					{
+						double xgrid = elliptical.getX(row);
+						double ygrid = elliptical.getX(col);
+						b(row,col) = -2.0*(1.0-xgrid*xgrid)-2.0*(1.0-ygrid*ygrid);
+					}
+			double setup = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+			ReportMonitor monitor;
+			int result = GMRES(&elliptical,&x,&b,&pre,options.getKrylovDimension(),options.getRestarts(),
+												 options.getTolerance(),monitor);
+
+			double error = 0.0;
+			for(row=0;row<=number;++row)
+				for(col=0;col<=number;++col)
+					{
+						double xgrid = elliptical.getX(row);
+						double ygrid = elliptical.getX(col);
+						error = fmax(error,fabs(x(row,col)-(1.0-xgrid*xgrid)*(1.0-ygrid*ygrid)));
+					}
+
+			const SolveReport &report = monitor.getReport();
+			std::cout << number << ","
+								<< result << ","
+								<< report.restarts << ","
+								<< report.residual << ","
+								<< error << ","
+								<< setup << ","
+								<< report.totalSeconds << ","
+								<< ChebyshevCache<double>::count() << std::endl;
+		}
+
+	return(0);
+}
@@ -0,0 +1,272 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+
+/* *********************************************************************************
+ *
+ * Benchmarks for the two dimensional example. The vector operations,
+ * the operator, the three preconditioners, and complete GMRES solves are
+ * timed for several numbers of grid points, dimensions of the Krylov
+ * subspace, and numbers of restarts. The batched tridiagonal solve used
+ * by the ADI preconditioner is also compared with solving the same
+ * lines one at a time.
+ *
+ * Usage: benchmarkSolver [csv|json|roofline] [label]
+ *
+ * The roofline format measures the bandwidth and the flop rate of the
+ * machine, times only the kernels whose flops and bytes are known,
+ * and writes a table comparing each one to the roofline.
+ *
+ * The results are written to the standard output.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "multigrid.h"
+#include "alternatingDirection.h"
+#include "../GMRES.h"
+#include "../pool.h"
+#include "../benchmark.h"
+#include "../tridiagonal.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <vector>
+
+
+/** ************************************************************************
+ * Time the update of the approximation at the end of a GMRES cycle
+ * for a subspace of a given dimension. The triangular system is solved
+ * in place, so the coefficients are reset before every call. The basis
+ * vectors are copies of one vector, and the coefficients are small so
+ * the approximation does not grow.
+ *
+ * @param bench The benchmark that keeps the results.
+ * @param number The number of grid points.
+ * @param dimension The dimension of the Krylov subspace.
+ * @param basis The vector used for every basis vector.
+ * @param x The approximation that is updated.
+ * ************************************************************************ */
+void benchmarkUpdate(Benchmark &bench,int number,int dimension,const Solution &basis,Solution &x)
+{
+	std::vector<Solution> V(dimension,basis);
+	Tensor<double,2> H(dimension+1,dimension);
+	Tensor<double,1> s(dimension+1);
+	int row;
+	int col;
+	for(row=0;row<dimension;++row)
+		{
+			H(row,row) = 2.0;
+			for(col=row+1;col<dimension;++col)
+				H(row,col) = 0.1;
+		}
+
+	double n     = (double)((V[0].getN()+1)*(V[0].getN()+1));
+	double k     = (double)dimension;
+	double flops = k*k + k + 2.0*k*n;
+	double bytes = 24.0*k*n + 8.0*k*k;
+	x = 0.0;
+	bench.run("update",number,dimension,0,flops,bytes,[&]()
+						{
+							int lupe;
+							for(lupe=0;lupe<dimension;++lupe)
+								s(lupe) = 1.0e-9;
+							Update(H,&x,s,&V,dimension-1);
+							return(s(0));
+						});
+}
+
+
+/** ************************************************************************
+ * Time the solve of the interleaved tridiagonal systems used by the
+ * ADI preconditioner, first as one batch and then one line at a time.
+ * There are N-1 lines of N-1 unknowns, and consecutive entries of a
+ * line are N+1 apart as they are in a Solution. The matrix is the one
+ * for the second difference with a shift, so it is well conditioned.
+ * The right hand sides are reset before every call, and the copy is
+ * part of the time for both kernels.
+ *
+ * @param bench The benchmark that keeps the results.
+ * @param number The number of grid points.
+ * ************************************************************************ */
+void benchmarkTridiagonal(Benchmark &bench,int number)
+{
+	int size   = number-1;
+	int stride = number+1;
+	BatchedTridiagonal<double> cholesky(size);
+	std::vector<double> diagonal(size,4.0);
+	std::vector<double> offDiagonal(size,-1.0);
+	cholesky.factor(diagonal.data(),offDiagonal.data());
+
+	std::vector<double> source(size*stride);
+	std::vector<double> lines(size*stride);
+	std::size_t lupe;
+	for(lupe=0;lupe<source.size();++lupe)
+		source[lupe] = sin(1.0e-3*((double)lupe));
+
+	// Each line needs three flops per unknown in each direction. The
+	// lines are read and written by the copy and by the solve.
+	double unknowns = (double)(size*size);
+	double flops    = 6.0*unknowns;
+	double bytes    = 40.0*((double)(size*stride)) + 16.0*((double)size);
+
+	bench.run("tridiagonal-batch",number,0,0,flops,bytes,[&]()
+						{
+							std::copy(source.begin(),source.end(),lines.begin());
+							cholesky.solve(lines.data(),stride,size);
+							return(lines[0]);
+						});
+	bench.run("tridiagonal-line",number,0,0,flops,bytes,[&]()
+						{
+							std::copy(source.begin(),source.end(),lines.begin());
+							int line;
+							for(line=0;line<size;++line)
+								cholesky.solve(lines.data()+line,stride,1);
+							return(lines[0]);
+						});
+}
+
+
+int main(int argc,char **argv)
+{
+	std::string format = (argc>1) ? argv[1] : "csv";
+	std::string label  = (argc>2) ? argv[2] : "";
+	bool roofline      = (format=="roofline");
+	Benchmark bench(label);
+	if(roofline)
+		bench.measureMachine();
+
+	int sizes[]    = {16,32,64,128};
+	int krylov[]   = {20,50,100};
+	int restarts[] = {2,10};
+	int size;
+	int dimension;
+	int restart;
+
+	for(size=0;size<4;++size)
+		{
+			int number = sizes[size];
+			Poisson elliptical(number);
+			Preconditioner pre(number);
+			Multigrid multigrid(number);
+			AlternatingDirection adi(number);
+			Solution u(number);
+			Solution v(number);
+			Solution w(number);
+			Solution x(number);
+			Solution b(number);
+
+			// Use the same right hand side as the systemSolver example.
+			int row;
+			int col;
+			for(row=0;row<=number;++row)
+				for(col=0;col<=number;++col)
+					{
+						double xgrid = elliptical.getX(row);
+						double ygrid = elliptical.getX(col);
+						u(row,col) = sin(M_PI*xgrid)*cos(M_PI*ygrid);
+						v(row,col) = cos(M_PI*xgrid)*sin(M_PI*ygrid);
+						b(row,col) = -2.0*(1.0-xgrid*xgrid)-2.0*(1.0-ygrid*ygrid);
+						if((row==0) || (row==number) || (col==0) || (col==number))
+							b(row,col) = 0.0;
+					}
+
+			// The flops and bytes for one call of each kernel. A vector
+			// has n=(N+1)^2 entries. The operator multiplies by the dense
+			// second derivative matrix in each direction at the interior
+			// points, and the preconditioner scales by the diagonal.
+			double n        = (double)((number+1)*(number+1));
+			double interior = (double)((number-1)*(number-1));
+			double applyFlops = 4.0*((double)(number+1))*interior;
+			double applyBytes = 24.0*n;
+			double solveFlops = interior;
+			double solveBytes = 16.0*n + 8.0*((double)(number+1));
+
+			bench.setRepeats(BENCHMARKWARMUP,BENCHMARKREPEATS);
+			bench.run("dot",number,0,0,2.0*n,16.0*n,[&]() { return(Solution::dot(u,v)); });
+			bench.run("norm",number,0,0,2.0*n,8.0*n,[&]() { return(u.norm()); });
+			bench.run("axpy",number,0,0,2.0*n,24.0*n,[&]() { w.axpy(&u,1.0e-6); return(w.getEntry(1,1)); });
+			bench.run("operator",number,0,0,applyFlops,applyBytes+16.0*n,[&]() { w = elliptical*u; return(w.getEntry(1,1)); });
+			bench.run("apply",number,0,0,applyFlops,applyBytes,[&]() { elliptical.apply(u,w); return(w.getEntry(1,1)); });
+			bench.run("precondition",number,0,0,solveFlops,solveBytes+16.0*n,[&]() { w = pre.solve(u); return(w.getEntry(1,1)); });
+			bench.run("solveInto",number,0,0,solveFlops,solveBytes,[&]() { pre.solveInto(u,w); return(w.getEntry(1,1)); });
+			for(dimension=0;dimension<3;++dimension)
+				benchmarkUpdate(bench,number,krylov[dimension],u,x);
+			bench.run("multigrid",number,0,0,[&]() { multigrid.solveInto(u,w); return(w.getEntry(1,1)); });
+			bench.run("adi",number,0,0,[&]() { adi.solveInto(u,w); return(w.getEntry(1,1)); });
+			benchmarkTridiagonal(bench,number);
+
+			// Every solve starts from zero. The value is the number of
+			// iterations, or zero if the solve did not converge. The
+			// solves are slow, so fewer samples are taken, and they are
+			// skipped for the largest grid. The diagonal preconditioner
+			// is used for every combination, and the multigrid and ADI
+			// preconditioners are used with the smallest subspace.
+			if(roofline || (number>64))
+				continue;
+			bench.setRepeats(1,5);
+			for(dimension=0;dimension<3;++dimension)
+				for(restart=0;restart<2;++restart)
+					bench.run("gmres",number,krylov[dimension],restarts[restart],[&]()
+										 {
+											 MemoryPoolScope scope;
+											 x = 0.0;
+											 return((double)GMRES(&elliptical,&x,&b,&pre,
+																						krylov[dimension],restarts[restart],1.0e-8));
+										 });
+
+			bench.run("gmres-multigrid",number,krylov[0],restarts[0],[&]()
+								 {
+									 MemoryPoolScope scope;
+									 x = 0.0;
+									 return((double)GMRES(&elliptical,&x,&b,&multigrid,krylov[0],restarts[0],1.0e-8));
+								 });
+			bench.run("gmres-adi",number,krylov[0],restarts[0],[&]()
+								 {
+									 MemoryPoolScope scope;
+									 x = 0.0;
+									 return((double)GMRES(&elliptical,&x,&b,&adi,krylov[0],restarts[0],1.0e-8));
+								 });
+		}
+
+	if(roofline)
+		bench.writeRoofline(std::cout);
+	else if(format=="json")
+		bench.writeJSON(std::cout);
+	else
+		bench.writeCSV(std::cout);
+
+	return(0);
+}
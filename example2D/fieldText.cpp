@@ -0,0 +1,75 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+
+/* *********************************************************************************
+ *
+ * Write a binary solution file as text for use with a plotting
+ * program. Each line has the nodes for a point followed by the value.
+ *
+ * Usage: fieldText file [output]
+ *
+ * The text is written to the output file if one is given and to the
+ * standard output otherwise.
+ *
+ * ********************************************************************************* */
+
+#include "../field.h"
+
+#include <iostream>
+#include <fstream>
+
+
+int main(int argc,char **argv)
+{
+	if(argc<2)
+		{
+			std::cerr << "Usage: fieldText file [output]" << std::endl;
+			return(1);
+		}
+
+	FieldFile file;
+	if(!file.read(argv[1]))
+		{
+			std::cerr << "The file " << argv[1] << " could not be read." << std::endl;
+			return(1);
+		}
+
+	if(argc>2)
+		{
+			std::ofstream output(argv[2]);
+			file.writeText(output);
+		}
+	else
+		file.writeText(std::cout);
+
+	return(0);
+}
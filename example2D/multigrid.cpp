@@ -0,0 +1,717 @@
+
+/** *********************************************************************************
+ *
+ * @file multigrid.cpp
+ * @class Multigrid
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of a p-multigrid preconditioner for the
+ * linearized operator associated with a PDE.
+ *
+ * This is the source file for the Multigrid class. It includes the
+ * routines to set up the hierarchy of operators, the Chebyshev
+ * transforms used to move between the levels, the Chebyshev
+ * accelerated Jacobi smoother, and the V-cycle itself.
+ *
+ *
+ * @brief Basic operations associated with the p-multigrid
+ * preconditioner.
+ *
+ * ********************************************************************************* */
+
+
+
+#include "multigrid.h"
+#include "preconditioner.h"
+#include "poisson.h"
+#include "solution.h"
+#include "../util.h"
+
+#include <cmath>
+
+
+/** ************************************************************************
+ * Base constructor  for the Multigrid class.
+ *
+ * Sets up the operators on every level, estimates the largest
+ * eigenvalue of the Jacobi scaled operator on every level for the
+ * smoother, and factors the operator on the coarsest level.
+ *
+ * @param number The number of grid points used in the approximation.
+ * @param steps The number of smoothing steps before and after the coarse correction.
+ * ************************************************************************ */
+Multigrid::Multigrid(int number,int steps)
+{
+	N = number;
+	smoothingSteps = steps;
+	allocateLevels();
+
+	int lupe;
+	for(lupe=0;lupe<levels;++lupe)
+		estimateEigenvalue(lupe);
+
+	factorCoarse();
+}
+
+
+/** ************************************************************************
+ *	Copy constructor  for the Multigrid class.
+ *
+ *	@param oldCopy The Multigrid class member to make a copy of.
+ * ************************************************************************ */
+Multigrid::Multigrid(const Multigrid& oldCopy)
+{
+	N = oldCopy.getN();
+	smoothingSteps = oldCopy.getSmoothingSteps();
+	allocateLevels();
+
+	// Copy the eigenvalue estimates and the coarse factorization
+	// rather than recalculating them.
+	int lupe;
+	int innerLupe;
+	for(lupe=0;lupe<levels;++lupe)
+		lambdaMax[lupe] = oldCopy.getLambdaMax(lupe);
+
+	int unknowns = (degree[levels-1]-1)*(degree[levels-1]-1);
+	for(lupe=0;lupe<unknowns;++lupe)
+		{
+			pivot[lupe] = oldCopy.pivot[lupe];
+			for(innerLupe=0;innerLupe<unknowns;++innerLupe)
+				coarseLU[lupe][innerLupe] = oldCopy.coarseLU[lupe][innerLupe];
+		}
+}
+
+/** ************************************************************************
+ *	Destructor for the Multigrid class.
+ *  ************************************************************************ */
+Multigrid::~Multigrid()
+{
+	int lupe;
+	for(lupe=0;lupe<levels;++lupe)
+		{
+			delete operators[lupe];
+			delete rhs[lupe];
+			delete approx[lupe];
+			delete residual[lupe];
+			delete direction[lupe];
+			ArrayUtils<double>::deltwotensor(inverse[lupe]);
+			ArrayUtils<double>::delonetensor(cosine[lupe]);
+		}
+
+	ArrayUtils<double>::deltwotensor(lineValues);
+	ArrayUtils<double>::deltwotensor(partial);
+	ArrayUtils<double>::deltwotensor(coarseLU);
+	ArrayUtils<double>::delonetensor(coarseRHS);
+	delete [] pivot;
+}
+
+
+/** ************************************************************************
+ * Method to determine the levels and allocate the space for every level.
+ *
+ * The polynomial degree is halved, rounding down, until the next level
+ * would fall below MULTIGRIDCOARSEST. The transfers between the levels
+ * use the Chebyshev coefficients, so the degrees do not have to be
+ * even, and the coarsest degree is always less than twice
+ * MULTIGRIDCOARSEST unless N itself is smaller. For every level the
+ * operator, the reciprocal of the diagonal of the operator, and the
+ * table of cosines used for the Chebyshev transform are defined.
+ *
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::allocateLevels()
+{
+	degree.clear();
+	degree.push_back(N);
+	while(degree.back()/2 >= MULTIGRIDCOARSEST)
+		degree.push_back(degree.back()/2);
+	levels = (int)degree.size();
+
+	int level;
+	int row;
+	int col;
+	int lupe;
+	for(level=0;level<levels;++level)
+		{
+			int num = degree[level];
+			operators.push_back(new Poisson(num));
+			rhs.push_back(new Solution(num));
+			approx.push_back(new Solution(num));
+			residual.push_back(new Solution(num));
+			direction.push_back(new Solution(num));
+			lambdaMax.push_back(1.0);
+
+			// The diagonal of the two dimensional operator at the point
+			// (row,col) is the sum of the diagonal entries of the one
+			// dimensional second derivative matrix. The Preconditioner
+			// class keeps 1/(2 d_ii) so the reciprocal of the sum is
+			// found from those values.
+			Preconditioner diagonal(num);
+			double **scale = ArrayUtils<double>::twotensor(num+1,num+1);
+			for(row=1;row<num;++row)
+				for(col=1;col<num;++col)
+					{
+						double rowValue = diagonal.getValue(row);
+						double colValue = diagonal.getValue(col);
+						scale[row][col] = 2.0*rowValue*colValue/(rowValue+colValue);
+					}
+			inverse.push_back(scale);
+
+			// The Chebyshev transforms on this level need cos(pi j k/num)
+			// which is periodic in j*k with period 2*num.
+			double *table = ArrayUtils<double>::onetensor(2*num);
+			for(lupe=0;lupe<2*num;++lupe)
+				table[lupe] = cos(M_PI*((double)lupe)/((double)num));
+			cosine.push_back(table);
+		}
+
+	lineValues = ArrayUtils<double>::twotensor(2,N+1);
+	partial    = ArrayUtils<double>::twotensor(N+1,N+1);
+
+	int unknowns = (degree[levels-1]-1)*(degree[levels-1]-1);
+	coarseLU  = ArrayUtils<double>::twotensor(unknowns,unknowns);
+	coarseRHS = ArrayUtils<double>::onetensor(unknowns);
+	pivot     = new int[unknowns];
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner.
+ *
+ * The boundary values are left as they are, and a single V-cycle is
+ * used to approximate the inverse of the operator on the interior.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @return A Solution class member that is the solution to the
+ *         preconditioned system.
+ * ************************************************************************ */
+Solution Multigrid::solve(const Solution &current)
+{
+	Solution multiplied(current.getN());
+	solveInto(current,multiplied);
+	return(multiplied);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner and write the result into an existing object.
+ *
+ * Performs the same solve as the solve method, but the result is
+ * written into the Solution object passed to it, and no new memory is
+ * allocated. The result must be a different object than the right
+ * hand side.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @param multiplied The Solution object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::solveInto(const Solution &current,Solution &multiplied)
+{
+	int row;
+	int col;
+
+	// The right hand side on the finest level is the interior of the
+	// vector passed to us. The V-cycle starts with a zero estimate.
+	(*rhs[0])    = 0.0;
+	(*approx[0]) = 0.0;
+	for(row=1;row<N;++row)
+		for(col=1;col<N;++col)
+			(*rhs[0])(row,col) = current.getEntry(row,col);
+
+	vcycle(0);
+
+	for(row=1;row<N;++row)
+		for(col=1;col<N;++col)
+			multiplied(row,col) = (*approx[0])(row,col);
+
+	// The boundary values are passed through unchanged.
+	for(col=0;col<=N;++col)
+		{
+			multiplied(0,col) = current.getEntry(0,col);
+			multiplied(N,col) = current.getEntry(N,col);
+		}
+	for(row=1;row<N;++row)
+		{
+			multiplied(row,0) = current.getEntry(row,0);
+			multiplied(row,N) = current.getEntry(row,N);
+		}
+}
+
+
+/** ************************************************************************
+ * Perform a V-cycle starting at the given level.
+ *
+ * It is assumed that the right hand side for the level has been
+ * defined and that the approximation for the level has its initial
+ * value. The approximation is updated in place.
+ *
+ * @param level The level to start the V-cycle.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::vcycle(int level)
+{
+	if(level == levels-1)
+		{
+			// This is the bottom of the V-cycle.
+			coarseSolve();
+			return;
+		}
+
+	// Smooth, move the residual to the coarser level, and then
+	// correct the approximation with the coarse approximation.
+	smooth(level,smoothingSteps);
+	computeResidual(level,false);
+	restrictResidual(level);
+	(*approx[level+1]) = 0.0;
+	vcycle(level+1);
+	prolongate(level);
+	smooth(level,smoothingSteps);
+}
+
+
+/** ************************************************************************
+ * Chebyshev accelerated Jacobi smoother.
+ *
+ * The iteration targets the upper part of the spectrum of the Jacobi
+ * scaled operator, [0.1 lambda, 1.1 lambda] where lambda is the
+ * estimate of the largest eigenvalue found by the power iteration.
+ * The approximation on the given level is updated in place.
+ *
+ * @param level The level to smooth.
+ * @param steps The number of steps to take. Each step is one operator evaluation.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::smooth(int level,int steps)
+{
+	int num = degree[level];
+	double upper = 1.1*lambdaMax[level];
+	double lower = 0.1*lambdaMax[level];
+	double theta = 0.5*(upper+lower);
+	double delta = 0.5*(upper-lower);
+	double sigma = theta/delta;
+	double rhoOld = 1.0/sigma;
+	double rhoNew;
+
+	Solution &x = *approx[level];
+	Solution &d = *direction[level];
+	Solution &r = *residual[level];
+	int row;
+	int col;
+	int step;
+
+	computeResidual(level,true);
+	d = r*(1.0/theta);
+	for(step=1;;++step)
+		{
+			for(row=1;row<num;++row)
+				for(col=1;col<num;++col)
+					x(row,col) += d(row,col);
+
+			if(step >= steps)
+				break;
+
+			computeResidual(level,true);
+			rhoNew = 1.0/(2.0*sigma-rhoOld);
+			for(row=1;row<num;++row)
+				for(col=1;col<num;++col)
+					d(row,col) = rhoNew*rhoOld*d(row,col) + 2.0*rhoNew/delta*r(row,col);
+			rhoOld = rhoNew;
+		}
+}
+
+
+/** ************************************************************************
+ * Determine the residual on the interior for a given level.
+ *
+ * The residual, f-Au, is stored in the residual Solution for the
+ * level. If requested it is multiplied by the reciprocal of the
+ * diagonal of the operator. The boundary values are set to zero.
+ *
+ * @param level The level to use.
+ * @param scaled Flag to indicate whether to multiply by the inverse of the diagonal.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::computeResidual(int level,bool scaled)
+{
+	int num = degree[level];
+	Solution &r = *residual[level];
+	operators[level]->apply(*approx[level],r);
+
+	int row;
+	int col;
+	double **scale = inverse[level];
+	for(row=1;row<num;++row)
+		for(col=1;col<num;++col)
+			{
+				r(row,col) = (*rhs[level])(row,col) - r(row,col);
+				if(scaled)
+					r(row,col) *= scale[row][col];
+			}
+
+	for(col=0;col<=num;++col)
+		{
+			r(0,col)   = 0.0;
+			r(num,col) = 0.0;
+			r(col,0)   = 0.0;
+			r(col,num) = 0.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Move the residual on a given level to the next coarser level.
+ *
+ * The residual is transformed to its Chebyshev coefficients one
+ * direction at a time, the coefficients above the coarse degree are
+ * dropped, and the truncated series is evaluated at the coarse grid
+ * points. The result is the right hand side of the next level.
+ *
+ * @param level The finer of the two levels.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::restrictResidual(int level)
+{
+	int fine   = degree[level];
+	int coarse = degree[level+1];
+	int row;
+	int col;
+
+	Solution &r = *residual[level];
+	Solution &f = *rhs[level+1];
+	double *values = lineValues[0];
+	double *coefficients = lineValues[1];
+
+	// Go through each column and transform in the first index.
+	for(col=0;col<=fine;++col)
+		{
+			for(row=0;row<=fine;++row)
+				values[row] = r(row,col);
+			transform(values,coefficients,fine,coarse,cosine[level]);
+			evaluate(coefficients,values,coarse,coarse,1,2*coarse,cosine[level+1]);
+			for(row=0;row<=coarse;++row)
+				partial[row][col] = values[row];
+		}
+
+	// Go through each coarse row and transform in the second index.
+	for(row=1;row<coarse;++row)
+		{
+			transform(partial[row],coefficients,fine,coarse,cosine[level]);
+			evaluate(coefficients,values,coarse,coarse,1,2*coarse,cosine[level+1]);
+			for(col=1;col<coarse;++col)
+				f(row,col) = values[col];
+		}
+
+	// Apply the Dirichlet conditions for the correction.
+	for(col=0;col<=coarse;++col)
+		{
+			f(0,col)      = 0.0;
+			f(coarse,col) = 0.0;
+			f(col,0)      = 0.0;
+			f(col,coarse) = 0.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Add the correction from the next coarser level to a given level.
+ *
+ * The coarse approximation is transformed to its Chebyshev
+ * coefficients one direction at a time, and the series is evaluated
+ * at the fine grid points. Because the coarse correction is zero on
+ * the boundary the interpolant is zero on the fine boundary as well.
+ *
+ * @param level The finer of the two levels.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::prolongate(int level)
+{
+	int fine   = degree[level];
+	int coarse = degree[level+1];
+	int row;
+	int col;
+
+	Solution &e = *approx[level+1];
+	Solution &x = *approx[level];
+	double *values = lineValues[0];
+	double *coefficients = lineValues[1];
+
+	// Go through each coarse column and interpolate in the first index.
+	for(col=0;col<=coarse;++col)
+		{
+			for(row=0;row<=coarse;++row)
+				values[row] = e(row,col);
+			transform(values,coefficients,coarse,coarse,cosine[level+1]);
+			evaluate(coefficients,values,fine,coarse,1,2*fine,cosine[level]);
+			for(row=0;row<=fine;++row)
+				partial[row][col] = values[row];
+		}
+
+	// Go through each fine row and interpolate in the second index.
+	for(row=1;row<fine;++row)
+		{
+			transform(partial[row],coefficients,coarse,coarse,cosine[level+1]);
+			evaluate(coefficients,values,fine,coarse,1,2*fine,cosine[level]);
+			for(col=1;col<fine;++col)
+				x(row,col) += values[col];
+		}
+}
+
+
+/** ************************************************************************
+ * Find the Chebyshev coefficients of the values at the Gauss-Lobatto
+ * points.
+ *
+ * Determines a_k = 2/(c_k num) sum_j u_j cos(pi j k/num)/c_j where
+ * c_0 = c_num = 2 and c_j = 1 otherwise. Only the coefficients up to
+ * and including the given limit are found.
+ *
+ * @param values The values at the grid points, x_j = cos(pi j/num).
+ * @param coefficients The Chebyshev coefficients that are returned.
+ * @param num The polynomial degree of the values.
+ * @param limit The highest coefficient to calculate.
+ * @param cosine The table of cosines for the degree num.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::transform(const double *values,double *coefficients,
+						  int num,int limit,const double *cosine)
+{
+	int k;
+	int j;
+	int period = 2*num;
+	double sum;
+	for(k=0;k<=limit;++k)
+		{
+			sum = 0.5*(values[0] + ((k%2==0) ? values[num] : -values[num]));
+			for(j=1;j<num;++j)
+				sum += values[j]*cosine[(j*k)%period];
+			coefficients[k] = 2.0*sum/((double)num);
+		}
+	coefficients[0] *= 0.5;
+	if(limit == num)
+		coefficients[num] *= 0.5;
+}
+
+
+/** ************************************************************************
+ * Evaluate a Chebyshev series at a set of Gauss-Lobatto points.
+ *
+ * Determines u_i = sum_k a_k cos(pi k skip i/n) for i=0..points,
+ * where the table of cosines was built for the degree n=period/2.
+ *
+ * @param coefficients The Chebyshev coefficients.
+ * @param values The values at the grid points that are returned.
+ * @param points The polynomial degree of the grid to evaluate on.
+ * @param limit The highest coefficient in the series.
+ * @param skip The ratio of the table degree to the degree of the grid.
+ * @param period The period of the table of cosines.
+ * @param cosine The table of cosines.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::evaluate(const double *coefficients,double *values,int points,int limit,
+						 int skip,int period,const double *cosine)
+{
+	int i;
+	int k;
+	double sum;
+	for(i=0;i<=points;++i)
+		{
+			sum = 0.0;
+			for(k=0;k<=limit;++k)
+				sum += coefficients[k]*cosine[(k*skip*i)%period];
+			values[i] = sum;
+		}
+}
+
+
+/** ************************************************************************
+ * Estimate the largest eigenvalue of the Jacobi scaled operator.
+ *
+ * A fixed number of power iterations are used on the interior of the
+ * grid. The approximation and direction vectors for the level are
+ * used as scratch space and are left at zero.
+ *
+ * @param level The level to use.
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::estimateEigenvalue(int level)
+{
+	int num = degree[level];
+	Solution &x = *direction[level];
+	Solution &y = *residual[level];
+	double **scale = inverse[level];
+	int row;
+	int col;
+	int lupe;
+	double norm;
+
+	// Start with a vector that is not aligned with any particular
+	// eigenvector.
+	x = 0.0;
+	for(row=1;row<num;++row)
+		for(col=1;col<num;++col)
+			x(row,col) = 1.0 + 0.5*sin(3.0*row+7.0*col);
+	x *= 1.0/x.norm();
+
+	lambdaMax[level] = 1.0;
+	for(lupe=0;lupe<20;++lupe)
+		{
+			y = (*operators[level])*x;
+			for(row=1;row<num;++row)
+				for(col=1;col<num;++col)
+					y(row,col) *= scale[row][col];
+			for(col=0;col<=num;++col)
+				{
+					y(0,col)   = 0.0;
+					y(num,col) = 0.0;
+					y(col,0)   = 0.0;
+					y(col,num) = 0.0;
+				}
+
+			norm = y.norm();
+			lambdaMax[level] = norm;
+			x = y*(1.0/norm);
+		}
+
+	x = 0.0;
+	y = 0.0;
+}
+
+
+/** ************************************************************************
+ * Find the LU decomposition of the operator on the coarsest level.
+ *
+ * The matrix for the interior points is found one column at a time by
+ * applying the operator to each unit vector. The decomposition uses
+ * partial pivoting and is stored in place.
+ *
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::factorCoarse()
+{
+	int level = levels-1;
+	int num = degree[level];
+	int interior = num-1;
+	int unknowns = interior*interior;
+	Solution &unit = *direction[level];
+	Solution &column = *residual[level];
+	int lupe;
+	int innerLupe;
+	int row;
+
+	// Build the matrix one column at a time.
+	unit = 0.0;
+	for(lupe=0;lupe<unknowns;++lupe)
+		{
+			unit(lupe/interior+1,lupe%interior+1) = 1.0;
+			column = (*operators[level])*unit;
+			for(innerLupe=0;innerLupe<unknowns;++innerLupe)
+				coarseLU[innerLupe][lupe] = column(innerLupe/interior+1,innerLupe%interior+1);
+			unit(lupe/interior+1,lupe%interior+1) = 0.0;
+		}
+
+	// Perform the decomposition with partial pivoting.
+	for(lupe=0;lupe<unknowns;++lupe)
+		{
+			pivot[lupe] = lupe;
+			for(row=lupe+1;row<unknowns;++row)
+				if(fabs(coarseLU[row][lupe]) > fabs(coarseLU[pivot[lupe]][lupe]))
+					pivot[lupe] = row;
+
+			if(pivot[lupe] != lupe)
+				for(innerLupe=0;innerLupe<unknowns;++innerLupe)
+					{
+						double tmp = coarseLU[lupe][innerLupe];
+						coarseLU[lupe][innerLupe] = coarseLU[pivot[lupe]][innerLupe];
+						coarseLU[pivot[lupe]][innerLupe] = tmp;
+					}
+
+			for(row=lupe+1;row<unknowns;++row)
+				{
+					coarseLU[row][lupe] /= coarseLU[lupe][lupe];
+					for(innerLupe=lupe+1;innerLupe<unknowns;++innerLupe)
+						coarseLU[row][innerLupe] -= coarseLU[row][lupe]*coarseLU[lupe][innerLupe];
+				}
+		}
+
+	unit = 0.0;
+	column = 0.0;
+}
+
+
+/** ************************************************************************
+ * Solve the system on the coarsest level.
+ *
+ * Uses the LU decomposition found in the constructor. The result is
+ * stored in the interior of the approximation for the coarsest level.
+ *
+ * @return N/A
+ * ************************************************************************ */
+void Multigrid::coarseSolve()
+{
+	int level = levels-1;
+	int num = degree[level];
+	int interior = num-1;
+	int unknowns = interior*interior;
+	double *b = coarseRHS;
+	int lupe;
+	int innerLupe;
+
+	for(lupe=0;lupe<unknowns;++lupe)
+		b[lupe] = (*rhs[level])(lupe/interior+1,lupe%interior+1);
+
+	// Apply the row swaps and then the forward and backwards solves.
+	for(lupe=0;lupe<unknowns;++lupe)
+		if(pivot[lupe] != lupe)
+			{
+				double tmp = b[lupe];
+				b[lupe] = b[pivot[lupe]];
+				b[pivot[lupe]] = tmp;
+			}
+
+	for(lupe=1;lupe<unknowns;++lupe)
+		for(innerLupe=0;innerLupe<lupe;++innerLupe)
+			b[lupe] -= coarseLU[lupe][innerLupe]*b[innerLupe];
+
+	for(lupe=unknowns-1;lupe>=0;--lupe)
+		{
+			for(innerLupe=lupe+1;innerLupe<unknowns;++innerLupe)
+				b[lupe] -= coarseLU[lupe][innerLupe]*b[innerLupe];
+			b[lupe] /= coarseLU[lupe][lupe];
+		}
+
+	for(lupe=0;lupe<unknowns;++lupe)
+		(*approx[level])(lupe/interior+1,lupe%interior+1) = b[lupe];
+}
@@ -0,0 +1,175 @@
+#ifndef MULTIGRIDCLASS
+#define MULTIGRIDCLASS
+
+
+/** *********************************************************************************
+ * @file multigrid.h
+ * @class Multigrid
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep track of a p-multigrid preconditioner for the
+ * linearized operator associated with a PDE.
+ *
+ * This is the definition (header) file for the Multigrid class. The
+ * preconditioner keeps a hierarchy of Poisson operators at the
+ * polynomial degrees N, N/2, N/4, ..., rounded down, and performs a single V-cycle
+ * to approximate the inverse of the operator. The values are moved
+ * between the levels by exact Chebyshev interpolation, and a
+ * Chebyshev accelerated Jacobi iteration is used as the smoother.
+ *
+ *
+ * @brief header file for the basic operations associated with the
+ * p-multigrid preconditioner for the linearized PDE.
+ *
+ * ********************************************************************************* */
+
+#include <vector>
+
+#define NUMBER 64
+
+// The smallest polynomial degree used for the coarsest level. The
+// coarsest level is solved directly.
+#define MULTIGRIDCOARSEST 8
+
+class Solution;
+class Poisson;
+
+class Multigrid
+{
+
+public:
+	Multigrid(int number=NUMBER,int steps=2);   //< Default constructor for the class
+	Multigrid(const Multigrid& oldCopy);        //< Constructor for making a copy/duplicate
+	~Multigrid();                               //< Destructor for the class
+
+	Solution solve(const Solution &current);    //< Method to solve the
+                                                //< system associated with
+                                                //< the preconditioner.
+	void solveInto(const Solution &current,Solution &multiplied); //< Solve the system and write the result into an existing Solution.
+
+	/**
+		 Method to get the number of elements that are used for the approximation.
+
+		 @return The number of grid points used in the approximation.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get the number of levels in the multigrid hierarchy.
+
+		 @return The number of levels including the finest level.
+	 */
+	int getLevels() const
+	{
+		return(levels);
+	}
+
+	/**
+		 Method to get the number of smoothing steps used before and
+		 after the coarse grid correction.
+
+		 @return The number of Chebyshev smoothing steps.
+	 */
+	int getSmoothingSteps() const
+	{
+		return(smoothingSteps);
+	}
+
+	/**
+		 Method to get the estimate of the largest eigenvalue of the
+		 Jacobi scaled operator on a given level.
+
+		 @param level The level in the hierarchy, zero is the finest.
+		 @return The estimate of the largest eigenvalue.
+	 */
+	double getLambdaMax(int level) const
+	{
+		return(lambdaMax[level]);
+	}
+
+
+protected:
+
+	// Define the routines used within a V-cycle.
+	void vcycle(int level);                                     //< Recursive V-cycle starting at a given level.
+	void smooth(int level,int steps);                           //< Chebyshev accelerated Jacobi smoother.
+	void computeResidual(int level,bool scaled);                //< Residual f-Au, or D^{-1}(f-Au), on the interior.
+	void restrictResidual(int level);                           //< Move the residual to the next coarser level.
+	void prolongate(int level);                                 //< Add the coarse correction to a finer level.
+	void coarseSolve();                                         //< Direct solve on the coarsest level.
+
+	// Define the routines that define the levels.
+	void allocateLevels();                                      //< Allocate the space for every level.
+	void estimateEigenvalue(int level);                         //< Power iteration for the Jacobi scaled operator.
+	void factorCoarse();                                        //< LU decomposition of the coarsest operator.
+
+	// Define the one dimensional Chebyshev transforms used to move
+	// between the levels.
+	void transform(const double *values,double *coefficients,int num,int limit,const double *cosine);
+	void evaluate(const double *coefficients,double *values,int points,int limit,
+				  int skip,int period,const double *cosine);
+
+
+private:
+
+	int N;                               //< The number of grid points on the finest level.
+	int levels;                          //< The number of levels in the hierarchy.
+	int smoothingSteps;                  //< The number of pre and post smoothing steps.
+
+	std::vector<int>       degree;       //< The polynomial degree for each level.
+	std::vector<Poisson*>  operators;    //< The operator for each level.
+	std::vector<double**>  inverse;      //< The reciprocal of the diagonal of the operator for each level.
+	std::vector<double*>   cosine;       //< The values cos(pi m/n), m=0..2n-1, for each level.
+	std::vector<double>    lambdaMax;    //< Estimate of the largest eigenvalue of the scaled operator.
+
+	std::vector<Solution*> rhs;          //< The right hand side for each level.
+	std::vector<Solution*> approx;       //< The approximation for each level.
+	std::vector<Solution*> residual;     //< Scratch space for the residual on each level.
+	std::vector<Solution*> direction;    //< The search direction for the Chebyshev smoother.
+
+	double **lineValues;                 //< Scratch space for the values along one line.
+	double **partial;                    //< Values after the transform in the first index.
+	double **coarseLU;                   //< LU decomposition of the coarsest operator.
+	double *coarseRHS;                   //< Right hand side and solution for the coarsest direct solve.
+	int    *pivot;                       //< The row pivots for the coarsest LU decomposition.
+
+};
+
+
+
+
+#endif
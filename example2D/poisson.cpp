@@ -54,6 +54,7 @@
 #include "poisson.h"
 #include "solution.h"
 #include "../util.h"
+#include "../trace.h"
 
 #include <cmath>
 
@@ -67,11 +68,9 @@
 Poisson::Poisson(int number)
 {
 	N  = number;
-	d1 = ArrayUtils<double>::twotensor(number+1,number+1);
-	d2 = ArrayUtils<double>::twotensor(number+1,number+1);
-	x  = ArrayUtils<double>::onetensor(number+1);
-	cheby1(d1,x,number);
-	cheby2(d2,x,number);
+	// The grid points and derivative matrices are only computed for the
+	// first operator of a given size. Later operators share them.
+	matrices = ChebyshevCache<double>::get(number);
 }
 
 
@@ -83,21 +82,7 @@ Poisson::Poisson(int number)
 Poisson::Poisson(const Poisson& oldCopy)
 {
 	N  = oldCopy.getN();
-	d1 = ArrayUtils<double>::twotensor(N+1,N+1);
-	d2 = ArrayUtils<double>::twotensor(N+1,N+1);
-	x  = ArrayUtils<double>::onetensor(N+1);
-	int lupe;
-	int innerLupe;
-
-  for (lupe=0;lupe<=N;++lupe) // go through every row.
-		{
-			x[lupe] = oldCopy.getX(lupe);
-			for (innerLupe=0;innerLupe<=N;++innerLupe) // fill in the values for this row.
-				{
-					d1[lupe][innerLupe] = oldCopy.getD1(lupe,innerLupe);
-					d2[lupe][innerLupe] = oldCopy.getD2(lupe,innerLupe);
-				}
-		}
+	matrices = oldCopy.matrices;
 }
 
 /** ************************************************************************
@@ -105,9 +90,7 @@ Poisson::Poisson(const Poisson& oldCopy)
  *  ************************************************************************ */
 Poisson::~Poisson()
 {
-	ArrayUtils<double>::deltwotensor(d1);
-	ArrayUtils<double>::deltwotensor(d2);
-	ArrayUtils<double>::delonetensor(x);
+	// The matrices are released when the last operator that uses them is deleted.
 }
 
 
@@ -123,258 +106,74 @@ Poisson::~Poisson()
  * ************************************************************************ */
 Solution Poisson::operator*(class Solution vector)
 {
-	double tmp;
-	int row;
-	int col;
-	int N = vector.getN();
-	int innerLupe;
-	Solution result;
-
-	// Perform the Laplacian operator on the interior of the current
-	// approximation. Apply the boundary conditions as being
-	// Dirichlet.
-	for(row=0;row<=N;++row)
-		{
-			result.setEntry(vector(row,0),row,0); // set the top boundary
-
-			for(col=1;col<N;++col)
-				// Go through every interior point. Calc. the
-				// approx. to the x and then the y derivatives.
-				{
-					// First calc. the second x derivative.
-					tmp = this->getD2(row,0)*vector(0,col);
-					for(innerLupe=1;innerLupe<=N;++innerLupe)
-						tmp += this->getD2(row,innerLupe)*vector(innerLupe,col);
-
-					// Next calc. the second y derivative
-					for(innerLupe=0;innerLupe<=N;++innerLupe)
-						tmp += this->getD2(col,innerLupe)*vector(row,innerLupe);
-
-					// Set this value for the result.
-					result.setEntry(tmp,row,col);
-				}
-
-			result.setEntry(vector(row,N),N,0); // set the bottom boundary.
-		}
-
-	// Now set the left and right boundary conditions.
-	for(col=0;col<=N;++col)
-		{
-			result.setEntry(vector(0,col),0,col);
-			result.setEntry(vector(N,col),N,col);
-		}
-
+	Solution result(vector.getN());
+	apply(vector,result);
 	return(result);
 }
 
 
 /** ************************************************************************
- * The method to initialize the Chebychev collocation first derivative matrix.
+ * The matrix/vector  multiplication for the Poisson class.
  * 
- * It assumes that the memory for the matrix has been allocated. The
- * values of the matrix are initialized. Note that this does not make
- * use of the current state of the values for the object. This is done
- * to make it as generic as possible, and this method can be called by
- * friends to initialize values of their own matrices.
+ * Writes the matrix/vector product of an object from the Poisson
+ * class and an object from the Solution class into an existing
+ * Solution object. No new memory is allocated. The result must be a
+ * different object than the vector being multiplied.
  *
- * @param deriv  A pointer to the derivative matrix to initialize.
- * @param xVal   The x grid points to initialize.
- * @param num    The number of grid points to use.
+ * @param vector  The Solution object to multiply by this matrix.
+ * @param result  The Solution object that the product is written into.
  * @return N/A
  * ************************************************************************ */
-void  Poisson::cheby1(double **deriv,double *xVal,int num)
-
-/*
-      **********************************************
-       Subroutine to initialize the Chebychev first
-       derivitive matrix.  It also initializes the
-       XVAL vector.  Note that up to and including
-       (num) subscripts are used.
-      **********************************************
-*/
-
+void Poisson::apply(const Solution& vector,Solution& result)
 {
-  int i,j;
-  double xnum,dxnum;
-  double tmp;
-
-  // helper variables/factors used in various formulas.
-  xnum = ((double) num);
-  dxnum = 1.0/xnum;
-
-  // define the values of x.
-  for (i=1;i<num;++i)
-     xVal[i] = cos(M_PI* ((double) i) * dxnum);
-  xVal[0] = 1.0;
-  xVal[num] = -1.0;
-
-  for (i=0;i<num;++i) // go through every row.
-      {
-          for (j=i;j<=num;++j) // fill in the values for this row.
-              {
-                  if ((i==0) && (j==0))
-                      {
-                          // this is the upper left entry in the matrix
-                          deriv[0][0] = (2.0*xnum*xnum + 1.0)/6.0;
-                          deriv[num][num] = -deriv[0][0];
-                      }
-
-                  else if (i==j)
-                      {
-                          // this is a diagonal entry in the matrix.
-                          tmp = 1.0/sin(M_PI*((double)i)*dxnum);
-                          deriv[i][i] = -xVal[i]*tmp*tmp*0.5;
-                      }
-
-                  else
-                      {
-                          // This is an off diagonal entry.
-                          deriv[i][j] =
-                              0.5/(sin(M_PI*((double)(i+j))*dxnum*0.5)*sin(M_PI*((double)(-i+j))*dxnum*0.5));
-                          // Add a mult. factor for the top and bottom
-                          // rows as well as the left and right
-                          // columns.
-                          if (i%num == 0)
-                              deriv[i][j] *= 2.0;
-                          if (j%num == 0)
-                              deriv[i][j] *= 0.5;
-                          if ((i+j)%2 == 1)
-                              deriv[i][j] *= -1.0;
-
-                          // The matrix is anti-symmetric so fill in
-                          // the opposite side of the matrix.
-                          deriv[num-i][num-j] = - deriv[i][j];
-                      }
-              }
-      }
+	int row;
+	int col;
+	int N = vector.getN();
+	const Tensor<double,2> &d2 = matrices->getSecond();
 
+	// Perform the Laplacian operator on the interior of the current
+	// approximation. Apply the boundary conditions as being
+	// Dirichlet. The rows are split between the threads with the same
+	// static schedule used to first touch the memory for a Solution.
+	// Every thread records its share in the tracer of the solve.
+	Tracer *tracer = Tracer::active();
+#pragma omp parallel private(col)
+	{
+		TraceSpan span(tracer,"apply rows");
+#pragma omp for schedule(static)
+		for(row=1;row<N;++row)
+			{
+				double tmp;
+				int innerLupe;
+				result.setEntry(vector.getEntry(row,0),row,0); // set the left boundary
+
+				for(col=1;col<N;++col)
+					// Go through every interior point. Calc. the
+					// approx. to the x and then the y derivatives.
+					{
+						// First calc. the second x derivative.
+						tmp = d2(row,0)*vector.getEntry(0,col);
+						for(innerLupe=1;innerLupe<=N;++innerLupe)
+							tmp += d2(row,innerLupe)*vector.getEntry(innerLupe,col);
+
+						// Next calc. the second y derivative
+						for(innerLupe=0;innerLupe<=N;++innerLupe)
+							tmp += d2(col,innerLupe)*vector.getEntry(row,innerLupe);
+
+						// Set this value for the result.
+						result.setEntry(tmp,row,col);
+					}
+
+				result.setEntry(vector.getEntry(row,N),row,N); // set the right boundary.
+			}
+	}
+
+	// Now set the top and bottom boundary conditions.
+	for(col=0;col<=N;++col)
+		{
+			result.setEntry(vector.getEntry(0,col),0,col);
+			result.setEntry(vector.getEntry(N,col),N,col);
+		}
 }
 
 
-
-/** ************************************************************************
- * The method to initialize the Chebychev collocation second derivative matrix.
- * 
- * It assumes that the memory for the matrix has been allocated. The
- * values of the matrix are initialized. Note that this does not make
- * use of the current state of the values for the object. This is done
- * to make it as generic as possible, and this method can be called by
- * friends to initialize values of their own matrices.
- *
- * @param deriv  A pointer to the derivative matrix to initialize.
- * @param xVal   The x grid points to initialize.
- * @param num    The number of grid points to use.
- * @return N/A
- * ************************************************************************ */
-void Poisson::cheby2(double **deriv,double *xVal,int num)
-
-
-/*
-     *****************************************************
-       Subroutine to initialize the second derivitive
-       Chebychev matrix.  It also initializes the X
-       vector.  Note that up to and including the num
-       subscript is accessed.
-    ******************************************************
-
-*/
-
-{
-  double xnum,dxnum;
-  int i,j;
-  double tmp;
-
-  // helper variables/factors used in various formulas.
-  xnum = (double) num;
-  dxnum = 1.0/xnum;
-
-  // Define the values of x
-  for (i=1;i<num;++i)
-     xVal[i] = cos(M_PI*((double) i)*dxnum);
-  xVal[0] = 1.0;
-  xVal[num] = -1.0;
-
-  for (i=0;i<=num/2;++i) // go through each row.
-      {
-          for (j=0;j<=num;++j) // go through each column.
-              {
-
-                  if (((i==0) && (j==0)) ||
-                      ((i==num) && (j==num)))
-                      // fill in the top left and bottom right entries
-                      // in the matrix.
-                      deriv[i][j] = (xnum*xnum*xnum*xnum-1.0)/15.0;
-
-                  else if (i==0)
-                      {
-                          // This is the top row.
-                          tmp = sin(M_PI*((double)j)*dxnum*0.5);
-                          tmp *= tmp;
-                          deriv[i][j] = ((2.0*xnum*xnum+1.0)
-                                         *tmp-3.0)/(3.0*tmp*tmp);
-                          // The sign of the values are alternating
-                          if (j%2 == 1)
-                              deriv[i][j] *= -1.0;
-
-                          if ((j==0) || (j==num))
-                              // include the multipler for the left and right columns.
-                              deriv[i][j] *= 0.5;
-                      }
-
-                  else if (i==num)
-                      {
-                          // This is the bottom row.
-                          tmp = cos(M_PI*((double)j)*dxnum*0.5);
-                          tmp *= tmp;
-                          deriv[i][j] = ((2.0*xnum*xnum+1.0)
-                                         *tmp-3.0)/(3*tmp*tmp);
-
-                          // The sign of the values are alternating.
-                          if ((num+j)%2 == 1)
-                               deriv[i][j] *= -1.0;
-
-                           // Include the multipler for the left and right columns.
-                           if ((j==0) || (j==num))
-                               deriv[i][j] *= 0.5;
-
-                       }
-
-                   else if (i==j)
-                       {
-                           // This is the diagonal entry.
-                           tmp = sin(M_PI*((double)i)*dxnum);
-                           tmp *= tmp;
-                           deriv[i][j] = -((xnum*xnum-1.0)*tmp+3.0)
-                               /(3.0*tmp*tmp);
-                       }
-
-                   else
-                       {
-                           // This is an off diagonal entry.
-                           tmp = sin(M_PI*((double)i)*dxnum);
-                           tmp *= sin(M_PI*((double)(i+j))*dxnum*0.5);
-                           tmp *= sin(M_PI*((double)(-i+j))*dxnum*0.5);
-                           tmp *= tmp;
-                           deriv[i][j] = (cos(M_PI*((double)i)*dxnum)*
-                                          cos(M_PI*((double)(i+j))*dxnum*0.5) *
-                                          cos(M_PI*((double)(i-j))*dxnum*0.5) - 1.0)*0.5/tmp;
-
-                           // The signs of the values are alternating
-                           if ((i+j)%2 == 1)
-                               deriv[i][j] *= -1.0;
-
-                           // Include the multiplier for the left and right columns.
-                           if ((j==0) || (j==num))
-                               deriv[i][j] *= 0.5;
-                       }
-
-               }
-        }
-
-
-   // The matrix is symmetric so fill in the rest of the matrix.
-   for (i=num/2+1;i<=num;++i)
-       for (j=0;j<=num;++j)
-           deriv[i][j] = deriv[num-i][num-j];
-
-}
@@ -54,6 +54,9 @@
 
 #define NUMBER 64
 
+#include <memory>
+#include "../chebyshev.h"
+
 class Solution;
 
 class Poisson
@@ -66,6 +69,7 @@ public:
 
 	// Basic algebraic operators associated with the linearization of the operator.
 	Solution operator*(class Solution vector);  //< The linearized operator acting on a given Solution.
+	void apply(const Solution& vector,Solution& result); //< The linearized operator written into an existing Solution.
 
 	
 	/**
@@ -76,7 +80,7 @@ public:
 	 */
 	double getX(int row) const
 	{
-		return(x[row]);
+		return(matrices->getNodes()(row));
 	}
 
 	/**
@@ -98,7 +102,7 @@ public:
 	 */
 	inline double getD1(int row,int col) const
 	{
-		return(d1[row][col]);
+		return(matrices->getFirst()(row,col));
 	}
 
 
@@ -111,26 +115,16 @@ public:
 	 */
 	inline double getD2(int row,int col) const
 	{
-		return(d2[row][col]);
+		return(matrices->getSecond()(row,col));
 	}
 
-protected:
-
-	// Define the routines that initialize the first and second
-	// derivative matrices.
-	void cheby1(double **deriv,double *x,int num);   //< Method to define the first derivative matrix
-	void cheby2(double **deriv,double *x,int num);   //< Method to define the second derivative matrix
-
-
 private:
 
-	// Define the resolution of the approximation. Also define the
-	// first derivative matrix (d) and the second derivative matrix
-	// (d2). The grid points are given by x.
+	// Define the resolution of the approximation. The grid points and
+	// the first and second derivative matrices are shared with every
+	// other operator of the same size.
 	int N;        //< The number of grid points in the approximation.
-	double **d1;  //< Pointer to the first derivative matrix.
-	double **d2;  //< Pointer to the second derivative matrix.
-	double *x;    //< Pointer to the set of x grid points
+	std::shared_ptr<const ChebyshevMatrices<double> > matrices;  //< The grid points and derivative matrices.
 
 
 };
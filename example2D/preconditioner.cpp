@@ -67,8 +67,16 @@
 Preconditioner::Preconditioner(int number)
 {
 	setN(number);
+
+	// Use the diagonal in the file if there is one for this size.
+	std::string fileName = MatrixStore::fileName("jacobi",number,0);
+	if(store.open(fileName,number,0) &&
+		 store.find("diagonal",diagonal) && (diagonal.getExtent(0)==number+1))
+		return;
+	store.close();
+
 	// allocate the vector with the diagonal entries of the Laplacian
-	diagonal = ArrayUtils<double>::onetensor(number+1);
+	diagonal = Tensor<double,1>(number+1);
 
 	// Define the values for the diagonal entries of the operator,
 	// d^2/dx^2 u + m*u.
@@ -81,9 +89,16 @@ Preconditioner::Preconditioner(int number)
 		{
 			tmp = sin(M_PI*((double)lupe)/xnum);
 			tmp *= tmp;
-			diagonal[lupe] = -(3.0*tmp*tmp)/((xnum*xnum-1.0)*tmp+3.0)*0.5;
+			diagonal(lupe) = -(3.0*tmp*tmp)/((xnum*xnum-1.0)*tmp+3.0)*0.5;
 		}
 
+	// Save the diagonal so that the next process can map it.
+	if(!fileName.empty())
+		{
+			MatrixStore output;
+			output.add("diagonal",diagonal);
+			output.save(fileName,number,0);
+		}
 
 }
 
@@ -96,14 +111,9 @@ Preconditioner::Preconditioner(int number)
 Preconditioner::Preconditioner(const Preconditioner& oldCopy)
 {
 	setN(oldCopy.getN());
-	// Allocate the vector for the preconditioner, and copy it over.
-	diagonal = ArrayUtils<double>::onetensor(getN()+1);
-
-	int lupe;
-	for(lupe=getN();lupe>=0;--lupe)
-		{
-			diagonal[lupe] = oldCopy.getValue(lupe);
-		}
+	// Copy the vector for the preconditioner. A copy of a view of a
+	// file owns its own memory.
+	diagonal = oldCopy.diagonal;
 }
 
 /** ************************************************************************
@@ -111,7 +121,7 @@ Preconditioner::Preconditioner(const Preconditioner& oldCopy)
  *  ************************************************************************ */
 Preconditioner::~Preconditioner()
 {
-	ArrayUtils<double>::delonetensor(diagonal);
+	// The memory for the diagonal is released by the Tensor class.
 }
 
 /** ************************************************************************
@@ -128,17 +138,36 @@ Preconditioner::~Preconditioner()
  * ************************************************************************ */
 Solution Preconditioner::solve(const Solution &current)
 {
-	Solution multiplied(current);
+	Solution multiplied(current.getN());
+	solveInto(current,multiplied);
+	return(multiplied);
+}
+
+
+/** ************************************************************************
+ * The method to solve the system of equations associated with the
+ * preconditioner and write the result into an existing object.
+ * 
+ * Performs the same solve as the solve method, but the result is
+ * written into the Solution object passed to it, and no new memory is
+ * allocated. The result must be a different object than the right
+ * hand side.
+ *
+ * @param current The Solution or right hand side of the system.
+ * @param multiplied The Solution object the result is written into.
+ * @return N/A
+ * ************************************************************************ */
+void Preconditioner::solveInto(const Solution &current,Solution &multiplied)
+{
 	int row;
 	int col;
-	int lupe;
 	int N = current.getN();
 
 	// Apply the Dirichlet boundary conditions on the top and bottom rows.
 
 	for(row=1;row<N;++row)
 		for(col=1;col<N;++col)
-			multiplied(row,col) = multiplied(row,col)*diagonal[row];
+			multiplied(row,col) = current.getEntry(row,col)*diagonal(row);
 
 	for(col=0;col<=N;++col)
 		{
@@ -151,9 +180,6 @@ Solution Preconditioner::solve(const Solution &current)
 			multiplied(row,0) = current.getEntry(row,0);
 			multiplied(row,N) = current.getEntry(row,N);
 		}
-
-
-	return(multiplied);
 }
 
 
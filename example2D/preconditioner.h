@@ -53,6 +53,9 @@
 
 #define NUMBER 64
 
+#include "../tensor.h"
+#include "../store.h"
+
 class Solution;
 
 class Preconditioner
@@ -66,6 +69,7 @@ public:
 	Solution solve(const Solution &current);        //< Method to solve the
 													//< system associated with
 													//< the preconditioner.
+	void solveInto(const Solution &current,Solution &multiplied); //< Solve the system and write the result into an existing Solution.
 
 	
 	/**
@@ -98,7 +102,7 @@ public:
 	 */
 	double getValue(int row) const
 	{
-		return(diagonal[row]);
+		return(diagonal(row));
 	}
 
 
@@ -108,7 +112,8 @@ protected:
 private:
 
 	int N;              //< The number of grid points associated with the approximation.
-	double *diagonal;   //< The vector that has the reciprocol of the diagonal entries of the operator.
+	Tensor<double,1> diagonal;   //< The vector that has the reciprocol of the diagonal entries of the operator.
+	MatrixStore store;           //< The mapped file when the diagonal is a view of a file.
 
 };
 
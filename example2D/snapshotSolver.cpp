@@ -0,0 +1,179 @@
+
+/* *********************************************************************************
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ********************************************************************************* */
+
+
+
+/* *********************************************************************************
+ *
+ * Solve a sequence of two dimensional problems and write a snapshot of
+ * the approximation after every solve. The snapshots are queued with a
+ * SnapshotWriter and written by its thread while the next system is
+ * solved. Problem k has the right hand side of the systemSolver example
+ * times k+1. The preconditioner is chosen when the program is compiled
+ * in the same way as the systemSolver example.
+ *
+ * Once every snapshot is written each file is read back and compared
+ * with the approximation that was queued, and then it is removed.
+ *
+ * Usage: snapshotSolver [-n N] [-k krylov] [-r restarts] [-t tolerance]
+ *
+ * One line of comma separated values is written for every solve,
+ * followed by a line with the files written, the failures, the number
+ * of times a solve had to wait for a free buffer, and the number of
+ * files that did not match.
+ *
+ * ********************************************************************************* */
+
+#include "poisson.h"
+#include "solution.h"
+#include "preconditioner.h"
+#include "multigrid.h"
+#include "alternatingDirection.h"
+#include "../GMRES.h"
+#include "../pool.h"
+#include "../options.h"
+#include "../snapshot.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cmath>
+
+// The number of solves, each followed by a snapshot.
+#define SNAPSHOTSOLVES 20
+
+// The number of buffers given to the writer.
+#define SNAPSHOTSOLVERBUFFERS 3
+
+
+/** ************************************************************************
+ * The name of the file for a snapshot.
+ *
+ * @param step The number of the solve.
+ * @return The name of the file.
+ * ************************************************************************ */
+std::string snapshotName(int step)
+{
+	char name[32];
+	std::snprintf(name,sizeof(name),"snapshot%02d.fld",step);
+	return(std::string(name));
+}
+
+
+
+int main(int argc,char **argv)
+{
+	SolverOptions options(32,500,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+	int number = options.getNumber();
+
+	Poisson elliptical(number);
+#ifdef MULTIGRID
+	Multigrid pre(number);
+#elif defined(ALTERNATINGDIRECTION)
+	AlternatingDirection pre(number);
+#else
+	Preconditioner pre(number);
+#endif
+	Solution x(number);
+	Solution b(number);
+	std::vector<Solution> queued;
+
+	SnapshotWriter writer(SNAPSHOTSOLVERBUFFERS);
+	std::cout << "solve,N,iterations,residual,solve time,submit time" << std::endl;
+
+	int step;
+	for(step=0;step<SNAPSHOTSOLVES;++step)
+		{
+			// Use the right hand side of the systemSolver example times
+			// the number of the solve.
+			int row;
+			int col;
+			for(row=1;row<number;++row)
+				for(col=1;col<number;++col)
+					{
+						double xgrid = elliptical.getX(row);
+						double ygrid = elliptical.getX(col);
+						b(row,col) = -((double)(step+1))*(2.0*(1.0-xgrid*xgrid)+2.0*(1.0-ygrid*ygrid));
+					}
+			x = 0.0;
+
+			ReportMonitor monitor;
+			int result;
+			{
+				MemoryPoolScope scope;
+				result = GMRES(&elliptical,&x,&b,&pre,options.getKrylovDimension(),options.getRestarts(),
+											 options.getTolerance(),monitor);
+			}
+
+			// Queue the snapshot and keep a copy to check the file.
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			x.write(writer,snapshotName(step));
+			double submit = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+			queued.push_back(x);
+
+			const SolveReport &report = monitor.getReport();
+			std::cout << step << ","
+								<< number << ","
+								<< result << ","
+								<< report.residual << ","
+								<< report.totalSeconds << ","
+								<< submit << std::endl;
+		}
+	writer.flush();
+
+	// Read every file back and compare it with the approximation that
+	// was queued.
+	int mismatch = 0;
+	for(step=0;step<SNAPSHOTSOLVES;++step)
+		{
+			Solution copy(number);
+			bool same = copy.read(snapshotName(step));
+			int row;
+			int col;
+			for(row=0;same&&(row<=number);++row)
+				for(col=0;col<=number;++col)
+					same = same && (copy(row,col)==queued[step](row,col));
+			if(!same)
+				mismatch += 1;
+			std::remove(snapshotName(step).c_str());
+		}
+
+	std::cout << "written,failures,waits,mismatches" << std::endl
+						<< writer.getWritten() << ","
+						<< writer.getFailures() << ","
+						<< writer.getWaits() << ","
+						<< mismatch << std::endl;
+
+	return(((writer.getFailures()>0) || (mismatch>0)) ? 1 : 0);
+}
@@ -58,6 +58,9 @@
 #include "solution.h"
 #include "poisson.h"
 #include "../util.h"
+#include "../chebyshev.h"
+#include "../field.h"
+#include "../snapshot.h"
 
 /** ************************************************************************
  * Base constructor  for the Solution class. 
@@ -70,8 +73,8 @@ Solution::Solution(int size)
 	// Set the size of the vector, allocate the space, and zero out the
 	// approximation.
 	setN(size);
-	solution = ArrayUtils<double>::twotensor(size+1,size+1);  // allocate the space. 
-	// Note that the twotensor routine sets everything to zero so it
+	solution = Tensor<double,2>(size+1,size+1);  // allocate the space. 
+	// Note that the Tensor constructor sets everything to zero so it
 	// does not have to be initialized.
 }
 
@@ -84,14 +87,10 @@ Solution::Solution(int size)
 Solution::Solution(const Solution& oldCopy)
 {
 	// Make a copy of the Solution that is passed to me.
-	// Set the size of the vector, allocate the space, and then
-	// copy the values over.
+	// Set the size of the vector, and then copy the values over.
 	int size = oldCopy.getN();
 	setN(size);
-	solution = ArrayUtils<double>::twotensor(size+1,size+1);
-	for(;size>=0;--size)
-		for(int col=getN();col>=0;--col)
-			setEntry(oldCopy.getEntry(size,col),size,col);
+	solution = oldCopy.solution;
 }
 
 /** ************************************************************************
@@ -99,10 +98,7 @@ Solution::Solution(const Solution& oldCopy)
  *  ************************************************************************ */
 Solution::~Solution()
 {
-	// delete the approximation.
-	if(solution)
-		ArrayUtils<double>::deltwotensor(solution);
-	solution = NULL;
+	// The memory for the approximation is released by the Tensor.
 }
 
 /** ************************************************************************
@@ -111,34 +107,30 @@ Solution::~Solution()
  * Returns the value of the approximation for the indicated row.
  *
  * @param row The row number to use.
- * @return a double precision value, solution[row]
+ * @return a double precision value, solution(row)
  * ************************************************************************ */
 double& Solution::operator()(int row,int col)
 {
-	return(solution[row][col]);
+	return(solution(row,col));
 }
 
 /** ************************************************************************
  * The equals operator for the Solution class.
  * 
- * Returns a new Solution object that is identical to the Solution
- * object passed to it.
+ * Copies the entries of the Solution object passed to it into the
+ * current object. If the two have a different number of grid points
+ * the space is allocated again and the number of grid points is
+ * copied as well.
  *
  * @param vector The Solution argument to copy
- * @return An object from the Solution class.
+ * @return A reference to the current object.
  * ************************************************************************ */
-Solution Solution::operator=(const Solution& vector)
+Solution& Solution::operator=(const Solution& vector)
 {
-	int row;
-	int col;
-	int N = getN();
 	if(this != &vector)
 		{
-			for(row=N;row>=0;--row)
-				for(col=N;col>=0;--col)
-					{
-						this->setEntry(vector.getEntry(row,col),row,col);
-					}
+			solution = vector.solution;
+			setN(vector.getN());
 		}
 	return(*this);
 }
@@ -146,14 +138,14 @@ Solution Solution::operator=(const Solution& vector)
 /** ************************************************************************
  * The equals operator for the Solution class.
  * 
- * Returns a new Solution object in which every entry in the vector is
- * the same as the double precision number passed to it.
+ * Sets every entry in the current object to the double precision
+ * number passed to it.
  *
  * @overload
  * @param value The value to copy into the vector.
- * @return An object from the Solution class.
+ * @return A reference to the current object.
  * ************************************************************************ */
-Solution Solution::operator=(const double& value)
+Solution& Solution::operator=(const double& value)
 {
 	int row;
 	int col;
@@ -270,23 +262,20 @@ double Solution::operator*(const Solution& vector)
 /** ************************************************************************
  * The scalar multiplication operator for "*=" for the Solution class.
  * 
- * Returns a new Solution object which is the scalar product of an
- * object from the Solution class and a single double precision
- * number.
+ * Multiplies every entry in the current object by a single double
+ * precision number.
  *
  * @param value Scalar value to multiply every entry in the current vector.
- * @return An object from the Solution class.
+ * @return A reference to the current object.
  * ************************************************************************ */
-Solution Solution::operator*=(const double& value)
+Solution& Solution::operator*=(const double& value)
 {
-	int N = getN();
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				this->setEntry(this->getEntry(row,col)*value,row,col);
-			}
+	std::size_t lupe;
+	std::size_t size = solution.getSize();
+	double * TENSORRESTRICT u = solution.data();
+
+	for(lupe=0;lupe<size;++lupe)
+		u[lupe] *= value;
 
 	return(*this);
 }
@@ -294,22 +283,20 @@ Solution Solution::operator*=(const double& value)
 /** ************************************************************************
  * The subtraction operator for "-=" for the Solution class.
  * 
- * Returns a new Solution object which is found by subtracting each
- * element from the passed Solution object from the current object.
+ * Subtracts each element from the passed Solution object from the
+ * current object.
  *
  * @param vector The Solution object to subtract from this object.
- * @return An object from the Solution class.
+ * @return A reference to the current object.
  * ************************************************************************ */
-Solution Solution::operator-=(const Solution& vector)
+Solution& Solution::operator-=(const Solution& vector)
 {
-	int N = vector.getN();
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				this->setEntry(this->getEntry(row,col)-vector.getEntry(row,col),row,col);
-			}
+	std::size_t lupe;
+	std::size_t size = solution.getSize();
+	double * TENSORRESTRICT u = solution.data();
+	const double * TENSORRESTRICT v = vector.solution.data();
+	for(lupe=0;lupe<size;++lupe)
+		u[lupe] -= v[lupe];
 
 	return(*this);
 }
@@ -317,22 +304,20 @@ Solution Solution::operator-=(const Solution& vector)
 /** ************************************************************************
  * The addition operator for "+=" for the Solution class.
  * 
- * Returns a new Solution object which is found by adding each
- * element from the passed Solution object to the current object.
+ * Adds each element from the passed Solution object to the current
+ * object.
  *
  * @param vector The Solution object to add to this object.
- * @return An object from the Solution class.
+ * @return A reference to the current object.
  * ************************************************************************ */
-Solution Solution::operator+=(const Solution& vector)
+Solution& Solution::operator+=(const Solution& vector)
 {
-	int N = vector.getN();
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				this->setEntry(this->getEntry(row,col)+vector.getEntry(row,col),row,col);
-			}
+	std::size_t lupe;
+	std::size_t size = solution.getSize();
+	double * TENSORRESTRICT u = solution.data();
+	const double * TENSORRESTRICT v = vector.solution.data();
+	for(lupe=0;lupe<size;++lupe)
+		u[lupe] += v[lupe];
 
 	return(*this);
 }
@@ -365,16 +350,15 @@ Solution operator*(const double &value,class Solution vector)
  * ************************************************************************ */
 double Solution::dot(const Solution& v1,const Solution& v2)
 {
-	int N = v1.getN();
+	// The padding at the end of the rows is always zero, so the
+	// whole block can be used.
+	std::size_t lupe;
+	std::size_t size = v1.solution.getSize();
+	const double * TENSORRESTRICT u = v1.solution.data();
+	const double * TENSORRESTRICT v = v2.solution.data();
 	double dotProduct = 0.0;
-	int row;
-	int col;
-	//std::cout << "dot product" << std::endl;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				dotProduct += v1.getEntry(row,col)*v2.getEntry(row,col);
-			}
+	for(lupe=0;lupe<size;++lupe)
+		dotProduct += u[lupe]*v[lupe];
 	return(dotProduct);
 }
 
@@ -390,17 +374,7 @@ double Solution::dot(const Solution& v1,const Solution& v2)
  * ************************************************************************ */
 double Solution::dot(Solution* v1,Solution* v2)
 {
-
-	double dotProduct = 0.0;
-	int N = v1->getN();
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				dotProduct += v1->getEntry(row,col)*v2->getEntry(row,col);
-			}
-	return(dotProduct);
+	return(dot(*v1,*v2));
 }
 
 
@@ -414,16 +388,7 @@ double Solution::dot(Solution* v1,Solution* v2)
  * ************************************************************************ */
 double Solution::norm(const Solution& v1)
 {
-	int N = v1.getN();
-	double norm = 0.0;
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				norm += v1.getEntry(row,col)*v1.getEntry(row,col);
-			}
-	return(sqrt(norm));
+	return(sqrt(dot(v1,v1)));
 }
 
 /** ************************************************************************
@@ -436,16 +401,7 @@ double Solution::norm(const Solution& v1)
  * ************************************************************************ */
 double Solution::norm()
 {
-	int N = getN();
-	double norm = 0.0;
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				norm += getEntry(row,col)*getEntry(row,col);
-			}
-	return(sqrt(norm));
+	return(sqrt(dot(*this,*this)));
 }
 
 
@@ -461,13 +417,57 @@ double Solution::norm()
 void Solution::axpy(Solution* vector,
 					double multiplier)
 {
-	int N = vector->getN();
-	int row;
-	int col;
-	for(row=N;row>=0;--row)
-		for(col=N;col>=0;--col)
-			{
-				setEntry(getEntry(row,col)+multiplier*vector->getEntry(row,col),
-						 row,col);
-			}
+	std::size_t lupe;
+	std::size_t size = solution.getSize();
+	double * TENSORRESTRICT u = solution.data();
+	const double * TENSORRESTRICT v = vector->solution.data();
+	for(lupe=0;lupe<size;++lupe)
+		u[lupe] += multiplier*v[lupe];
+}
+
+
+/** ************************************************************************
+ * The method to write the approximation to a binary file.
+ *
+ * The file has the number of grid points, the Chebyshev nodes, and the
+ * values of the approximation. See the FieldFile class for the format.
+ *
+ * @param fileName The name of the file.
+ * @return True if the file was written.
+ * ************************************************************************ */
+bool Solution::write(const std::string &fileName) const
+{
+	std::shared_ptr<const ChebyshevMatrices<double> > matrices = ChebyshevCache<double>::get(N);
+	return(FieldFile::write(fileName,solution,matrices->getNodes(),matrices->getGrid()));
+}
+
+
+/** ************************************************************************
+ * The method to queue the approximation to be written to a binary
+ * file by a background thread. The approximation is copied before the
+ * method returns, so it can be changed right away.
+ *
+ * @param writer The writer that owns the background thread.
+ * @param fileName The name of the file.
+ * ************************************************************************ */
+void Solution::write(SnapshotWriter &writer,const std::string &fileName) const
+{
+	std::shared_ptr<const ChebyshevMatrices<double> > matrices = ChebyshevCache<double>::get(N);
+	writer.submit(fileName,solution,matrices->getNodes(),matrices->getGrid());
+}
+
+
+/** ************************************************************************
+ * The method to read the approximation from a binary file.
+ *
+ * The file must have the same number of grid points as the
+ * approximation, and otherwise the approximation is not changed.
+ *
+ * @param fileName The name of the file.
+ * @return True if the approximation was read.
+ * ************************************************************************ */
+bool Solution::read(const std::string &fileName)
+{
+	FieldFile file;
+	return(file.read(fileName) && file.copyTo(solution));
 }
@@ -52,8 +52,12 @@
  *
  * ********************************************************************************* */
 
+#include <string>
 #include "poisson.h"
 #include "../util.h"
+#include "../tensor.h"
+
+class SnapshotWriter;
 
 class Solution
 {
@@ -65,15 +69,15 @@ public:
 
 	// Now define the operators associated with the class.
 	double& operator()(int row,int col);           //< The parenthesis operator for access to data elements
-	Solution operator=(const Solution& vector);    //< Assignment operator for copying another Solution
-	Solution operator=(const double& value);       //< Assignment operator for assigning a single value to all elements.
+	Solution& operator=(const Solution& vector);   //< Assignment operator for copying another Solution
+	Solution& operator=(const double& value);      //< Assignment operator for assigning a single value to all elements.
 	Solution operator+(const Solution& vector);    //< Operator for adding two Solution objects
 	Solution operator-(const Solution& vector);    //< Operator for subtracting two Solution objects.
 	Solution operator*(const double& value);       //< Operator for scalar multiplication.
 	double   operator*(const Solution& vector);    //< Operator for the dot product
-	Solution operator*=(const double& value);      //< Operator for scalar multiplication in place.
-	Solution operator-=(const Solution& vector);   //< Operator for subtracting another Solution object.
-	Solution operator+=(const Solution& vector);   //< Operator for adding another Solution object.
+	Solution& operator*=(const double& value);     //< Operator for scalar multiplication in place.
+	Solution& operator-=(const Solution& vector);  //< Operator for subtracting another Solution object.
+	Solution& operator+=(const Solution& vector);  //< Operator for adding another Solution object.
 
 
 	/** Definition of the dot product of two approximation vectors. */
@@ -87,6 +91,11 @@ public:
 	/** Definition of the axpy procedure. */
 	void axpy(Solution* vector,double multiplier);
 
+	/** Write the approximation to, and read it from, a binary file. */
+	bool write(const std::string &fileName) const;
+	void write(SnapshotWriter &writer,const std::string &fileName) const;
+	bool read(const std::string &fileName);
+
 	/** ************************************************************************
 	 * The method to set the value of the entry in a row of the solution.
 	 * 
@@ -98,7 +107,7 @@ public:
 	 * ************************************************************************ */
 	void setEntry(double value,int row,int col)
 	{
-		solution[row][col] = value;
+		solution(row,col) = value;
 	}
 
 
@@ -132,7 +141,39 @@ public:
 	*/
 	inline double getEntry(int row,int col) const
 	{
-		return(solution[row][col]);
+		return(solution(row,col));
+	}
+
+	/**
+		 Method to get the values of the approximation as one block of
+		 memory. The padding at the end of each row is part of the block.
+
+		 @return The first value in the block.
+	*/
+	double *data()
+	{
+		return(solution.data());
+	}
+
+	/**
+		 Method to get the values of the approximation as one block of
+		 memory that cannot be changed.
+
+		 @return The first value in the block.
+	*/
+	const double *data() const
+	{
+		return(solution.data());
+	}
+
+	/**
+		 Method to get the number of values in the block given by data().
+
+		 @return The number of values including the padding.
+	*/
+	std::size_t getSize() const
+	{
+		return(solution.getSize());
 	}
 
 protected:
@@ -144,7 +185,7 @@ private:
 	// Define the size of the vector and the vector that will contain
 	// the information.
 	int N;                      //< The number of grid points.
-	double **solution = NULL;   //< The vector that contains the approximation.
+	Tensor<double,2> solution;  //< The grid that contains the approximation.
 
 };
 
@@ -33,32 +33,56 @@
 #include "poisson.h"
 #include "solution.h"
 #include "preconditioner.h"
+#include "multigrid.h"
+#include "alternatingDirection.h"
 #include "../GMRES.h"
+#include "../pool.h"
+#include "../monitor.h"
+#include "../counters.h"
+#include "../trace.h"
+#include "../checkpoint.h"
+#include "../snapshot.h"
+#include "../options.h"
 
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstdlib>
 
 #define DERIVPOWER 50.0
 
 int main(int argc,char **argv)
 {
 
-    Poisson *elliptical = new Poisson;   // The operator to invert.
-	Solution *x = new Solution(NUMBER);  // The approximation to calculate.
-	Solution *b = new Solution(NUMBER);  // The forcing function for the r.h.s.
+	// Read the number of grid points and the parameters for the solver.
+	SolverOptions options(NUMBER,500,10,1.0E-8);
+	if(!options.parse(argc,argv))
+		return(2);
+	int number = options.getNumber();   // The number of grid points.
+
+    Poisson *elliptical = new Poisson(number); // The operator to invert.
+	Solution *x = new Solution(number);  // The approximation to calculate.
+	Solution *b = new Solution(number);  // The forcing function for the r.h.s.
+#ifdef MULTIGRID
+	Multigrid *pre =
+		new Multigrid(number);           // The p-multigrid preconditioner for the system.
+#elif defined(ALTERNATINGDIRECTION)
+	AlternatingDirection *pre =
+		new AlternatingDirection(number);  // The ADI line preconditioner for the system.
+#else
 	Preconditioner *pre = 
-		new Preconditioner(NUMBER);      // The preconditioner for the system.
+		new Preconditioner(number);      // The preconditioner for the system.
+#endif
 
-	int restart = 10;                    // Number of restarts to allow
-	int maxIt   = 500;                   // Dimension of the Krylov subspace
-	double tol  = 1.0E-8;                // How close to make the approximation.
+	int restart = options.getRestarts(); // Number of restarts to allow
+	int maxIt   = options.getKrylovDimension(); // Dimension of the Krylov subspace
+	double tol  = options.getTolerance(); // How close to make the approximation.
 
 	int row;
 	int col;
-	for(row=0;row<=NUMBER;++row)
+	for(row=0;row<=number;++row)
 		{
-			for(col=1;col<NUMBER;++col)
+			for(col=1;col<number;++col)
 				{
 					// initialize the r.h.s to be something we know the
 					// solution for. Also, set the initial approximation if
@@ -73,27 +97,96 @@ int main(int argc,char **argv)
 			// redundant but may need to be changed for different
 			// forcing functions above.
 			(*b)(row,0)      = 0.0;
-			(*b)(row,NUMBER) = 0.0;
+			(*b)(row,number) = 0.0;
 		}
 
 	// Set the left and right boundary conditions separately.
-	for(col=0;col<=NUMBER;++col)
+	for(col=0;col<=number;++col)
 		{
 			(*b)(0,col)      = 0.0;
-			(*b)(NUMBER,col) = 0.0;
+			(*b)(number,col) = 0.0;
 		}
 
-	// Find an approximation to the system!
-	int result= GMRES(elliptical,x,b,pre,maxIt,restart,tol);
+	// Find an approximation to the system! The temporary vectors used
+	// within the solve are drawn from a pool that is released at the
+	// end of the solve. The monitor keeps the time spent in each phase
+	// and reads the hardware counters if they are available. The flops
+	// are given for the phases where they are known. If the environment
+	// names a checkpoint file the solve resumes from it, keeps it up to
+	// date, and removes it once the solve has converged.
+	const char *checkpointFile = std::getenv(CHECKPOINTENVIRONMENT);
+	Checkpoint checkpoint((checkpointFile!=NULL) ? checkpointFile : "",CHECKPOINTINTERVAL);
+	CounterMonitor monitor;
+	monitor.setFlops(MONITORAPPLY,4.0*(number+1)*(number-1)*(number-1));
+	monitor.setFlops(MONITORPRECONDITION,1.0*(number-1)*(number-1));
+	int result;
+	unsigned long poolRequests;
+	unsigned long poolFresh;
+	unsigned long systemCalls = MemoryPool::getTotalSystemAllocations();
+	{
+		MemoryPoolScope scope;
+		result       = GMRES(elliptical,x,b,pre,maxIt,restart,tol,monitor,checkpoint);
+		poolRequests = scope.getPool()->getRequests();
+		poolFresh    = scope.getPool()->getFresh();
+	}
+	systemCalls = MemoryPool::getTotalSystemAllocations()-systemCalls;
+	if(checkpoint.isResumed())
+		std::cerr << "Resumed from " << checkpoint.getFileName() << std::endl;
+	if(result>0)
+		checkpoint.remove();
 
 	std::cerr << "Iterations: " << result << " residual: " << tol << std::endl;
+	std::cerr << "Allocations: " << poolRequests << " from the pool, "
+			  << poolFresh << " new blocks, " << systemCalls << " system calls" << std::endl;
+
+	const SolveReport &report = monitor.getReport();
+	std::cerr << "Restarts: " << report.restarts << " relative residual: " << report.residual
+			  << " time: " << report.totalSeconds << " s" << std::endl;
+	int phase;
+	for(phase=0;phase<MONITORPHASES;++phase)
+		std::cerr << "  " << SolveReport::phaseName(phase) << ": " << report.seconds[phase] << " s, "
+				  << report.cycles[phase] << " cycles, " << report.calls[phase] << " calls" << std::endl;
+
+	if(monitor.getCounters().isAvailable())
+		for(phase=0;phase<MONITORPHASES;++phase)
+			std::cerr << "  " << SolveReport::phaseName(phase) << ": IPC " << monitor.instructionsPerCycle(phase)
+					  << ", LLC misses " << monitor.getCount(phase,COUNTERCACHEMISSES)
+					  << ", estimated bytes/flop " << monitor.bytesPerFlop(phase) << std::endl;
+	else
+		std::cerr << "Performance counters are not available." << std::endl;
+
+	// If a file name is given, solve the system again from zero and
+	// write a timeline of every phase that can be opened in a trace
+	// viewer.
+	if(!options.getTraceFile().empty())
+		{
+			Tracer tracer;
+			TraceMonitor tracing(tracer);
+			Solution traced(number);
+			traced = 0.0;
+			{
+				MemoryPoolScope scope;
+				GMRES(elliptical,&traced,b,pre,maxIt,restart,tol,tracing);
+			}
+			std::ofstream traceFile(options.getTraceFile().c_str());
+			tracer.writeJSON(traceFile);
+			std::cerr << "Trace: " << options.getTraceFile() << ", " << tracer.getDropped() << " events dropped" << std::endl;
+		}
 #define SOLUTION
 #ifdef SOLUTION
+	// The approximation is written in the binary field format, which
+	// the fieldText program turns into text. The file is written on a
+	// background thread while the text file is made. The text file with
+	// the true solution and the right hand side is only written if
+	// SOLUTIONTEXT is defined.
+	SnapshotWriter snapshots(1);
+	x->write(snapshots,"solution.fld");
+#ifdef SOLUTIONTEXT
 	std::ofstream csvFile;
 	csvFile.open ("testing.csv");
 //std::cout << "x,approx,true," << result << std::endl;
-	for(row=0;row<=NUMBER;++row)
-		for(col=0;col<=NUMBER;++col)
+	for(row=0;row<=number;++row)
+		for(col=0;col<=number;++col)
 		{
 			double xgrid = elliptical->getX(row);
 			double ygrid = elliptical->getX(col);
@@ -101,10 +194,14 @@ int main(int argc,char **argv)
 					 << (*x)(row,col) << ","
 					 << (1.0-xgrid*xgrid)*(1.0-ygrid*ygrid) << ","
 					 << (*b)(row,col)
-					 << std::endl;
+					 << '\n';
 		}
 	csvFile.close();
 #endif
+	snapshots.flush();
+	if(snapshots.getFailures()>0)
+		std::cerr << "The file solution.fld could not be written." << std::endl;
+#endif
 
 
 	return(1);
@@ -0,0 +1,439 @@
+#ifndef FIELDROUTINEDEFINITIONS
+#define FIELDROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file field.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to write and read the values of an approximation in a binary
+ * file.
+ *
+ * This is the code file for the FieldFile class. The file is included
+ * by the header, so every method that is not a template is declared
+ * inline.
+ *
+ *
+ * @brief Code file for the binary files of approximations.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "field.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the FieldFile class.
+ *
+ * Nothing has been read.
+ * ************************************************************************ */
+inline FieldFile::FieldFile()
+{
+	rank = 0;
+	grid = 0;
+	int lupe;
+	for(lupe=0;lupe<FIELDRANK;++lupe)
+		extent[lupe] = 1;
+}
+
+
+/** ************************************************************************
+ * Write an approximation to a file.
+ *
+ * The rows of the tensor are copied without their padding into a
+ * block of FIELDCHUNKBYTES, and the block is written each time it is
+ * full. On a big endian machine the bytes are reversed in the block.
+ *
+ * @param fileName The name of the file.
+ * @param values The values of the approximation.
+ * @param nodes The nodes of the grid. There must be one for every point in a dimension.
+ * @param grid The type of grid.
+ * @return True if the file was written.
+ * ************************************************************************ */
+template <int Rank>
+bool FieldFile::write(const std::string &fileName,const Tensor<double,Rank> &values,
+											const Tensor<double,1> &nodes,int grid)
+{
+	static_assert((Rank>=1) && (Rank<=FIELDRANK),"The rank must be one or two.");
+
+	int shape[FIELDRANK];
+	int lupe;
+	for(lupe=0;lupe<FIELDRANK;++lupe)
+		shape[lupe] = (lupe<Rank) ? values.getExtent(lupe) : 1;
+	FieldHeader header = makeHeader(Rank,shape,grid);
+
+	std::size_t columns = (std::size_t)values.getExtent(Rank-1);
+	std::size_t rows    = (Rank>1) ? (std::size_t)values.getExtent(0) : 1;
+	std::size_t points  = (std::size_t)nodes.getExtent(0);
+
+	bool swap = !littleEndian();
+	FieldHeader written = header;
+	if(swap)
+		swapHeader(written);
+
+	std::string temporary;
+	std::FILE *fp = openTemporary(fileName,temporary);
+	if(fp==NULL)
+		return(false);
+
+	// The header and the nodes go in the first block, and then the
+	// rows are added until the block is full.
+	std::vector<char> chunk(FIELDCHUNKBYTES);
+	if(header.valuesOffset>chunk.size())
+		chunk.resize((std::size_t)header.valuesOffset);
+	std::memset(chunk.data(),0,(std::size_t)header.valuesOffset);
+	std::memcpy(chunk.data(),&written,sizeof(FieldHeader));
+	std::memcpy(chunk.data()+header.nodesOffset,nodes.data(),points*sizeof(double));
+	if(swap)
+		swapBytes(chunk.data()+header.nodesOffset,sizeof(double),points);
+	std::size_t used = (std::size_t)header.valuesOffset;
+
+	bool success = true;
+	std::size_t rowBytes = columns*sizeof(double);
+	std::size_t row;
+	for(row=0;success&&(row<rows);++row)
+		{
+			if((used>0) && (used+rowBytes>chunk.size()))
+				{
+					success = (std::fwrite(chunk.data(),1,used,fp)==used);
+					used = 0;
+				}
+			if(rowBytes>chunk.size())
+				chunk.resize(rowBytes);
+			const double *start = values.data()+((Rank>1) ? row*values.getStride(0) : 0);
+			std::memcpy(chunk.data()+used,start,rowBytes);
+			if(swap)
+				swapBytes(chunk.data()+used,sizeof(double),columns);
+			used += rowBytes;
+		}
+	if(success && (used>0))
+		success = (std::fwrite(chunk.data(),1,used,fp)==used);
+
+	return(closeTemporary(fp,temporary,fileName,success));
+}
+
+
+/** ************************************************************************
+ * Write an approximation whose values are already stored without
+ * padding, with the last index changing fastest.
+ *
+ * The header, the nodes and the values are each written with one call
+ * straight from the memory that holds them, so no block is allocated.
+ * On a big endian machine the bytes of the nodes and the values are
+ * reversed in place, so the arrays are changed.
+ *
+ * @param fileName The name of the file.
+ * @param rank The number of dimensions.
+ * @param extent The number of points in each dimension.
+ * @param values The values of the approximation.
+ * @param nodes The nodes of the grid. There must be one for every point in a dimension.
+ * @param grid The type of grid.
+ * @return True if the file was written.
+ * ************************************************************************ */
+inline bool FieldFile::write(const std::string &fileName,int rank,const int *extent,
+														 double *values,double *nodes,int grid)
+{
+	FieldHeader header = makeHeader(rank,extent,grid);
+	std::size_t points = (std::size_t)extent[0];
+	std::size_t count  = (std::size_t)((header.fileBytes-header.valuesOffset)/sizeof(double));
+
+	FieldHeader written = header;
+	if(!littleEndian())
+		{
+			swapHeader(written);
+			swapBytes(nodes,sizeof(double),points);
+			swapBytes(values,sizeof(double),count);
+		}
+
+	std::string temporary;
+	std::FILE *fp = openTemporary(fileName,temporary);
+	if(fp==NULL)
+		return(false);
+
+	// The gaps before the nodes and the values are written from a
+	// block of zeros.
+	static const char zeros[ARRAYALIGNMENT] = {0};
+	std::size_t nodesGap  = (std::size_t)header.nodesOffset-sizeof(FieldHeader);
+	std::size_t valuesGap = (std::size_t)(header.valuesOffset-header.nodesOffset)-points*sizeof(double);
+	bool success = (std::fwrite(&written,sizeof(FieldHeader),1,fp)==1)
+		&& (std::fwrite(zeros,1,nodesGap,fp)==nodesGap)
+		&& (std::fwrite(nodes,sizeof(double),points,fp)==points)
+		&& (std::fwrite(zeros,1,valuesGap,fp)==valuesGap)
+		&& (std::fwrite(values,sizeof(double),count,fp)==count);
+
+	return(closeTemporary(fp,temporary,fileName,success));
+}
+
+
+/** ************************************************************************
+ * Read a file into the class. The nodes and the values are read with
+ * one call each.
+ *
+ * @param fileName The name of the file.
+ * @return True if the file was read.
+ * ************************************************************************ */
+inline bool FieldFile::read(const std::string &fileName)
+{
+	std::FILE *fp = std::fopen(fileName.c_str(),"rb");
+	if(fp==NULL)
+		return(false);
+
+	bool swap = !littleEndian();
+	FieldHeader header;
+	bool valid = (std::fread(&header,sizeof(FieldHeader),1,fp)==1);
+	if(valid && swap)
+		swapHeader(header);
+	valid = valid
+		&& (std::memcmp(header.magic,"GMRESFLD",8)==0)
+		&& (header.version==FIELDVERSION)
+		&& (header.rank>=1) && (header.rank<=FIELDRANK)
+		&& (header.extent[0]>0) && (header.extent[1]>0);
+
+	std::size_t points = 0;
+	std::size_t count  = 0;
+	if(valid)
+		{
+			points = (std::size_t)header.extent[0];
+			count  = (std::size_t)header.extent[0]*(std::size_t)header.extent[1];
+			valid  = (header.valuesOffset>=header.nodesOffset+points*sizeof(double))
+				&& (header.fileBytes==header.valuesOffset+count*sizeof(double));
+		}
+
+	std::vector<double> newNodes(points);
+	std::vector<double> newValues(count);
+	if(valid)
+		valid = (std::fseek(fp,(long)header.nodesOffset,SEEK_SET)==0)
+			&& (std::fread(newNodes.data(),sizeof(double),points,fp)==points)
+			&& (std::fseek(fp,(long)header.valuesOffset,SEEK_SET)==0)
+			&& (std::fread(newValues.data(),sizeof(double),count,fp)==count);
+	std::fclose(fp);
+	if(!valid)
+		return(false);
+
+	if(swap)
+		{
+			swapBytes(newNodes.data(),sizeof(double),points);
+			swapBytes(newValues.data(),sizeof(double),count);
+		}
+
+	rank = (int)header.rank;
+	grid = header.grid;
+	int lupe;
+	for(lupe=0;lupe<FIELDRANK;++lupe)
+		extent[lupe] = header.extent[lupe];
+	nodes.swap(newNodes);
+	values.swap(newValues);
+	return(true);
+}
+
+
+/** ************************************************************************
+ * Copy the values that were read into a tensor with the same shape.
+ *
+ * @param copy The tensor that gets the values.
+ * @return True if the shape matched and the values were copied.
+ * ************************************************************************ */
+template <int Rank>
+bool FieldFile::copyTo(Tensor<double,Rank> &copy) const
+{
+	if(Rank!=rank)
+		return(false);
+	int lupe;
+	for(lupe=0;lupe<Rank;++lupe)
+		if(copy.getExtent(lupe)!=extent[lupe])
+			return(false);
+
+	std::size_t columns = (std::size_t)extent[Rank-1];
+	std::size_t rows    = values.size()/columns;
+	std::size_t row;
+	for(row=0;row<rows;++row)
+		std::memcpy(copy.data()+((Rank>1) ? row*copy.getStride(0) : 0),
+								values.data()+row*columns,columns*sizeof(double));
+	return(true);
+}
+
+
+/** ************************************************************************
+ * Write the file that was read as text. Each line has the nodes for a
+ * point followed by the value, separated by commas. The lines end
+ * with a newline rather than std::endl so the stream is not flushed
+ * for every line.
+ *
+ * @param output The stream to write to.
+ * ************************************************************************ */
+inline void FieldFile::writeText(std::ostream &output) const
+{
+	std::size_t columns = (std::size_t)extent[rank-1];
+	std::size_t lupe;
+	for(lupe=0;lupe<values.size();++lupe)
+		{
+			if(rank>1)
+				output << nodes[lupe/columns] << ",";
+			output << nodes[lupe%columns] << "," << values[lupe] << '\n';
+		}
+	output.flush();
+}
+
+
+/** ************************************************************************
+ * Build the header for an approximation. The nodes and the values
+ * start on ARRAYALIGNMENT byte boundaries.
+ *
+ * @param rank The number of dimensions.
+ * @param extent The number of points in each dimension.
+ * @param grid The type of grid.
+ * @return The header in the byte order of the machine.
+ * ************************************************************************ */
+inline FieldHeader FieldFile::makeHeader(int rank,const int *extent,int grid)
+{
+	FieldHeader header;
+	std::memset(&header,0,sizeof(FieldHeader));
+	std::memcpy(header.magic,"GMRESFLD",8);
+	header.version = FIELDVERSION;
+	header.rank    = rank;
+	header.grid    = grid;
+	std::size_t count = 1;
+	int lupe;
+	for(lupe=0;lupe<FIELDRANK;++lupe)
+		{
+			header.extent[lupe] = (lupe<rank) ? extent[lupe] : 1;
+			count *= (std::size_t)header.extent[lupe];
+		}
+
+	std::size_t points  = (std::size_t)header.extent[0];
+	header.nodesOffset  = (sizeof(FieldHeader)+ARRAYALIGNMENT-1)/ARRAYALIGNMENT*ARRAYALIGNMENT;
+	header.valuesOffset = (header.nodesOffset+points*sizeof(double)+ARRAYALIGNMENT-1)/ARRAYALIGNMENT*ARRAYALIGNMENT;
+	header.fileBytes    = header.valuesOffset+count*sizeof(double);
+	return(header);
+}
+
+
+/** ************************************************************************
+ * Open a temporary file next to the file that is written. The name
+ * has the process id added so that two programs do not write to the
+ * same temporary file.
+ *
+ * @param fileName The name of the file that is written.
+ * @param temporary Set to the name of the temporary file.
+ * @return The open file, or NULL if it could not be opened.
+ * ************************************************************************ */
+inline std::FILE *FieldFile::openTemporary(const std::string &fileName,std::string &temporary)
+{
+	char suffix[32];
+	std::snprintf(suffix,sizeof(suffix),".%ld.tmp",(long)getpid());
+	temporary = fileName + suffix;
+	return(std::fopen(temporary.c_str(),"wb"));
+}
+
+
+/** ************************************************************************
+ * Close a temporary file and give it its final name. The temporary
+ * file is removed if anything failed.
+ *
+ * @param fp The open file.
+ * @param temporary The name of the temporary file.
+ * @param fileName The name of the file that is written.
+ * @param success True if everything was written.
+ * @return True if the file was written and renamed.
+ * ************************************************************************ */
+inline bool FieldFile::closeTemporary(std::FILE *fp,const std::string &temporary,
+														 const std::string &fileName,bool success)
+{
+	success = (std::fclose(fp)==0) && success;
+	if(success)
+		success = (std::rename(temporary.c_str(),fileName.c_str())==0);
+	if(!success)
+		std::remove(temporary.c_str());
+	return(success);
+}
+
+
+/** ************************************************************************
+ * Determine whether or not the machine is little endian.
+ *
+ * @return True if the lowest byte is stored first.
+ * ************************************************************************ */
+inline bool FieldFile::littleEndian()
+{
+	std::uint32_t value = 0x01020304;
+	unsigned char first;
+	std::memcpy(&first,&value,1);
+	return(first==0x04);
+}
+
+
+/** ************************************************************************
+ * Reverse the order of the bytes in every item of an array.
+ *
+ * @param data The array.
+ * @param size The number of bytes in an item.
+ * @param count The number of items.
+ * ************************************************************************ */
+inline void FieldFile::swapBytes(void *data,std::size_t size,std::size_t count)
+{
+	unsigned char *current = (unsigned char *)data;
+	std::size_t item;
+	std::size_t lupe;
+	for(item=0;item<count;++item,current+=size)
+		for(lupe=0;lupe<size/2;++lupe)
+			{
+				unsigned char tmp       = current[lupe];
+				current[lupe]           = current[size-1-lupe];
+				current[size-1-lupe]    = tmp;
+			}
+}
+
+
+/** ************************************************************************
+ * Reverse the order of the bytes in every number in a header.
+ *
+ * @param header The header.
+ * ************************************************************************ */
+inline void FieldFile::swapHeader(FieldHeader &header)
+{
+	swapBytes(&header.version,sizeof(std::uint32_t),1);
+	swapBytes(&header.rank,sizeof(std::uint32_t),1);
+	swapBytes(&header.grid,sizeof(std::int32_t),1);
+	swapBytes(header.extent,sizeof(std::int32_t),FIELDRANK);
+	swapBytes(&header.reserved,sizeof(std::uint32_t),1);
+	swapBytes(&header.nodesOffset,sizeof(std::uint64_t),1);
+	swapBytes(&header.valuesOffset,sizeof(std::uint64_t),1);
+	swapBytes(&header.fileBytes,sizeof(std::uint64_t),1);
+}
+
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef FIELDROUTINE
+#define FIELDROUTINE
+
+
+/** *********************************************************************************
+ * @file field.h
+ * @class FieldFile
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to write and read the values of an approximation in a binary
+ * file.
+ *
+ * This is the definition (header) file for the FieldFile class. A
+ * file starts with a header that has the rank, the number of points
+ * in each dimension, and the type of grid. The header is followed by
+ * the nodes of the grid and then by the values, with the last index
+ * changing fastest. Every number in the file is little endian, and the
+ * values are doubles without the padding used in memory. The values
+ * are gathered into large blocks before they are written, and a file
+ * is written to a temporary name and then renamed. Values that are
+ * already stored without padding can be written without the blocks.
+ *
+ * A file that is read is kept in the class, and it can be written as
+ * text with one line for every point for use with a plotting program.
+ *
+ *
+ * @brief Header file for the binary files of approximations.
+ *
+ * ********************************************************************************* */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "tensor.h"
+
+// The version of the file format.
+#define FIELDVERSION 1
+
+// The largest rank of an approximation that can be kept in a file.
+#define FIELDRANK 2
+
+// The number of bytes gathered before each write.
+#define FIELDCHUNKBYTES 1048576
+
+/**
+	 The header at the start of a file. Every field is little endian.
+ */
+struct FieldHeader
+{
+	char          magic[8];             //< The string GMRESFLD.
+	std::uint32_t version;              //< The version of the file format.
+	std::uint32_t rank;                 //< The number of dimensions.
+	std::int32_t  grid;                 //< The type of grid.
+	std::int32_t  extent[FIELDRANK];    //< The number of points in each dimension, one if not used.
+	std::uint32_t reserved;             //< Unused, set to zero.
+	std::uint64_t nodesOffset;          //< The position of the nodes from the start of the file.
+	std::uint64_t valuesOffset;         //< The position of the values from the start of the file.
+	std::uint64_t fileBytes;            //< The size of the file.
+};
+
+
+class FieldFile
+{
+
+public:
+	FieldFile();                                             //< Default constructor for the class
+
+	template <int Rank>
+	static bool write(const std::string &fileName,const Tensor<double,Rank> &values,
+										const Tensor<double,1> &nodes,int grid); //< Write an approximation to a file.
+	static bool write(const std::string &fileName,int rank,const int *extent,
+										double *values,double *nodes,int grid);  //< Write values that have no padding.
+	bool read(const std::string &fileName);                  //< Read a file into the class.
+	template <int Rank>
+	bool copyTo(Tensor<double,Rank> &values) const;          //< Copy the values that were read into a tensor.
+	void writeText(std::ostream &output) const;              //< Write the nodes and values as text.
+
+	/**
+		 Method to get the number of dimensions of the file that was read.
+
+		 @return The rank, or zero if nothing has been read.
+	 */
+	int getRank() const
+	{
+		return(rank);
+	}
+
+	/**
+		 Method to get the number of points in a dimension.
+
+		 @param dimension The dimension.
+		 @return The number of points.
+	 */
+	int getExtent(int dimension) const
+	{
+		return(extent[dimension]);
+	}
+
+	/**
+		 Method to get the type of grid.
+
+		 @return The type of grid given when the file was written.
+	 */
+	int getGrid() const
+	{
+		return(grid);
+	}
+
+	/**
+		 Method to get the nodes of the grid.
+
+		 @return The nodes, which are the same in every dimension.
+	 */
+	const std::vector<double> &getNodes() const
+	{
+		return(nodes);
+	}
+
+	/**
+		 Method to get the values without any padding.
+
+		 @return The values with the last index changing fastest.
+	 */
+	const std::vector<double> &getValues() const
+	{
+		return(values);
+	}
+
+
+protected:
+	static bool littleEndian();                              //< True if the machine is little endian.
+	static void swapBytes(void *data,std::size_t size,std::size_t count); //< Reverse the bytes of every item.
+	static void swapHeader(FieldHeader &header);             //< Reverse the bytes of every number in a header.
+	static FieldHeader makeHeader(int rank,const int *extent,int grid); //< The header for an approximation.
+	static std::FILE *openTemporary(const std::string &fileName,std::string &temporary); //< Open a temporary file.
+	static bool closeTemporary(std::FILE *fp,const std::string &temporary,
+										const std::string &fileName,bool success); //< Close and rename a temporary file.
+
+
+private:
+
+	int rank;                           //< The number of dimensions.
+	int extent[FIELDRANK];              //< The number of points in each dimension.
+	int grid;                           //< The type of grid.
+	std::vector<double> nodes;          //< The nodes of the grid.
+	std::vector<double> values;         //< The values with the last index changing fastest.
+
+};
+
+
+#include "field.cpp"
+
+
+#endif
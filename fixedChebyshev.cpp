@@ -0,0 +1,178 @@
+#ifndef FIXEDCHEBYSHEVROUTINEDEFINITIONS
+#define FIXEDCHEBYSHEVROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file fixedChebyshev.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep the Chebyshev collocation grid points and second
+ * derivative matrix for a number of grid points that is known when the
+ * program is compiled.
+ *
+ * This is the code file for the FixedChebyshev class. Every routine
+ * can be evaluated by the compiler.
+ *
+ *
+ * @brief Code file for the Chebyshev matrices defined at compile time.
+ *
+ * ********************************************************************************* */
+
+
+#include "fixedChebyshev.h"
+
+
+/** ************************************************************************
+ * The sine of an angle from its Taylor series.
+ *
+ * The series is summed from the smallest term to the largest, which
+ * keeps the round off error small. The angle should be between 0 and
+ * pi/4.
+ *
+ * @param angle The angle in radians.
+ * @return The sine of the angle.
+ * ************************************************************************ */
+constexpr double fixedSine(double angle)
+{
+	double square = angle*angle;
+	double sum = 0.0;
+	int k = 0;
+	for(k=FIXEDCHEBYSHEVTERMS;k>0;--k)
+		sum = 1.0 - sum*square/((double)((2*k)*(2*k+1)));
+	return(angle*sum);
+}
+
+
+/** ************************************************************************
+ * The cosine of an angle from its Taylor series.
+ *
+ * The angle should be between 0 and pi/4.
+ *
+ * @param angle The angle in radians.
+ * @return The cosine of the angle.
+ * ************************************************************************ */
+constexpr double fixedCosine(double angle)
+{
+	double square = angle*angle;
+	double sum = 0.0;
+	int k = 0;
+	for(k=FIXEDCHEBYSHEVTERMS;k>0;--k)
+		sum = 1.0 - sum*square/((double)((2*k-1)*(2*k)));
+	return(sum);
+}
+
+
+/** ************************************************************************
+ * Constructor for the FixedChebyshev class.
+ *
+ * The grid points and the second derivative matrix are found using
+ * the same steps as the halfAngles and fastCheby2 methods of the
+ * ChebyshevMatrices class. The sine and cosine of the angles
+ * pi k/(2N) are found from the angles that are no larger than pi/4,
+ * and the rest are found from the symmetries. The diagonal entries are
+ * the negative of the sum of the other entries in the row.
+ *
+ * ************************************************************************ */
+template <int N>
+constexpr FixedChebyshev<N>::FixedChebyshev() : nodes(), second()
+{
+	double small[N+1] = {};
+	double s[2*N+1] = {};
+	double c[2*N+1] = {};
+	double scale[N+1] = {};
+	double xnum = (double) N;
+	double dxnum = 1.0/xnum;
+	double ends = 2.0*xnum*xnum+1.0;
+	int i = 0;
+	int col = 0;
+
+	// sin(pi k/(2N)) for k=0..N, found from the smaller angle.
+	for(i=0;i<=N;++i)
+		{
+			if(2*i<=N)
+				small[i] = fixedSine(M_PI*((double)i)*dxnum*0.5);
+			else
+				small[i] = fixedCosine(M_PI*((double)(N-i))*dxnum*0.5);
+		}
+	for(i=0;i<=N;++i)
+		{
+			s[i]     = small[i];
+			s[2*N-i] = small[i];
+			c[i]     = small[N-i];
+			c[2*N-i] = -small[N-i];
+		}
+
+	// The grid points are cos(pi i/N).
+	for(i=1;i<N;++i)
+		nodes[i] = c[2*i];
+	nodes[0] = 1.0;
+	nodes[N] = -1.0;
+
+	// The sign (-1)^j with the factor for the left and right columns.
+	for(col=0;col<=N;++col)
+		scale[col] = ((col%2==1) ? -1.0 : 1.0)*(((col==0)||(col==N)) ? 0.5 : 1.0);
+
+	for(i=0;i<=N;++i)
+		{
+			double sum = 0.0;
+			double sign = (i%2==1) ? -1.0 : 1.0;
+			for(col=0;col<=N;++col)
+				{
+					if(col==i)
+						continue;
+
+					double value = 0.0;
+					if((i==0) || (i==N))
+						{
+							// The top and bottom rows.
+							double tmp = (i==0) ? s[col] : c[col];
+							tmp *= tmp;
+							value = sign*scale[col]*(ends*tmp-3.0)/(3.0*tmp*tmp);
+						}
+					else
+						{
+							// The interior rows.
+							int gap = (col<i) ? i-col : col-i;
+							double tmp = s[2*i]*s[i+col]*s[gap];
+							value = sign*scale[col]*(c[2*i]*c[i+col]*c[gap]-1.0)*0.5/(tmp*tmp);
+						}
+					second[i][col] = value;
+					sum += value;
+				}
+			second[i][i] = -sum;
+		}
+}
+
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef FIXEDCHEBYSHEVROUTINE
+#define FIXEDCHEBYSHEVROUTINE
+
+
+/** *********************************************************************************
+ * @file fixedChebyshev.h
+ * @class FixedChebyshev
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep the Chebyshev collocation grid points and second
+ * derivative matrix for a number of grid points that is known when the
+ * program is compiled.
+ *
+ * This is the definition (header) file for the FixedChebyshev
+ * class. The values are found in a constexpr constructor, so an
+ * object declared as constexpr is filled in by the compiler and is
+ * placed in read only memory. The entries are found with the same half
+ * angle formulas used by the ChebyshevMatrices class. The sine and
+ * cosine are found from their Taylor series since the functions in
+ * cmath cannot be used in a constant expression. This requires
+ * C++14.
+ *
+ * The matrices are kept in plain arrays rather than std::array
+ * because the entries of a std::array cannot be changed within a
+ * constexpr function until C++17.
+ *
+ *
+ * @brief Header file for the Chebyshev matrices defined at compile time.
+ *
+ * ********************************************************************************* */
+
+#include <cmath>
+
+// The number of terms in the Taylor series for the sine and
+// cosine. The angles are never larger than pi/4, and this is enough
+// for the full precision of a double.
+#define FIXEDCHEBYSHEVTERMS 12
+
+constexpr double fixedSine(double angle);     //< The sine of an angle between 0 and pi/4.
+constexpr double fixedCosine(double angle);   //< The cosine of an angle between 0 and pi/4.
+
+template <int N>
+class FixedChebyshev
+{
+
+public:
+	constexpr FixedChebyshev();   //< Find the grid points and the second derivative matrix.
+
+	double nodes[N+1];            //< The Chebyshev Gauss-Lobatto grid points.
+	double second[N+1][N+1];      //< The second derivative matrix.
+
+};
+
+
+#include "fixedChebyshev.cpp"
+
+
+#endif
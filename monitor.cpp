@@ -0,0 +1,225 @@
+#ifndef MONITORROUTINEDEFINITIONS
+#define MONITORROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file monitor.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes used to watch the progress of the GMRES routine.
+ *
+ * This is the code file for the SolveReport and ReportMonitor
+ * classes. The file is included by the header, so every method is
+ * declared inline.
+ *
+ *
+ * @brief Code file for the classes that watch a GMRES solve.
+ *
+ * ********************************************************************************* */
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "monitor.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the SolveReport class.
+ *
+ * Every count and time starts at zero.
+ * ************************************************************************ */
+inline SolveReport::SolveReport()
+{
+	int lupe;
+	for(lupe=0;lupe<MONITORPHASES;++lupe)
+		{
+			seconds[lupe] = 0.0;
+			cycles[lupe]  = 0;
+			calls[lupe]   = 0;
+		}
+
+	iterations   = 0;
+	restarts     = 0;
+	converged    = false;
+	residual     = 0.0;
+	totalSeconds = 0.0;
+}
+
+
+/** ************************************************************************
+ * Get a short name for a phase.
+ *
+ * @param phase The phase.
+ * @return The name of the phase.
+ * ************************************************************************ */
+inline const char *SolveReport::phaseName(int phase)
+{
+	switch(phase)
+		{
+		case MONITORAPPLY:
+			return("apply");
+		case MONITORPRECONDITION:
+			return("precondition");
+		case MONITORORTHOGONALIZE:
+			return("orthogonalize");
+		case MONITORLEASTSQUARES:
+			return("least squares");
+		case MONITORUPDATE:
+			return("update");
+		case MONITORARNOLDI:
+			return("arnoldi");
+		case MONITORRESTART:
+			return("restart");
+		}
+	return("unknown");
+}
+
+
+/** ************************************************************************
+ * Base constructor  for the ReportMonitor class.
+ *
+ * ************************************************************************ */
+inline ReportMonitor::ReportMonitor()
+{
+	int lupe;
+	for(lupe=0;lupe<MONITORPHASES;++lupe)
+		cycleStart[lupe] = 0;
+}
+
+
+/** ************************************************************************
+ * Called when the solve starts. The report from any previous solve is
+ * cleared.
+ *
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * @param numberRestarts The largest number of restarts.
+ * ************************************************************************ */
+inline void ReportMonitor::start(int krylovDimension,int numberRestarts)
+{
+	report = SolveReport();
+	report.history.reserve(krylovDimension*numberRestarts+1);
+	solveStart = std::chrono::steady_clock::now();
+}
+
+
+/** ************************************************************************
+ * Called when a phase starts.
+ *
+ * @param phase The phase that is starting.
+ * ************************************************************************ */
+inline void ReportMonitor::begin(int phase)
+{
+	phaseStart[phase] = std::chrono::steady_clock::now();
+	cycleStart[phase] = cycleCount();
+}
+
+
+/** ************************************************************************
+ * Called when a phase ends. The time since the phase started is added
+ * to the total for the phase.
+ *
+ * @param phase The phase that is ending.
+ * ************************************************************************ */
+inline void ReportMonitor::end(int phase)
+{
+	unsigned long long cycles = cycleCount();
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	report.seconds[phase] += std::chrono::duration<double>(now-phaseStart[phase]).count();
+	report.cycles[phase]  += cycles-cycleStart[phase];
+	report.calls[phase]   += 1;
+}
+
+
+/** ************************************************************************
+ * Called with the estimate of the residual. It is called once before
+ * the first iteration and once after every iteration.
+ *
+ * @param iteration The number of iterations so far.
+ * @param relative The residual divided by the norm of the right hand side.
+ * ************************************************************************ */
+inline void ReportMonitor::residual(int iteration,double relative)
+{
+	report.history.push_back(relative);
+	report.iterations = iteration;
+}
+
+
+/** ************************************************************************
+ * Called when the routine restarts.
+ *
+ * ************************************************************************ */
+inline void ReportMonitor::restart()
+{
+	report.restarts += 1;
+}
+
+
+/** ************************************************************************
+ * Called when the solve ends.
+ *
+ * @param iterations The total number of iterations.
+ * @param relative The final relative residual.
+ * @param converged True if the tolerance was reached.
+ * ************************************************************************ */
+inline void ReportMonitor::finish(int iterations,double relative,bool converged)
+{
+	report.iterations   = iterations;
+	report.residual     = relative;
+	report.converged    = converged;
+	report.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-solveStart).count();
+}
+
+
+/** ************************************************************************
+ * Read the processor's cycle counter. On machines without a counter
+ * that can be read from user space the value is zero.
+ *
+ * @return The current value of the cycle counter.
+ * ************************************************************************ */
+inline unsigned long long ReportMonitor::cycleCount()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return(__rdtsc());
+#elif defined(__aarch64__)
+	unsigned long long count;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(count));
+	return(count);
+#else
+	return(0);
+#endif
+}
+
+
+#endif
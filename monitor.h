@@ -0,0 +1,151 @@
+#ifndef MONITORROUTINE
+#define MONITORROUTINE
+
+
+/** *********************************************************************************
+ * @file monitor.h
+ * @class ReportMonitor
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes used to watch the progress of the GMRES routine.
+ *
+ * This is the definition (header) file for the monitor classes. A
+ * monitor can be passed to the GMRES routine, and the routine tells
+ * the monitor when each phase of an iteration starts and ends, the
+ * estimate of the residual after every iteration, and when it
+ * restarts. The NullMonitor class does nothing, and every one of its
+ * methods is an empty inline function, so the calls are removed by
+ * the compiler. This is the monitor used when none is given. The
+ * ReportMonitor class keeps a SolveReport with the history of the
+ * residual and the wall clock time and cycle count of each phase.
+ *
+ *
+ * @brief Header file for the classes that watch a GMRES solve.
+ *
+ * ********************************************************************************* */
+
+#include <chrono>
+#include <vector>
+
+// The phases of a GMRES iteration that are timed. The last two
+// contain some of the others, so the times should not be added.
+#define MONITORAPPLY          0   //< The operator acting on a vector.
+#define MONITORPRECONDITION   1   //< The solve with the preconditioner.
+#define MONITORORTHOGONALIZE  2   //< Gram-Schmidt and normalization of the new vector.
+#define MONITORLEASTSQUARES   3   //< The Givens rotations for the least squares problem.
+#define MONITORUPDATE         4   //< The back solve and update of the approximation.
+#define MONITORARNOLDI        5   //< One Arnoldi step, from the operator to the Givens rotations.
+#define MONITORRESTART        6   //< The update and the new residual at a restart.
+#define MONITORPHASES         7
+
+
+/**
+	 The information gathered by a ReportMonitor during a solve.
+ */
+struct SolveReport
+{
+	SolveReport();
+
+	std::vector<double> history;                //< The relative residual at the start and after every iteration.
+	int iterations;                             //< The number of iterations.
+	int restarts;                               //< The number of restarts.
+	bool converged;                             //< True if the tolerance was reached.
+	double residual;                            //< The final relative residual.
+	double totalSeconds;                        //< The wall clock time for the whole solve.
+	double seconds[MONITORPHASES];              //< The wall clock time spent in each phase.
+	unsigned long long cycles[MONITORPHASES];   //< The number of cycles spent in each phase.
+	unsigned long calls[MONITORPHASES];         //< The number of times each phase was entered.
+
+	static const char *phaseName(int phase);    //< A short name for a phase.
+};
+
+
+/**
+	 The monitor that does nothing. Every method is empty so that the
+	 GMRES routine is not slowed down when it is used.
+ */
+class NullMonitor
+{
+
+public:
+	void start(int,int) {}
+	void begin(int) {}
+	void end(int) {}
+	void residual(int,double) {}
+	void restart() {}
+	void finish(int,double,bool) {}
+
+};
+
+
+class ReportMonitor
+{
+
+public:
+	ReportMonitor();                                    //< Default constructor for the class
+
+	void start(int krylovDimension,int numberRestarts); //< Called when the solve starts.
+	void begin(int phase);                              //< Called when a phase starts.
+	void end(int phase);                                //< Called when a phase ends.
+	void residual(int iteration,double relative);       //< Called with the residual after an iteration.
+	void restart();                                     //< Called when the routine restarts.
+	void finish(int iterations,double relative,bool converged); //< Called when the solve ends.
+
+	static unsigned long long cycleCount();             //< The value of the processor's cycle counter.
+
+	/**
+		 Method to get the information gathered during the solve.
+
+		 @return The report for the last solve.
+	 */
+	const SolveReport &getReport() const
+	{
+		return(report);
+	}
+
+
+private:
+
+	SolveReport report;                                             //< The information for the current solve.
+	std::chrono::steady_clock::time_point solveStart;               //< The time the solve started.
+	std::chrono::steady_clock::time_point phaseStart[MONITORPHASES]; //< The time each phase was last entered.
+	unsigned long long cycleStart[MONITORPHASES];                   //< The cycle count when each phase was last entered.
+
+};
+
+
+#include "monitor.cpp"
+
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef OPTIONSROUTINEDEFINITIONS
+#define OPTIONSROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file options.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to read the size of the grid and the parameters for the
+ * solver from the command line.
+ *
+ * This is the code file for the SolverOptions class. The file is
+ * included by the header, so every method is declared inline.
+ *
+ *
+ * @brief Code file for the command line options of the examples.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "options.h"
+
+
+/** ************************************************************************
+ * Constructor for the SolverOptions class with the default values
+ * used by an example.
+ *
+ * @param size The number of grid points.
+ * @param krylov The dimension of the Krylov subspace.
+ * @param restart The number of restarts.
+ * @param tol The tolerance for the relative residual.
+ * ************************************************************************ */
+inline SolverOptions::SolverOptions(int size,int krylov,int restart,double tol) :
+	number(size), sizes(1,size), krylovDimension(krylov), restarts(restart), tolerance(tol)
+{
+}
+
+
+/** ************************************************************************
+ * Set the sizes used when the command line does not give any. An
+ * empty list is ignored.
+ *
+ * @param list The numbers of grid points.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolverOptions::setSizes(const std::vector<int> &list)
+{
+	if(list.empty())
+		return;
+	sizes  = list;
+	number = sizes[0];
+}
+
+
+/** ************************************************************************
+ * Read the command line. A description of the options is written to
+ * the error stream if an option is not known or a value is not valid.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments, starting with the name of the program.
+ * @return True if every argument was used.
+ * ************************************************************************ */
+inline bool SolverOptions::parse(int argc,char **argv)
+{
+	bool valid = true;
+	int lupe;
+	for(lupe=1;valid&&(lupe<argc);++lupe)
+		{
+			const char *value = (lupe+1<argc) ? argv[lupe+1] : NULL;
+			if(argv[lupe][0]!='-')
+				traceFile = argv[lupe];
+			else if(value==NULL)
+				valid = false;
+			else if(std::strcmp(argv[lupe],"-n")==0)
+				valid = parseList(value,sizes);
+			else if(std::strcmp(argv[lupe],"-k")==0)
+				valid = ((krylovDimension = std::atoi(value))>0);
+			else if(std::strcmp(argv[lupe],"-r")==0)
+				valid = ((restarts = std::atoi(value))>0);
+			else if(std::strcmp(argv[lupe],"-t")==0)
+				valid = ((tolerance = std::atof(value))>0.0);
+			else if(std::strcmp(argv[lupe],"-trace")==0)
+				traceFile = value;
+			else
+				valid = false;
+
+			if(argv[lupe][0]=='-')
+				++lupe;
+		}
+
+	if(valid)
+		number = sizes[0];
+	else
+		usage(std::cerr,argv[0]);
+	return(valid);
+}
+
+
+/** ************************************************************************
+ * Write a description of the options.
+ *
+ * @param output The stream to write to.
+ * @param program The name of the program.
+ * ************************************************************************ */
+inline void SolverOptions::usage(std::ostream &output,const char *program)
+{
+	output << "Usage: " << program << " [-n N[,N...]] [-k krylov] [-r restarts] [-t tolerance] [-trace file]" << std::endl;
+}
+
+
+/** ************************************************************************
+ * Read a list of sizes separated by commas. Every size must be at
+ * least two.
+ *
+ * @param text The list.
+ * @param list Set to the sizes if the whole list is valid.
+ * @return True if the list was read.
+ * ************************************************************************ */
+inline bool SolverOptions::parseList(const char *text,std::vector<int> &list)
+{
+	std::vector<int> values;
+	const char *current = text;
+	while(*current!='\0')
+		{
+			char *end;
+			long value = std::strtol(current,&end,10);
+			if((end==current) || (value<2) || ((*end!=',') && (*end!='\0')))
+				return(false);
+			values.push_back((int)value);
+			current = (*end==',') ? end+1 : end;
+		}
+	if(values.empty())
+		return(false);
+	list.swap(values);
+	return(true);
+}
+
+
+#endif
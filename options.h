@@ -0,0 +1,156 @@
+#ifndef OPTIONSROUTINE
+#define OPTIONSROUTINE
+
+
+/** *********************************************************************************
+ * @file options.h
+ * @class SolverOptions
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to read the size of the grid and the parameters for the
+ * solver from the command line.
+ *
+ * This is the definition (header) file for the SolverOptions class.
+ * The examples make one with their default values and then read the
+ * command line. The options are
+ *
+ *   -n N        The number of grid points, or a list such as 16,32,64.
+ *   -k K        The dimension of the Krylov subspace.
+ *   -r R        The number of restarts.
+ *   -t T        The tolerance for the relative residual.
+ *   -trace F    The name of a file for a timeline of the solve.
+ *
+ * A single argument that is not an option is also taken as the name
+ * of the trace file.
+ *
+ *
+ * @brief Header file for the command line options of the examples.
+ *
+ * ********************************************************************************* */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+class SolverOptions
+{
+
+public:
+	SolverOptions(int size,int krylov,int restart,double tol); //< Constructor with the default values
+
+	bool parse(int argc,char **argv);                   //< Read the command line.
+	static void usage(std::ostream &output,const char *program); //< Write a description of the options.
+	static bool parseList(const char *text,std::vector<int> &list); //< Read a list of sizes separated by commas.
+
+	void setSizes(const std::vector<int> &list);        //< Set the default sizes.
+
+	/**
+		 Method to get the number of grid points. It is the first of the
+		 sizes.
+
+		 @return The number of grid points.
+	 */
+	int getNumber() const
+	{
+		return(number);
+	}
+
+	/**
+		 Method to get every number of grid points that was given.
+
+		 @return The sizes.
+	 */
+	const std::vector<int> &getSizes() const
+	{
+		return(sizes);
+	}
+
+	/**
+		 Method to get the dimension of the Krylov subspace.
+
+		 @return The dimension of the subspace.
+	 */
+	int getKrylovDimension() const
+	{
+		return(krylovDimension);
+	}
+
+	/**
+		 Method to get the number of restarts.
+
+		 @return The number of restarts.
+	 */
+	int getRestarts() const
+	{
+		return(restarts);
+	}
+
+	/**
+		 Method to get the tolerance for the relative residual.
+
+		 @return The tolerance.
+	 */
+	double getTolerance() const
+	{
+		return(tolerance);
+	}
+
+	/**
+		 Method to get the name of the file for a timeline of the solve.
+
+		 @return The name of the file, or an empty string if none was given.
+	 */
+	const std::string &getTraceFile() const
+	{
+		return(traceFile);
+	}
+
+
+protected:
+
+	int number;                         //< The number of grid points, the first of the sizes.
+	std::vector<int> sizes;             //< Every number of grid points given.
+	int krylovDimension;                //< The dimension of the Krylov subspace.
+	int restarts;                       //< The number of restarts.
+	double tolerance;                   //< The tolerance for the relative residual.
+	std::string traceFile;              //< The file for a timeline, or empty.
+
+};
+
+
+#include "options.cpp"
+
+
+#endif
@@ -0,0 +1,454 @@
+#ifndef POOLROUTINEDEFINITIONS
+#define POOLROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file pool.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to keep a pool of aligned blocks of memory that can be
+ * reused during a solve.
+ *
+ * This is the code file for the MemoryPool and MemoryPoolScope
+ * classes. The file is included by the header, so every method is
+ * declared inline.
+ *
+ *
+ * @brief Code file for the pool of aligned memory blocks.
+ *
+ * ********************************************************************************* */
+
+
+#include <iostream>
+#include <cstdlib>
+#include <sys/mman.h>
+#include "pool.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the MemoryPool class.
+ *
+ * All of the free lists start out empty.
+ *
+ * ************************************************************************ */
+inline MemoryPool::MemoryPool()
+{
+	int lupe;
+	for(lupe=0;lupe<MEMORYPOOLCLASSES;++lupe)
+		freeList[lupe] = NULL;
+
+	requests    = 0;
+	fresh       = 0;
+	outstanding = 0;
+	bytesInUse  = 0;
+	peakBytes   = 0;
+	closed      = false;
+}
+
+
+/** ************************************************************************
+ * Destructor for the MemoryPool class.
+ *
+ * Returns every cached block to the system.
+ *
+ * ************************************************************************ */
+inline MemoryPool::~MemoryPool()
+{
+	releaseAll();
+}
+
+
+/** ************************************************************************
+ * The counter for the number of times the system allocator is called.
+ *
+ * @return A reference to the counter.
+ *
+ * ************************************************************************ */
+inline std::atomic<unsigned long> &MemoryPool::systemAllocations()
+{
+	static std::atomic<unsigned long> counter(0);
+	return(counter);
+}
+
+
+/** ************************************************************************
+ * The place where the active pool for the calling thread is kept.
+ *
+ * @return A reference to the pointer to the active pool.
+ *
+ * ************************************************************************ */
+inline MemoryPool *&MemoryPool::activeSlot()
+{
+	static thread_local MemoryPool *pool = NULL;
+	return(pool);
+}
+
+
+/** ************************************************************************
+ * Get the pool that is active for the calling thread.
+ *
+ * @return A pointer to the active pool or NULL if there is not one.
+ *
+ * ************************************************************************ */
+inline MemoryPool *MemoryPool::active()
+{
+	return(activeSlot());
+}
+
+
+/** ************************************************************************
+ * Set the pool that is active for the calling thread.
+ *
+ * @param pool The pool to make active. It can be NULL.
+ * @return N/A
+ *
+ * ************************************************************************ */
+inline void MemoryPool::setActive(MemoryPool *pool)
+{
+	activeSlot() = pool;
+}
+
+
+/** ************************************************************************
+ * Determine the size class needed for a given number of bytes.
+ *
+ * @param bytes The number of bytes including the header.
+ * @return The smallest c so that 2^c is at least the number of bytes.
+ *
+ * ************************************************************************ */
+inline int MemoryPool::sizeClass(std::size_t bytes)
+{
+	int c = 7;
+	while((((std::size_t) 1)<<c) < bytes)
+		++c;
+	return(c);
+}
+
+
+/** ************************************************************************
+ * Get a block of memory from the system.
+ *
+ * If huge pages are requested the length is rounded up to a whole
+ * number of huge pages, and the kernel is asked to back the block
+ * with transparent huge pages.
+ *
+ * @param bytes The number of bytes including the header.
+ * @param alignment The alignment of the block in bytes.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the header of the block.
+ *
+ * ************************************************************************ */
+inline MemoryPoolHeader *MemoryPool::systemBlock(std::size_t bytes,std::size_t alignment,bool hugePages)
+{
+	void *block = NULL;
+
+	if(hugePages)
+		bytes = ((bytes+HUGEPAGESIZE-1)/HUGEPAGESIZE)*HUGEPAGESIZE;
+
+	if(posix_memalign(&block,alignment,bytes)!=0)
+		{
+			std::cout << "Error - MemoryPool. Could not allocate memory." << std::endl;
+			std::exit(2);
+		}
+	systemAllocations()++;
+
+#ifdef MADV_HUGEPAGE
+	if(hugePages)
+		madvise(block,bytes,MADV_HUGEPAGE);
+#endif
+
+	return(static_cast<MemoryPoolHeader*>(block));
+}
+
+
+/** ************************************************************************
+ * Get a block of aligned memory.
+ *
+ * The block comes from the active pool for the calling thread. If
+ * there is no active pool, or huge pages are requested for a block at
+ * least as big as a huge page, then the block comes directly from the
+ * system. The memory is not initialized.
+ *
+ * @param bytes The number of bytes needed.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to memory aligned on an ARRAYALIGNMENT byte boundary.
+ *
+ * ************************************************************************ */
+inline void *MemoryPool::allocate(std::size_t bytes,bool hugePages)
+{
+	MemoryPool *pool = active();
+	MemoryPoolHeader *header;
+
+	if(hugePages && (bytes>=HUGEPAGESIZE))
+		{
+			header = systemBlock(bytes+sizeof(MemoryPoolHeader),HUGEPAGESIZE,true);
+		}
+	else if(pool==NULL)
+		{
+			header = systemBlock(bytes+sizeof(MemoryPoolHeader),ARRAYALIGNMENT,false);
+		}
+	else
+		{
+			return(pool->take(sizeClass(bytes+sizeof(MemoryPoolHeader))));
+		}
+
+	header->block.owner     = NULL;
+	header->block.next      = NULL;
+	header->block.length    = 0;
+	header->block.sizeClass = MEMORYPOOLDIRECT;
+	return(static_cast<void*>(header+1));
+}
+
+
+/** ************************************************************************
+ * Get a block of memory that is zero without writing to it.
+ *
+ * The block is an anonymous mapping, so the system gives it pages of
+ * zeros when they are first touched. The first touch happens in the
+ * routine that first writes the memory rather than here. The block
+ * does not come from the active pool. If anonymous mappings are not
+ * available the block is allocated and zeroed.
+ *
+ * @param bytes The number of bytes needed.
+ * @return A pointer to memory aligned on an ARRAYALIGNMENT byte boundary.
+ *
+ * ************************************************************************ */
+inline void *MemoryPool::allocateZeroed(std::size_t bytes)
+{
+	MemoryPoolHeader *header;
+	std::size_t length = bytes+sizeof(MemoryPoolHeader);
+
+#ifdef MAP_ANONYMOUS
+	void *block = mmap(NULL,length,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+	if(block==MAP_FAILED)
+		{
+			std::cout << "Error - MemoryPool. Could not map memory." << std::endl;
+			std::exit(2);
+		}
+	systemAllocations()++;
+	header = static_cast<MemoryPoolHeader*>(block);
+	header->block.sizeClass = MEMORYPOOLMAPPED;
+#else
+	header = systemBlock(length,ARRAYALIGNMENT,false);
+	char *entry = reinterpret_cast<char*>(header+1);
+	for(std::size_t lupe=0;lupe<bytes;++lupe)
+		entry[lupe] = 0;
+	header->block.sizeClass = MEMORYPOOLDIRECT;
+#endif
+
+	header->block.owner  = NULL;
+	header->block.next   = NULL;
+	header->block.length = length;
+	return(static_cast<void*>(header+1));
+}
+
+
+/** ************************************************************************
+ * Return a block of memory that was given out by allocate.
+ *
+ * The block goes back to the pool that owns it. If it was allocated
+ * or mapped directly it goes back to the system.
+ *
+ * @param data The pointer returned by allocate. It can be NULL.
+ * @return N/A
+ *
+ * ************************************************************************ */
+inline void MemoryPool::release(void *data)
+{
+	if(data==NULL)
+		return;
+
+	MemoryPoolHeader *header = static_cast<MemoryPoolHeader*>(data)-1;
+	MemoryPool *pool = header->block.owner;
+	if(pool==NULL)
+		{
+#ifdef MAP_ANONYMOUS
+			if(header->block.sizeClass==MEMORYPOOLMAPPED)
+				{
+					munmap(header,header->block.length);
+					return;
+				}
+#endif
+			std::free(header);
+			return;
+		}
+
+	if(pool->give(header))
+		delete pool;
+}
+
+
+/** ************************************************************************
+ * Get a block of a given size class.
+ *
+ * @param c The size class.
+ * @return A pointer to the memory after the header.
+ *
+ * ************************************************************************ */
+inline void *MemoryPool::take(int c)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	MemoryPoolHeader *header = freeList[c];
+
+	requests += 1;
+	if(header!=NULL)
+		{
+			freeList[c] = header->block.next;
+		}
+	else
+		{
+			header = systemBlock(((std::size_t) 1)<<c,ARRAYALIGNMENT,false);
+			header->block.owner     = this;
+			header->block.sizeClass = c;
+			fresh += 1;
+		}
+
+	outstanding += 1;
+	bytesInUse  += ((std::size_t) 1)<<c;
+	if(bytesInUse > peakBytes)
+		peakBytes = bytesInUse;
+
+	return(static_cast<void*>(header+1));
+}
+
+
+/** ************************************************************************
+ * Put a block back in the pool.
+ *
+ * If the scope for the pool has ended the block goes back to the
+ * system instead of the free list.
+ *
+ * @param header The header of the block.
+ * @return True if the scope has ended and this was the last block in use.
+ *
+ * ************************************************************************ */
+inline bool MemoryPool::give(MemoryPoolHeader *header)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	int c = header->block.sizeClass;
+
+	outstanding -= 1;
+	bytesInUse  -= ((std::size_t) 1)<<c;
+	if(closed)
+		{
+			std::free(header);
+			return(outstanding==0);
+		}
+
+	header->block.next = freeList[c];
+	freeList[c] = header;
+	return(false);
+}
+
+
+/** ************************************************************************
+ * Return every cached block to the system.
+ *
+ * Blocks that are in use are not affected.
+ *
+ * @return N/A
+ *
+ * ************************************************************************ */
+inline void MemoryPool::releaseAll()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	int lupe;
+	for(lupe=0;lupe<MEMORYPOOLCLASSES;++lupe)
+		{
+			while(freeList[lupe]!=NULL)
+				{
+					MemoryPoolHeader *next = freeList[lupe]->block.next;
+					std::free(freeList[lupe]);
+					freeList[lupe] = next;
+				}
+		}
+}
+
+
+/** ************************************************************************
+ * Mark the end of the scope for the pool.
+ *
+ * The cached blocks are returned to the system. If no blocks are in
+ * use the pool is deleted. Otherwise it is deleted when the last
+ * block is released. The pool must not be used after this is called.
+ *
+ * @return N/A
+ *
+ * ************************************************************************ */
+inline void MemoryPool::close()
+{
+	bool empty;
+	releaseAll();
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		closed = true;
+		empty  = (outstanding==0);
+	}
+
+	if(empty)
+		delete this;
+}
+
+
+/** ************************************************************************
+ * Base constructor  for the MemoryPoolScope class.
+ *
+ * Creates a new pool and makes it the active pool for the calling
+ * thread.
+ *
+ * ************************************************************************ */
+inline MemoryPoolScope::MemoryPoolScope()
+{
+	pool     = new MemoryPool;
+	previous = MemoryPool::active();
+	MemoryPool::setActive(pool);
+}
+
+
+/** ************************************************************************
+ * Destructor for the MemoryPoolScope class.
+ *
+ * Restores the pool that was active before the scope and closes the
+ * pool for the scope.
+ *
+ * ************************************************************************ */
+inline MemoryPoolScope::~MemoryPoolScope()
+{
+	MemoryPool::setActive(previous);
+	pool->close();
+}
+
+
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef POOLROUTINE
+#define POOLROUTINE
+
+
+/** *********************************************************************************
+ * @file pool.h
+ * @class MemoryPool
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to keep a pool of aligned blocks of memory that can be
+ * reused during a solve.
+ *
+ * This is the definition (header) file for the MemoryPool and
+ * MemoryPoolScope classes. The blocks are grouped into size classes
+ * that are powers of two, and a block that is released is kept on a
+ * free list for its size class so that the next request of the same
+ * size does not go to the system. Every block has a small header in
+ * front of it that records the pool that owns it.
+ *
+ * A MemoryPoolScope creates a pool and makes it the active pool for
+ * the current thread. The aligned allocation routines in ArrayUtils
+ * and the Tensor class take their memory from the active pool.
+ *
+ * When the scope ends, all of the cached blocks are returned to the
+ * system. Blocks that are still in use at that time are returned to
+ * the system when they are released, and the pool is deleted when the
+ * last one is released.
+ *
+ * The PoolAllocator class lets the standard library classes take
+ * their memory from the active pool in the same way.
+ *
+ * A block can also be mapped directly from the system with an
+ * anonymous mapping. The pages of a mapped block are zero, and they
+ * are not given memory until they are first touched. Mapped blocks
+ * never go into a pool since a reused block would not be zero.
+ *
+ *
+ * @brief Header file for the pool of aligned memory blocks.
+ *
+ * ********************************************************************************* */
+
+#include <cstddef>
+#include <mutex>
+#include <atomic>
+
+// The alignment, in bytes, of the memory returned by the aligned
+// allocation routines. This is the size of a cache line and is
+// enough for the widest vector loads.
+#define ARRAYALIGNMENT 64
+
+// The size, in bytes, of a transparent huge page.
+#define HUGEPAGESIZE 2097152
+
+// The number of size classes. Class c holds blocks of 2^c bytes
+// including the header.
+#define MEMORYPOOLCLASSES 48
+
+// The size classes used for blocks that are not kept in a pool.
+#define MEMORYPOOLDIRECT -1
+#define MEMORYPOOLMAPPED -2
+
+class MemoryPool;
+
+/**
+	 The information kept in front of every block. It is padded to
+	 ARRAYALIGNMENT bytes so that the data after it stays aligned.
+ */
+union MemoryPoolHeader
+{
+	struct
+	{
+		MemoryPool       *owner;       //< The pool that owns the block, NULL if it was allocated directly.
+		MemoryPoolHeader *next;        //< The next block on the free list.
+		std::size_t      length;       //< The number of bytes in a mapped block.
+		int              sizeClass;    //< The size class of the block, or a negative value if it is not pooled.
+	} block;
+	char padding[ARRAYALIGNMENT];
+};
+
+
+class MemoryPool
+{
+
+public:
+	MemoryPool();                                         //< Default constructor for the class
+	~MemoryPool();                                        //< Destructor for the class
+
+	// Define the methods used to get and return memory. They use the
+	// pool that is active for the calling thread if there is one.
+	static void *allocate(std::size_t bytes,bool hugePages=false);
+	static void *allocateZeroed(std::size_t bytes);       //< Zero-on-demand pages that bypass the pool.
+	static void release(void *data);
+
+	// Define the methods used to keep track of the active pool.
+	static MemoryPool *active();
+	static void setActive(MemoryPool *pool);
+
+	void releaseAll();                                    //< Return the cached blocks to the system.
+	void close();                                         //< Mark the end of the scope for the pool.
+
+	/**
+		 Method to get the number of times the system allocator was
+		 called by any pool or by the direct allocation path.
+
+		 @return The number of system allocations.
+	 */
+	static unsigned long getTotalSystemAllocations()
+	{
+		return(systemAllocations().load());
+	}
+
+	/**
+		 Method to get the number of requests made to the pool.
+
+		 @return The number of requests.
+	 */
+	unsigned long getRequests() const
+	{
+		return(requests);
+	}
+
+	/**
+		 Method to get the number of requests that required a new block
+		 from the system.
+
+		 @return The number of new blocks.
+	 */
+	unsigned long getFresh() const
+	{
+		return(fresh);
+	}
+
+	/**
+		 Method to get the number of requests that were satisfied by a
+		 block on a free list.
+
+		 @return The number of reused blocks.
+	 */
+	unsigned long getReused() const
+	{
+		return(requests-fresh);
+	}
+
+	/**
+		 Method to get the number of blocks that have been handed out
+		 and not yet released.
+
+		 @return The number of blocks in use.
+	 */
+	unsigned long getOutstanding() const
+	{
+		return(outstanding);
+	}
+
+	/**
+		 Method to get the largest number of bytes that were handed out
+		 by the pool at one time.
+
+		 @return The largest number of bytes in use.
+	 */
+	std::size_t getPeakBytes() const
+	{
+		return(peakBytes);
+	}
+
+
+protected:
+
+	void *take(int sizeClass);                            //< Get a block from a free list or the system.
+	bool give(MemoryPoolHeader *header);                  //< Put a block back. Returns true if the pool should be deleted.
+
+	static int sizeClass(std::size_t bytes);              //< The size class needed for a request.
+	static MemoryPoolHeader *systemBlock(std::size_t bytes,std::size_t alignment,bool hugePages);
+	static std::atomic<unsigned long> &systemAllocations();
+	static MemoryPool *&activeSlot();                     //< The active pool for the calling thread.
+
+
+private:
+
+	std::mutex lock;                                      //< Lock for blocks released by other threads.
+	MemoryPoolHeader *freeList[MEMORYPOOLCLASSES];        //< The cached blocks for each size class.
+	unsigned long requests;                               //< The number of requests made.
+	unsigned long fresh;                                  //< The number of blocks taken from the system.
+	unsigned long outstanding;                            //< The number of blocks in use.
+	std::size_t   bytesInUse;                             //< The number of bytes in use.
+	std::size_t   peakBytes;                              //< The largest number of bytes in use.
+	bool closed;                                          //< Flag to indicate that the scope has ended.
+
+};
+
+
+class MemoryPoolScope
+{
+
+public:
+	MemoryPoolScope();                                    //< Create a pool and make it active.
+	~MemoryPoolScope();                                   //< Restore the previous pool and close this one.
+
+	/**
+		 Method to get the pool that is active within the scope.
+
+		 @return A pointer to the pool.
+	 */
+	MemoryPool *getPool() const
+	{
+		return(pool);
+	}
+
+private:
+	MemoryPoolScope(const MemoryPoolScope& oldCopy);     //< A scope cannot be copied.
+
+	MemoryPool *pool;                                     //< The pool created for the scope.
+	MemoryPool *previous;                                 //< The pool that was active before the scope.
+
+};
+
+
+/**
+	 An allocator for the standard library classes that takes its memory
+	 from the active pool of the calling thread. The memory can be
+	 released by any thread.
+ */
+template <class Type>
+class PoolAllocator
+{
+
+public:
+	typedef Type value_type;
+
+	PoolAllocator() {}
+	template <class Other>
+	PoolAllocator(const PoolAllocator<Other>&) {}
+
+	/**
+		 Method to get the memory for a number of objects.
+
+		 @param number The number of objects.
+		 @return A pointer to the memory.
+	 */
+	Type *allocate(std::size_t number)
+	{
+		return(static_cast<Type*>(MemoryPool::allocate(number*sizeof(Type))));
+	}
+
+	/**
+		 Method to give back the memory for a number of objects. The
+		 pool knows the size of the block, so the number is not used.
+
+		 @param data The memory from allocate.
+		 @return N/A
+	 */
+	void deallocate(Type *data,std::size_t)
+	{
+		MemoryPool::release(data);
+	}
+
+};
+
+template <class Type,class Other>
+bool operator==(const PoolAllocator<Type>&,const PoolAllocator<Other>&)
+{
+	return(true);
+}
+
+template <class Type,class Other>
+bool operator!=(const PoolAllocator<Type>&,const PoolAllocator<Other>&)
+{
+	return(false);
+}
+
+
+#include "pool.cpp"
+
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef SNAPSHOTROUTINEDEFINITIONS
+#define SNAPSHOTROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file snapshot.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to write approximations to files on a background thread.
+ *
+ * This is the code file for the SnapshotWriter class. The file is
+ * included by the header, so every method that is not a template is
+ * declared inline.
+ *
+ *
+ * @brief Code file for the background writer of approximations.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstring>
+#include "snapshot.h"
+#include "field.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the SnapshotWriter class.
+ *
+ * The buffers are made empty and the background thread is started.
+ *
+ * @param number The number of buffers. At least one is used.
+ * ************************************************************************ */
+inline SnapshotWriter::SnapshotWriter(int number) :
+	buffers((number>0) ? number : 1)
+{
+	busy     = false;
+	stopping = false;
+	written  = 0;
+	failures = 0;
+	waits    = 0;
+
+	std::vector<SnapshotBuffer>::iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		available.push_back(&(*ptr));
+	worker = std::thread(&SnapshotWriter::drain,this);
+}
+
+
+/** ************************************************************************
+ * Destructor for the SnapshotWriter class.
+ *
+ * Every buffer in the queue is written before the thread stops.
+ * ************************************************************************ */
+inline SnapshotWriter::~SnapshotWriter()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	queued.notify_one();
+	worker.join();
+}
+
+
+/** ************************************************************************
+ * Copy an approximation into a free buffer and queue it to be
+ * written. If no buffer is free the call waits for the background
+ * thread to finish one. The copy is made without the lock held.
+ *
+ * @param fileName The name of the file.
+ * @param values The values of the approximation.
+ * @param nodes The nodes of the grid.
+ * @param grid The type of grid.
+ * ************************************************************************ */
+template <int Rank>
+void SnapshotWriter::submit(const std::string &fileName,const Tensor<double,Rank> &values,
+														const Tensor<double,1> &nodes,int grid)
+{
+	static_assert((Rank>=1) && (Rank<=2),"The rank must be one or two.");
+
+	SnapshotBuffer *buffer;
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		if(available.empty())
+			{
+				waits += 1;
+				freed.wait(guard,[this]() { return(!available.empty()); });
+			}
+		buffer = available.back();
+		available.pop_back();
+	}
+
+	// Copy the rows without their padding. The vectors keep their
+	// memory, so they only grow the first time a larger approximation
+	// is given.
+	std::size_t rows    = (Rank>1) ? (std::size_t)values.getExtent(0) : 1;
+	std::size_t columns = (std::size_t)values.getExtent(Rank-1);
+	buffer->fileName = fileName;
+	buffer->rank     = Rank;
+	buffer->extent[0] = values.getExtent(0);
+	buffer->extent[1] = (Rank>1) ? values.getExtent(1) : 1;
+	buffer->grid     = grid;
+	buffer->nodes.assign(nodes.data(),nodes.data()+nodes.getExtent(0));
+	buffer->values.resize(rows*columns);
+	std::size_t row;
+	for(row=0;row<rows;++row)
+		std::memcpy(buffer->values.data()+row*columns,
+								values.data()+((Rank>1) ? row*values.getStride(0) : 0),columns*sizeof(double));
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		queue.push_back(buffer);
+	}
+	queued.notify_one();
+}
+
+
+/** ************************************************************************
+ * Wait until every buffer in the queue has been written.
+ *
+ * ************************************************************************ */
+inline void SnapshotWriter::flush()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	freed.wait(guard,[this]() { return(queue.empty() && !busy); });
+}
+
+
+/** ************************************************************************
+ * The loop run by the background thread. It takes the oldest buffer in
+ * the queue, writes it without the lock held, and returns it to the
+ * free list. Nothing is allocated to write a buffer. It stops once the writer is stopping and the queue is
+ * empty.
+ *
+ * ************************************************************************ */
+inline void SnapshotWriter::drain()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	while(true)
+		{
+			queued.wait(guard,[this]() { return(stopping || !queue.empty()); });
+			if(queue.empty())
+				break;
+
+			SnapshotBuffer *buffer = queue.front();
+			queue.pop_front();
+			busy = true;
+			guard.unlock();
+
+			// The values in a buffer have no padding, so they are written
+			// straight from the buffer.
+			bool success = FieldFile::write(buffer->fileName,buffer->rank,buffer->extent,
+																			buffer->values.data(),buffer->nodes.data(),buffer->grid);
+
+			guard.lock();
+			busy = false;
+			if(success)
+				written += 1;
+			else
+				failures += 1;
+			available.push_back(buffer);
+			freed.notify_all();
+		}
+}
+
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef SNAPSHOTROUTINE
+#define SNAPSHOTROUTINE
+
+
+/** *********************************************************************************
+ * @file snapshot.h
+ * @class SnapshotWriter
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to write approximations to files on a background thread.
+ *
+ * This is the definition (header) file for the SnapshotWriter class.
+ * The writer keeps a fixed number of buffers. A call to submit copies
+ * the values of an approximation into a free buffer and puts it in a
+ * queue, and a thread owned by the writer takes the buffers from the
+ * queue and writes them with the FieldFile class straight from the
+ * buffer. When the thread is
+ * done with a buffer it is returned to the free list and used again,
+ * so a buffer is only allocated again if a larger approximation is
+ * given. If every buffer is waiting to be written, submit waits for
+ * one to be freed, which keeps the solver from getting ahead of the
+ * disk by more than the number of buffers.
+ *
+ *
+ * @brief Header file for the background writer of approximations.
+ *
+ * ********************************************************************************* */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tensor.h"
+
+// The number of buffers used when none is given.
+#define SNAPSHOTBUFFERS 4
+
+/**
+	 A copy of an approximation that is waiting to be written.
+ */
+struct SnapshotBuffer
+{
+	std::string fileName;         //< The name of the file.
+	int rank;                     //< The number of dimensions.
+	int extent[2];                //< The number of points in each dimension.
+	int grid;                     //< The type of grid.
+	std::vector<double> nodes;    //< The nodes of the grid.
+	std::vector<double> values;   //< The values without padding, last index fastest.
+};
+
+
+class SnapshotWriter
+{
+
+public:
+	SnapshotWriter(int buffers=SNAPSHOTBUFFERS);           //< Default constructor for the class
+	~SnapshotWriter();                                     //< Destructor for the class
+
+	template <int Rank>
+	void submit(const std::string &fileName,const Tensor<double,Rank> &values,
+							const Tensor<double,1> &nodes,int grid); //< Copy an approximation and queue it to be written.
+	void flush();                                          //< Wait until every queued buffer is written.
+
+	/**
+		 Method to get the number of files that have been written.
+
+		 @return The number of files.
+	 */
+	unsigned long getWritten() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return(written);
+	}
+
+	/**
+		 Method to get the number of files that could not be written.
+
+		 @return The number of failures.
+	 */
+	unsigned long getFailures() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return(failures);
+	}
+
+	/**
+		 Method to get the number of times submit had to wait for a
+		 free buffer.
+
+		 @return The number of waits.
+	 */
+	unsigned long getWaits() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return(waits);
+	}
+
+
+protected:
+	void drain();                                          //< The loop run by the background thread.
+
+
+private:
+	SnapshotWriter(const SnapshotWriter& oldCopy);         //< The thread cannot be shared by copying.
+	SnapshotWriter& operator=(const SnapshotWriter& oldCopy);
+
+	std::vector<SnapshotBuffer> buffers;    //< Every buffer.
+	std::vector<SnapshotBuffer*> available; //< The buffers that can be filled.
+	std::deque<SnapshotBuffer*> queue;      //< The buffers waiting to be written, oldest first.
+	bool busy;                              //< True while the thread is writing a buffer.
+	bool stopping;                          //< True when the thread should stop.
+	unsigned long written;                  //< The number of files written.
+	unsigned long failures;                 //< The number of files that could not be written.
+	unsigned long waits;                    //< The number of times submit waited.
+
+	mutable std::mutex lock;                //< Held while the lists are changed.
+	std::condition_variable freed;          //< Signalled when a buffer is returned or the queue is empty.
+	std::condition_variable queued;         //< Signalled when a buffer is queued or the writer stops.
+	std::thread worker;                     //< The thread that writes the files.
+
+};
+
+
+#include "snapshot.cpp"
+
+
+#endif
@@ -0,0 +1,556 @@
+#ifndef SOLVEQUEUEROUTINEDEFINITIONS
+#define SOLVEQUEUEROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file solveQueue.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to spread many independent solves across a set of threads.
+ *
+ * This is the code file for the SolveQueue class. The methods that
+ * are not templates are declared inline since the file is included by
+ * the header.
+ *
+ *
+ * @brief Code file for the work stealing queue of solves.
+ *
+ * ********************************************************************************* */
+
+
+#include "solveQueue.h"
+#include "GMRES.h"
+#include "pool.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the SolveQueue class.
+ *
+ * Starts the worker threads. Each one waits until a task is queued.
+ *
+ * @param number The number of workers. If it is zero or less there is
+ *        one worker for every processor.
+ * ************************************************************************ */
+inline SolveQueue::SolveQueue(int number)
+	: queued(0), unfinished(0), next(0), steals(0), executed(0), stopping(false), spare(0)
+{
+	if(number <= 0)
+		number = (int)std::thread::hardware_concurrency();
+	if(number <= 0)
+		number = 1;
+
+	int lupe;
+	for(lupe=0;lupe<number;++lupe)
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	for(lupe=0;lupe<number;++lupe)
+		workers[lupe]->thread = std::thread(&SolveQueue::run,this,lupe);
+}
+
+
+/** ************************************************************************
+ * Destructor for the SolveQueue class.
+ *
+ * The tasks that are still queued are run before the workers stop.
+ * ************************************************************************ */
+inline SolveQueue::~SolveQueue()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	std::vector<std::unique_ptr<Worker> >::iterator worker;
+	for(worker=workers.begin();worker!=workers.end();++worker)
+		(*worker)->thread.join();
+
+	while(spare != 0)
+		{
+			TaskNode *task = spare;
+			spare = task->next;
+			delete task;
+		}
+}
+
+
+/** ************************************************************************
+ * Submit a task to the queue.
+ *
+ * The task is run by one of the workers, and its return value, or the
+ * exception it throws, is given to the future. A task submitted by a
+ * worker goes on that worker's own queue.
+ *
+ * @param task The function to run. It takes no arguments.
+ * @return The future for the result of the task.
+ * ************************************************************************ */
+template <class Task>
+std::future<typename std::result_of<Task()>::type> SolveQueue::submit(Task task)
+{
+	typedef typename std::result_of<Task()>::type Result;
+	return(emplace<Result,Task>(task));
+}
+
+
+/** ************************************************************************
+ * Build a task in a node and submit it to the queue.
+ *
+ * The function is built in the node from the arguments, so it is not
+ * copied again. The node comes from the spare list, and the state
+ * shared with the future comes from the memory pool of the calling
+ * thread. The function must fit in SOLVEQUEUETASKBYTES bytes along
+ * with its promise.
+ *
+ * @param arguments The arguments given to the constructor of the function.
+ * @return The future for the result of the function.
+ * ************************************************************************ */
+template <class Result,class Function,class... Arguments>
+std::future<Result> SolveQueue::emplace(Arguments&&... arguments)
+{
+	typedef SolveQueueCall<Result,Function> Call;
+	static_assert(sizeof(Call)<=SOLVEQUEUETASKBYTES,"The task does not fit in a node of the queue.");
+	static_assert(alignof(Call)<=alignof(std::max_align_t),"The task needs a larger alignment than a node has.");
+
+	TaskNode *task = spareTask();
+	Call *call;
+	try
+		{
+			call = new (task->storage) Call(std::forward<Arguments>(arguments)...);
+		}
+	catch(...)
+		{
+			recycle(task);
+			throw;
+		}
+	task->execute = &SolveQueue::execute<Call>;
+
+	std::future<Result> result = call->promise.get_future();
+	push(task);
+	return(result);
+}
+
+
+/** ************************************************************************
+ * Run the task kept in a node and then destroy it.
+ *
+ * @param task The node that holds the task.
+ * @return N/A
+ * ************************************************************************ */
+template <class Call>
+void SolveQueue::execute(TaskNode *task)
+{
+	Call *call = reinterpret_cast<Call*>(task->storage);
+	(*call)();
+	call->~Call();
+}
+
+
+/** ************************************************************************
+ * Run the function for a task and give its result, or the exception
+ * it throws, to the promise.
+ *
+ * @return N/A
+ * ************************************************************************ */
+template <class Result,class Function>
+void SolveQueueCall<Result,Function>::operator()()
+{
+	try
+		{
+			promise.set_value(function());
+		}
+	catch(...)
+		{
+			promise.set_exception(std::current_exception());
+		}
+}
+
+
+/** ************************************************************************
+ * Run the function for a task that does not return a value.
+ *
+ * @return N/A
+ * ************************************************************************ */
+template <class Function>
+struct SolveQueueCall<void,Function>
+{
+	template <class... Arguments>
+	SolveQueueCall(Arguments&&... arguments)
+		: promise(std::allocator_arg,PoolAllocator<char>()), function(std::forward<Arguments>(arguments)...) {}
+
+	void operator()()
+	{
+		try
+			{
+				function();
+				promise.set_value();
+			}
+		catch(...)
+			{
+				promise.set_exception(std::current_exception());
+			}
+	}
+
+	std::promise<void> promise; //< The promise that is set when the function returns.
+	Function function;          //< The function to run.
+};
+
+
+/** ************************************************************************
+ * Submit a GMRES solve to the queue.
+ *
+ * The worker uses its own copy of the operator and the
+ * preconditioner, since they may keep scratch space. The copies are
+ * made from the worker's memory pool the first time the worker runs a
+ * solve with them, and they are used again for every later solve, so
+ * the operator and the preconditioner must not be changed or deleted
+ * while the queue has copies of them. The initial approximation and
+ * the right hand side are copied when the solve is submitted.
+ *
+ * @param linearization The operator for the system.
+ * @param initial The initial approximation.
+ * @param rhs The right hand side of the system.
+ * @param precond The preconditioner for the system.
+ * @param krylovDimension The number of vectors in the Krylov subspace.
+ * @param numberRestarts Number of times to repeat the GMRES iterations.
+ * @param tolerance How small the relative residual should be.
+ * @return The future for the approximation, iterations, and report.
+ * ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner>
+std::future<SolveResult<Approximation> > SolveQueue::solve(const Operation* linearization,const Approximation &initial,
+																													 const Approximation &rhs,const Preconditioner* precond,
+																													 int krylovDimension,int numberRestarts,double tolerance)
+{
+	return(emplace<SolveResult<Approximation>,SolveQueueSolve<Operation,Approximation,Preconditioner> >
+				 (this,linearization,initial,rhs,precond,krylovDimension,numberRestarts,tolerance));
+}
+
+
+/** ************************************************************************
+ * Do a solve given to the solve method of the SolveQueue class. It is
+ * run by a worker, and it uses the worker's copies of the operator
+ * and the preconditioner.
+ *
+ * @return The approximation, iterations, and report.
+ * ************************************************************************ */
+template <class Operation,class Approximation,class Preconditioner>
+SolveResult<Approximation> SolveQueueSolve<Operation,Approximation,Preconditioner>::operator()()
+{
+	std::shared_ptr<Operation> elliptical = queue->workerCopy(linearization);
+	std::shared_ptr<Preconditioner> pre   = queue->workerCopy(precond);
+	ReportMonitor monitor;
+	SolveResult<Approximation> result(x);
+	result.iterations = GMRES(elliptical.get(),&result.solution,&b,pre.get(),
+														krylovDimension,numberRestarts,tolerance,monitor);
+	result.report = monitor.getReport();
+	return(result);
+}
+
+
+/** ************************************************************************
+ * Get the calling worker's copy of an object.
+ *
+ * The copy is made from the worker's memory pool the first time the
+ * worker asks for it. It is kept until the queue is destroyed or
+ * forget is called for the original. It must be called by a worker of
+ * this queue.
+ *
+ * @param original The object to copy.
+ * @return The worker's copy.
+ * ************************************************************************ */
+template <class Object>
+std::shared_ptr<Object> SolveQueue::workerCopy(const Object *original)
+{
+	Worker &own = *workers[currentIndex()];
+	{
+		std::lock_guard<std::mutex> guard(own.lock);
+		std::map<const void*,std::shared_ptr<void> >::iterator copy = own.copies.find(original);
+		if(copy != own.copies.end())
+			return(std::static_pointer_cast<Object>(copy->second));
+	}
+
+	std::shared_ptr<Object> copy = std::allocate_shared<Object>(PoolAllocator<Object>(),*original);
+	std::lock_guard<std::mutex> guard(own.lock);
+	own.copies[original] = copy;
+	return(copy);
+}
+
+
+/** ************************************************************************
+ * Drop the copies that the workers made of an object. A solve that is
+ * running keeps its copy until it is finished, and later solves make
+ * a new copy. It must be called before the object is changed or
+ * deleted if solves with it were given to the queue.
+ *
+ * @param original The object that was copied.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveQueue::forget(const void *original)
+{
+	std::vector<std::unique_ptr<Worker> >::iterator worker;
+	for(worker=workers.begin();worker!=workers.end();++worker)
+		{
+			std::lock_guard<std::mutex> guard((*worker)->lock);
+			(*worker)->copies.erase(original);
+		}
+}
+
+
+/** ************************************************************************
+ * Wait until every task that has been submitted is finished.
+ *
+ * It must not be called by a worker.
+ *
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveQueue::wait()
+{
+	std::unique_lock<std::mutex> guard(sleepLock);
+	while(unfinished > 0)
+		finished.wait(guard);
+}
+
+
+/** ************************************************************************
+ * Get a node for a task. A node from the spare list is used if there
+ * is one.
+ *
+ * @return The node.
+ * ************************************************************************ */
+inline SolveQueue::TaskNode *SolveQueue::spareTask()
+{
+	{
+		std::lock_guard<std::mutex> guard(spareLock);
+		if(spare != 0)
+			{
+				TaskNode *task = spare;
+				spare = task->next;
+				return(task);
+			}
+	}
+	return(new TaskNode());
+}
+
+
+/** ************************************************************************
+ * Put a node on the spare list so that it can be used for a later task.
+ *
+ * @param task The node whose task is finished.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveQueue::recycle(TaskNode *task)
+{
+	std::lock_guard<std::mutex> guard(spareLock);
+	task->next = spare;
+	spare = task;
+}
+
+
+/** ************************************************************************
+ * Put a task on the queue of a worker.
+ *
+ * A task from one of this queue's workers goes on the back of its own
+ * queue. Other tasks are given to the workers in turn. A sleeping
+ * worker is woken, and it steals the task if it is not on its own
+ * queue.
+ *
+ * @param task The task to queue.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveQueue::push(TaskNode *task)
+{
+	int worker = currentIndex();
+	if((currentQueue() != this) || (worker < 0))
+		worker = (int)(next++ % workers.size());
+
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		unfinished += 1;
+	}
+	{
+		Worker &own = *workers[worker];
+		std::lock_guard<std::mutex> guard(own.lock);
+		task->previous = own.last;
+		task->next     = 0;
+		if(own.last != 0)
+			own.last->next = task;
+		else
+			own.first = task;
+		own.last = task;
+	}
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		queued += 1;
+	}
+	wake.notify_one();
+}
+
+
+/** ************************************************************************
+ * Get the next task for a worker.
+ *
+ * The newest task on the worker's own queue is taken first. If its
+ * queue is empty the oldest task on the next worker's queue that has
+ * one is stolen.
+ *
+ * @param worker The index of the worker.
+ * @param task The task that was found.
+ * @return True if a task was found.
+ * ************************************************************************ */
+inline bool SolveQueue::take(int worker,TaskNode *&task)
+{
+	{
+		Worker &own = *workers[worker];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if(own.last != 0)
+			{
+				task = own.last;
+				own.last = task->previous;
+				if(own.last != 0)
+					own.last->next = 0;
+				else
+					own.first = 0;
+				queued -= 1;
+				return(true);
+			}
+	}
+
+	int number = (int)workers.size();
+	int offset;
+	for(offset=1;offset<number;++offset)
+		{
+			Worker &victim = *workers[(worker+offset)%number];
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if(victim.first != 0)
+				{
+					task = victim.first;
+					victim.first = task->next;
+					if(victim.first != 0)
+						victim.first->previous = 0;
+					else
+						victim.last = 0;
+					queued -= 1;
+					steals += 1;
+					return(true);
+				}
+		}
+
+	return(false);
+}
+
+
+/** ************************************************************************
+ * The loop run by each worker.
+ *
+ * The worker keeps a memory pool for as long as it runs, and every
+ * task it runs takes its memory from the pool. It sleeps when there
+ * are no tasks in any queue, and it stops when it is told to and the
+ * queues are empty. The copies made by the worker are deleted before
+ * its pool is closed.
+ *
+ * @param worker The index of the worker.
+ * @return N/A
+ * ************************************************************************ */
+inline void SolveQueue::run(int worker)
+{
+	currentQueue() = this;
+	currentIndex() = worker;
+	MemoryPoolScope workspace;
+
+	TaskNode *task;
+	while(true)
+		{
+			if(take(worker,task))
+				{
+					task->execute(task);
+					recycle(task);
+					executed += 1;
+
+					std::lock_guard<std::mutex> guard(sleepLock);
+					if(--unfinished == 0)
+						finished.notify_all();
+					continue;
+				}
+
+			std::unique_lock<std::mutex> guard(sleepLock);
+			if(queued.load() > 0)
+				continue;
+			if(stopping)
+				break;
+			wake.wait(guard);
+		}
+
+	{
+		std::lock_guard<std::mutex> guard(workers[worker]->lock);
+		workers[worker]->copies.clear();
+	}
+	currentQueue() = 0;
+	currentIndex() = -1;
+}
+
+
+/** ************************************************************************
+ * The index of the worker that is running the calling thread.
+ *
+ * @return The index of the worker, or -1 if the thread is not a worker.
+ * ************************************************************************ */
+inline int SolveQueue::currentWorker()
+{
+	return(currentIndex());
+}
+
+
+/** ************************************************************************
+ * The queue whose worker is running the calling thread.
+ *
+ * @return A reference to the pointer kept for the calling thread.
+ * ************************************************************************ */
+inline SolveQueue *&SolveQueue::currentQueue()
+{
+	static thread_local SolveQueue *queue = 0;
+	return(queue);
+}
+
+
+/** ************************************************************************
+ * The index of the worker that is running the calling thread.
+ *
+ * @return A reference to the index kept for the calling thread.
+ * ************************************************************************ */
+inline int &SolveQueue::currentIndex()
+{
+	static thread_local int index = -1;
+	return(index);
+}
+
+
+#endif
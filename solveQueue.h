@@ -0,0 +1,276 @@
+#ifndef SOLVEQUEUEROUTINE
+#define SOLVEQUEUEROUTINE
+
+
+/** *********************************************************************************
+ * @file solveQueue.h
+ * @class SolveQueue
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to spread many independent solves across a set of threads.
+ *
+ * This is the definition (header) file for the SolveQueue class and
+ * the SolveResult structure. Each worker thread has its own double
+ * ended queue of tasks. A worker takes the newest task from its own
+ * queue, and when its queue is empty it steals the oldest task from
+ * one of the other workers. A solve that needs many iterations does
+ * not hold up the tasks behind it since an idle worker takes them.
+ *
+ * Every worker keeps a MemoryPoolScope for as long as it runs, and it
+ * is the workspace for the solves done by that worker. The vectors and
+ * matrices used by the GMRES routine are returned to the pool at the
+ * end of a solve, and the next solve on the same worker reuses them,
+ * so after the first few tasks a solve does not get any memory from
+ * the system.
+ *
+ * A task is any function with no arguments, and its result is
+ * returned through a std::future. The solve method submits a GMRES
+ * solve, and the future holds the approximation, the number of
+ * iterations, and the SolveReport for the solve.
+ *
+ * A task is built in place in a node that has room for it, and the
+ * nodes are linked into the queues of the workers. A node is put on a
+ * spare list when its task is finished and is used again for a later
+ * task, and the state shared with the future comes from the memory
+ * pool of the thread that submits the task. Once the queue has run a
+ * few tasks, submitting one does not call the system allocator.
+ *
+ * Each worker makes its own copy of an operator or a preconditioner
+ * the first time it runs a solve with it, and it uses that copy for
+ * every later solve with the same object. The copies are kept until
+ * the queue is destroyed or forget is called for the object.
+ *
+ *
+ * @brief Header file for the work stealing queue of solves.
+ *
+ * ********************************************************************************* */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "monitor.h"
+#include "pool.h"
+
+// The number of bytes in a node that can be used by a task.
+#define SOLVEQUEUETASKBYTES 256
+
+/**
+	 The result of a solve done by the SolveQueue class.
+*/
+template <class Approximation>
+struct SolveResult
+{
+	SolveResult(const Approximation &initial) : solution(initial), iterations(0), stopped(false) {}
+
+	Approximation solution;     //< The approximation found by the solve.
+	int iterations;             //< The value returned by the GMRES routine.
+	SolveReport report;         //< The history and times for the solve.
+	bool stopped;               //< True if the solve was cancelled or ran past its deadline.
+};
+
+
+/**
+	 A task that is kept in a node of the SolveQueue class. It holds the
+	 function to run and the promise for its result.
+*/
+template <class Result,class Function>
+struct SolveQueueCall
+{
+	template <class... Arguments>
+	SolveQueueCall(Arguments&&... arguments)
+		: promise(std::allocator_arg,PoolAllocator<Result>()), function(std::forward<Arguments>(arguments)...) {}
+
+	void operator()();          //< Run the function and give its result to the promise.
+
+	std::promise<Result> promise; //< The promise for the result.
+	Function function;            //< The function to run.
+};
+
+
+class SolveQueue
+{
+
+public:
+	SolveQueue(int number=0);                             //< Start the workers, one per processor if zero.
+	~SolveQueue();                                        //< Finish the tasks that are queued and stop the workers.
+
+	template <class Task>
+	std::future<typename std::result_of<Task()>::type> submit(Task task);
+
+	template <class Result,class Function,class... Arguments>
+	std::future<Result> emplace(Arguments&&... arguments);
+
+	template <class Operation,class Approximation,class Preconditioner>
+	std::future<SolveResult<Approximation> > solve(const Operation* linearization,const Approximation &initial,
+																								 const Approximation &rhs,const Preconditioner* precond,
+																								 int krylovDimension,int numberRestarts,double tolerance);
+
+	void wait();                                          //< Wait until every task that was submitted is finished.
+	static int currentWorker();                           //< The worker running the calling thread, or -1.
+
+	template <class Object>
+	std::shared_ptr<Object> workerCopy(const Object *original); //< The calling worker's copy of an object.
+	void forget(const void *original);                    //< Drop the copies that the workers made of an object.
+
+	/**
+		 Method to get the number of worker threads.
+
+		 @return The number of workers.
+	*/
+	int getWorkers() const
+	{
+		return((int)workers.size());
+	}
+
+	/**
+		 Method to get the number of tasks that were taken from the
+		 queue of another worker.
+
+		 @return The number of tasks that were stolen.
+	*/
+	unsigned long getSteals() const
+	{
+		return(steals.load());
+	}
+
+	/**
+		 Method to get the number of tasks that have been run.
+
+		 @return The number of tasks that are finished.
+	*/
+	unsigned long getExecuted() const
+	{
+		return(executed.load());
+	}
+
+protected:
+
+	/**
+		 A node that holds one task. The task is built in the storage,
+		 and execute runs it and then destroys it.
+	*/
+	struct TaskNode
+	{
+		void (*execute)(TaskNode *task);                        //< Run the task kept in the storage.
+		TaskNode *previous;                                     //< The task in front of this one in a queue.
+		TaskNode *next;                                         //< The task behind this one, or the next spare node.
+		alignas(std::max_align_t) unsigned char storage[SOLVEQUEUETASKBYTES];
+	};
+
+	/**
+		 The queue of tasks, the copies of the objects it uses, and the
+		 thread for one worker.
+	*/
+	struct Worker
+	{
+		Worker() : first(0), last(0) {}
+
+		std::mutex lock;                                    //< Lock for the queue of tasks and the copies.
+		TaskNode *first;                                        //< The oldest task given to the worker.
+		TaskNode *last;                                         //< The newest task given to the worker.
+		std::map<const void*,std::shared_ptr<void> > copies; //< The copies made by the worker, by original.
+		std::thread thread;                                 //< The thread that runs the tasks.
+	};
+
+	template <class Call>
+	static void execute(TaskNode *task);                      //< Run a task of a given type and destroy it.
+
+	TaskNode *spareTask();                                    //< Get a node from the spare list or the system.
+	void recycle(TaskNode *task);                             //< Put a node on the spare list.
+	void push(TaskNode *task);                                //< Put a task on the queue of a worker.
+	bool take(int worker,TaskNode *&task);                    //< Get a task from a worker's queue or steal one.
+	void run(int worker);                                 //< The loop run by each worker.
+	static SolveQueue *&currentQueue();                   //< The queue whose worker is the calling thread.
+	static int &currentIndex();                           //< The index of the worker for the calling thread.
+
+private:
+
+	std::vector<std::unique_ptr<Worker> > workers;        //< The workers and their queues.
+	std::mutex sleepLock;                                 //< Lock used by the workers to wait for tasks.
+	std::condition_variable wake;                         //< Signal that a task was queued or the workers should stop.
+	std::condition_variable finished;                     //< Signal that every task is finished.
+	std::atomic<long> queued;                             //< The number of tasks that are waiting in a queue.
+	long unfinished;                                      //< The number of tasks that are not finished.
+	std::atomic<unsigned long> next;                      //< The worker given the next task from outside the queue.
+	std::atomic<unsigned long> steals;                    //< The number of tasks that were stolen.
+	std::atomic<unsigned long> executed;                  //< The number of tasks that were run.
+	bool stopping;                                        //< Flag to tell the workers to stop.
+	std::mutex spareLock;                                 //< Lock for the spare list.
+	TaskNode *spare;                                          //< The nodes that are not in use.
+
+	SolveQueue(const SolveQueue& oldCopy);                //< The queue cannot be copied.
+
+};
+
+
+/**
+	 The function run by a worker for the solve method of the SolveQueue
+	 class. The initial approximation and the right hand side are copied
+	 when it is built.
+*/
+template <class Operation,class Approximation,class Preconditioner>
+struct SolveQueueSolve
+{
+	SolveQueueSolve(SolveQueue *queue,const Operation* linearization,const Approximation &initial,
+									const Approximation &rhs,const Preconditioner* precond,
+									int krylovDimension,int numberRestarts,double tolerance)
+		: queue(queue), linearization(linearization), x(initial), b(rhs), precond(precond),
+			krylovDimension(krylovDimension), numberRestarts(numberRestarts), tolerance(tolerance) {}
+
+	SolveResult<Approximation> operator()();            //< Do the solve on the calling worker.
+
+	SolveQueue *queue;                  //< The queue that runs the solve.
+	const Operation *linearization;     //< The operator given to the solve method.
+	Approximation x;                    //< The initial approximation.
+	Approximation b;                    //< The right hand side of the system.
+	const Preconditioner *precond;      //< The preconditioner given to the solve method.
+	int krylovDimension;                //< The number of vectors in the Krylov subspace.
+	int numberRestarts;                 //< Number of times to repeat the GMRES iterations.
+	double tolerance;                   //< How small the relative residual should be.
+};
+
+
+#include "solveQueue.cpp"
+
+
+#endif
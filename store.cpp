@@ -0,0 +1,442 @@
+#ifndef STOREROUTINEDEFINITIONS
+#define STOREROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file store.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep precomputed matrices in a binary file that is mapped
+ * into memory.
+ *
+ * This is the code file for the MatrixStore class. The file is
+ * included by the header, so every method that is not a template is
+ * declared inline.
+ *
+ *
+ * @brief Code file for the memory-mapped store of matrices.
+ *
+ * ********************************************************************************* */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "store.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the MatrixStore class.
+ *
+ * No file is mapped.
+ * ************************************************************************ */
+inline MatrixStore::MatrixStore()
+{
+	mapping     = NULL;
+	mappedBytes = 0;
+}
+
+
+/** ************************************************************************
+ * Destructor for the MatrixStore class.
+ *
+ * The file is unmapped, so any views of its entries can no longer be
+ * used.
+ * ************************************************************************ */
+inline MatrixStore::~MatrixStore()
+{
+	close();
+}
+
+
+/** ************************************************************************
+ * Map a file and check that it matches the given key.
+ *
+ * The file is mapped read only. If the file does not exist, or the
+ * magic string, the version, the byte order, the number of grid
+ * points, the grid type, the size, or the checksum do not match, then
+ * nothing is mapped.
+ *
+ * @param fileName The name of the file.
+ * @param number The number of grid points the file must be for.
+ * @param grid The type of grid the file must be for.
+ * @return True if the file is mapped.
+ * ************************************************************************ */
+inline bool MatrixStore::open(const std::string &fileName,int number,int grid)
+{
+	close();
+	if(fileName.empty())
+		return(false);
+
+	int descriptor = ::open(fileName.c_str(),O_RDONLY);
+	if(descriptor<0)
+		return(false);
+
+	struct stat status;
+	if((fstat(descriptor,&status)!=0) ||
+		 ((std::size_t)status.st_size<sizeof(MatrixStoreHeader)))
+		{
+			::close(descriptor);
+			return(false);
+		}
+
+	void *memory = mmap(NULL,(std::size_t)status.st_size,PROT_READ,MAP_SHARED,descriptor,0);
+	::close(descriptor);
+	if(memory==MAP_FAILED)
+		return(false);
+	mapping     = (char*)memory;
+	mappedBytes = (std::size_t)status.st_size;
+
+	// Check the header and then the table. The sizes are checked
+	// before the table is read.
+	const MatrixStoreHeader *header = (const MatrixStoreHeader*)mapping;
+	bool valid = (std::memcmp(header->magic,"GMRESMAT",8)==0) &&
+		(header->version==MATRIXSTOREVERSION) &&
+		(header->byteOrder==0x01020304) &&
+		(header->number==number) &&
+		(header->grid==grid) &&
+		(header->fileBytes==mappedBytes) &&
+		(sizeof(MatrixStoreHeader)+header->entries*sizeof(MatrixStoreEntry)<=mappedBytes);
+
+	if(valid)
+		{
+			const MatrixStoreEntry *table = (const MatrixStoreEntry*)(mapping+sizeof(MatrixStoreHeader));
+			valid = (keyFor(*header,table)==header->key);
+			std::uint32_t lupe;
+			for(lupe=0;valid&&(lupe<header->entries);++lupe)
+				valid = (table[lupe].offset+table[lupe].bytes<=mappedBytes);
+		}
+
+	if(!valid)
+		close();
+	return(valid);
+}
+
+
+/** ************************************************************************
+ * Unmap the current file.
+ *
+ * ************************************************************************ */
+inline void MatrixStore::close()
+{
+	if(mapping!=NULL)
+		munmap(mapping,mappedBytes);
+	mapping     = NULL;
+	mappedBytes = 0;
+}
+
+
+/** ************************************************************************
+ * Make a tensor that is a view of an entry in the mapped file.
+ *
+ * The view does not have the padding of a tensor that owns its
+ * memory. The memory is read only, so the entries of the view must not
+ * be changed. A copy of the view is a tensor that owns its own memory.
+ *
+ * @param name The name of the entry.
+ * @param values The tensor that is set to the view.
+ * @return True if the entry was found with the same rank and type.
+ * ************************************************************************ */
+template <class number,int Rank>
+bool MatrixStore::find(const char *name,Tensor<number,Rank> &values) const
+{
+	static_assert(Rank<=MATRIXSTORERANK,"The rank is larger than a file can keep.");
+	const MatrixStoreEntry *entry = lookup(name,Rank,(int)sizeof(number));
+	if(entry==NULL)
+		return(false);
+
+	// The view is only used to read the entries, so the constant
+	// qualifier of the mapping can be dropped.
+	number *data = (number*)(mapping+entry->offset);
+	int shape[Rank];
+	int lupe;
+	for(lupe=0;lupe<Rank;++lupe)
+		shape[lupe] = entry->extent[lupe];
+	values = Tensor<number,Rank>::view(data,shape);
+	return(true);
+}
+
+
+/** ************************************************************************
+ * Add a tensor to the next file to be saved.
+ *
+ * Only a reference to the memory of the tensor is kept, so the tensor
+ * must not be changed or deleted until the file is saved.
+ *
+ * @param name The name of the entry.
+ * @param values The tensor to add.
+ * ************************************************************************ */
+template <class number,int Rank>
+void MatrixStore::add(const char *name,const Tensor<number,Rank> &values)
+{
+	static_assert(Rank<=MATRIXSTORERANK,"The rank is larger than a file can keep.");
+	Pending item;
+	int lupe;
+
+	std::memset(&item.entry,0,sizeof(MatrixStoreEntry));
+	std::strncpy(item.entry.name,name,MATRIXSTORENAME-1);
+	item.entry.rank       = Rank;
+	item.entry.entryBytes = (int)sizeof(number);
+
+	// The padding is only at the end of the last dimension, so the
+	// tensor is a set of rows that are a fixed distance apart.
+	item.rows = 1;
+	for(lupe=0;lupe<Rank;++lupe)
+		{
+			item.entry.extent[lupe] = values.getExtent(lupe);
+			if(lupe<Rank-1)
+				item.rows *= (std::size_t)values.getExtent(lupe);
+		}
+	item.values      = (const char*)values.data();
+	item.rowBytes    = (std::size_t)values.getExtent(Rank-1)*sizeof(number);
+	item.strideBytes = (Rank>1) ? values.getStride(Rank-2)*sizeof(number) : item.rowBytes;
+	item.entry.bytes = item.rows*item.rowBytes;
+	pending.push_back(item);
+}
+
+
+/** ************************************************************************
+ * Write the tensors that have been added to a file.
+ *
+ * The file is written to a temporary name in the same directory and
+ * then renamed, so a process that opens the file either sees the old
+ * file or the complete new one. The list of tensors is cleared.
+ *
+ * @param fileName The name of the file.
+ * @param number The number of grid points the matrices are for.
+ * @param grid The type of grid the matrices are for.
+ * @return True if the file was written.
+ * ************************************************************************ */
+inline bool MatrixStore::save(const std::string &fileName,int number,int grid)
+{
+	std::vector<Pending> items;
+	items.swap(pending);
+	if(fileName.empty())
+		return(false);
+
+	// Define the header and place the data for every entry after the
+	// table.
+	MatrixStoreHeader header;
+	std::memset(&header,0,sizeof(MatrixStoreHeader));
+	std::memcpy(header.magic,"GMRESMAT",8);
+	header.version   = MATRIXSTOREVERSION;
+	header.byteOrder = 0x01020304;
+	header.number    = number;
+	header.grid      = grid;
+	header.entries   = (std::uint32_t)items.size();
+
+	std::vector<MatrixStoreEntry> table(items.size());
+	std::uint64_t position = sizeof(MatrixStoreHeader)+items.size()*sizeof(MatrixStoreEntry);
+	std::size_t lupe;
+	for(lupe=0;lupe<items.size();++lupe)
+		{
+			position = (position+ARRAYALIGNMENT-1)/ARRAYALIGNMENT*ARRAYALIGNMENT;
+			items[lupe].entry.offset = position;
+			table[lupe] = items[lupe].entry;
+			position += items[lupe].entry.bytes;
+		}
+	header.fileBytes = position;
+	header.key       = keyFor(header,table.data());
+
+	// Write everything to the temporary file.
+	char suffix[32];
+	std::snprintf(suffix,sizeof(suffix),".%ld.tmp",(long)getpid());
+	std::string temporary = fileName + suffix;
+	std::FILE *fp = std::fopen(temporary.c_str(),"wb");
+	if(fp==NULL)
+		return(false);
+
+	bool written = (std::fwrite(&header,sizeof(MatrixStoreHeader),1,fp)==1);
+	if(written && (table.size()>0))
+		written = (std::fwrite(table.data(),sizeof(MatrixStoreEntry),table.size(),fp)==table.size());
+
+	static const char zeros[ARRAYALIGNMENT] = {0};
+	std::uint64_t current = sizeof(MatrixStoreHeader)+table.size()*sizeof(MatrixStoreEntry);
+	for(lupe=0;written&&(lupe<items.size());++lupe)
+		{
+			std::size_t gap = (std::size_t)(items[lupe].entry.offset-current);
+			if(gap>0)
+				written = (std::fwrite(zeros,1,gap,fp)==gap);
+
+			std::size_t row;
+			for(row=0;written&&(row<items[lupe].rows);++row)
+				written = (std::fwrite(items[lupe].values+row*items[lupe].strideBytes,
+															 1,items[lupe].rowBytes,fp)==items[lupe].rowBytes);
+			current = items[lupe].entry.offset+items[lupe].entry.bytes;
+		}
+
+	written = (std::fclose(fp)==0) && written;
+	if(written)
+		written = (std::rename(temporary.c_str(),fileName.c_str())==0);
+	if(!written)
+		std::remove(temporary.c_str());
+	return(written);
+}
+
+
+/** ************************************************************************
+ * Set the directory used for the files.
+ *
+ * An empty string means that the directory is taken from the
+ * environment variable given by MATRIXSTOREENVIRONMENT.
+ *
+ * @param directory The directory for the files.
+ * ************************************************************************ */
+inline void MatrixStore::setDirectory(const std::string &directory)
+{
+	directorySetting() = directory;
+}
+
+
+/** ************************************************************************
+ * Get the directory used for the files.
+ *
+ * @return The directory, or an empty string if files are not used.
+ * ************************************************************************ */
+inline std::string MatrixStore::getDirectory()
+{
+	if(!directorySetting().empty())
+		return(directorySetting());
+
+	const char *environment = std::getenv(MATRIXSTOREENVIRONMENT);
+	if(environment==NULL)
+		return(std::string());
+	return(std::string(environment));
+}
+
+
+/** ************************************************************************
+ * Get the name of the file for a kind of matrix.
+ *
+ * @param kind A short name for the kind of matrices in the file.
+ * @param number The number of grid points.
+ * @param grid The type of grid.
+ * @return The name of the file, or an empty string if files are not used.
+ * ************************************************************************ */
+inline std::string MatrixStore::fileName(const char *kind,int number,int grid)
+{
+	std::string directory = getDirectory();
+	if(directory.empty())
+		return(directory);
+
+	char name[96];
+	std::snprintf(name,sizeof(name),"/%s-%d-%d.mat",kind,number,grid);
+	return(directory+name);
+}
+
+
+/** ************************************************************************
+ * Find an entry in the table of the mapped file.
+ *
+ * @param name The name of the entry.
+ * @param rank The rank the entry must have.
+ * @param entryBytes The size of one value in the entry.
+ * @return The entry, or NULL if there is no matching entry.
+ * ************************************************************************ */
+inline const MatrixStoreEntry *MatrixStore::lookup(const char *name,int rank,int entryBytes) const
+{
+	if(mapping==NULL)
+		return(NULL);
+
+	const MatrixStoreHeader *header = (const MatrixStoreHeader*)mapping;
+	const MatrixStoreEntry *table = (const MatrixStoreEntry*)(mapping+sizeof(MatrixStoreHeader));
+	std::uint32_t lupe;
+	for(lupe=0;lupe<header->entries;++lupe)
+		if((std::strncmp(table[lupe].name,name,MATRIXSTORENAME)==0) &&
+			 (table[lupe].rank==rank) &&
+			 (table[lupe].entryBytes==entryBytes))
+			return(table+lupe);
+
+	return(NULL);
+}
+
+
+/** ************************************************************************
+ * Add a block of bytes to a 64 bit FNV-1a checksum.
+ *
+ * @param data The bytes to add.
+ * @param bytes The number of bytes.
+ * @param hash The current value of the checksum.
+ * @return The new value of the checksum.
+ * ************************************************************************ */
+inline std::uint64_t MatrixStore::checksum(const void *data,std::size_t bytes,std::uint64_t hash)
+{
+	const unsigned char *current = (const unsigned char*)data;
+	std::size_t lupe;
+	for(lupe=0;lupe<bytes;++lupe)
+		{
+			hash ^= (std::uint64_t)current[lupe];
+			hash *= 1099511628211ULL;
+		}
+	return(hash);
+}
+
+
+/** ************************************************************************
+ * Determine the key for a header and its table.
+ *
+ * The key is the checksum of the header with the key set to zero and
+ * of the table. The data is not included, so the key can be checked
+ * without reading the whole file.
+ *
+ * @param header The header of the file.
+ * @param table The table of entries.
+ * @return The key.
+ * ************************************************************************ */
+inline std::uint64_t MatrixStore::keyFor(const MatrixStoreHeader &header,const MatrixStoreEntry *table)
+{
+	MatrixStoreHeader copy = header;
+	copy.key = 0;
+	std::uint64_t hash = checksum(&copy,sizeof(MatrixStoreHeader),14695981039346656037ULL);
+	return(checksum(table,header.entries*sizeof(MatrixStoreEntry),hash));
+}
+
+
+/** ************************************************************************
+ * The directory given to setDirectory.
+ *
+ * @return A reference to the setting.
+ * ************************************************************************ */
+inline std::string &MatrixStore::directorySetting()
+{
+	static std::string directory;
+	return(directory);
+}
+
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef STOREROUTINE
+#define STOREROUTINE
+
+
+/** *********************************************************************************
+ * @file store.h
+ * @class MatrixStore
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep precomputed matrices in a binary file that is mapped
+ * into memory.
+ *
+ * This is the definition (header) file for the MatrixStore class. A
+ * file holds a set of named tensors that are computed for a given
+ * number of grid points and type of grid. The file starts with a
+ * header and a table of entries, and the data for every entry starts
+ * on an ARRAYALIGNMENT byte boundary. The entries are stored without
+ * the padding used by the Tensor class. The header has a magic
+ * string, a version number, and a key that is a checksum of the
+ * header and the table. A file is only used if the version, the
+ * number of grid points, the grid type, and the key all match.
+ *
+ * The file is mapped read only, so the processes that use the same
+ * file share the same pages in the page cache, and an entry is only
+ * read from the disk when it is first touched. An entry is returned
+ * as a Tensor that is a view of the mapped memory. The views must not
+ * be written to, and they are only valid while the store is open.
+ *
+ * A new file is written to a temporary name and then renamed so that
+ * another process never sees a file that is only partly written.
+ *
+ *
+ * @brief Header file for the memory-mapped store of matrices.
+ *
+ * ********************************************************************************* */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tensor.h"
+
+// The version of the file format. Files with a different version are
+// ignored and rebuilt.
+#define MATRIXSTOREVERSION 1
+
+// The largest rank of a tensor that can be kept in a file, and the
+// longest name of an entry including the terminating character.
+#define MATRIXSTORERANK 4
+#define MATRIXSTORENAME 24
+
+// The environment variable with the directory for the files. If it is
+// not set and no directory is given then the files are not used.
+#define MATRIXSTOREENVIRONMENT "GMRES_MATRIX_STORE"
+
+/**
+	 The header at the start of a file.
+ */
+struct MatrixStoreHeader
+{
+	char          magic[8];       //< The string GMRESMAT.
+	std::uint32_t version;        //< The version of the file format.
+	std::uint32_t byteOrder;      //< The value 0x01020304 written in the order of the machine.
+	std::int32_t  number;         //< The number of grid points.
+	std::int32_t  grid;           //< The type of grid.
+	std::uint32_t entries;        //< The number of entries in the table.
+	std::uint32_t reserved;       //< Unused, set to zero.
+	std::uint64_t fileBytes;      //< The size of the file.
+	std::uint64_t key;            //< Checksum of the header, with the key set to zero, and the table.
+};
+
+/**
+	 An entry in the table that follows the header.
+ */
+struct MatrixStoreEntry
+{
+	char          name[MATRIXSTORENAME];     //< The name of the entry.
+	std::int32_t  rank;                      //< The rank of the tensor.
+	std::int32_t  entryBytes;                //< The size of one value.
+	std::int32_t  extent[MATRIXSTORERANK];   //< The extent of every dimension.
+	std::uint64_t offset;                    //< The position of the data from the start of the file.
+	std::uint64_t bytes;                     //< The size of the data.
+};
+
+
+class MatrixStore
+{
+
+public:
+	MatrixStore();                                           //< Default constructor for the class
+	~MatrixStore();                                          //< Destructor for the class
+
+	// Define the methods used to read a file.
+	bool open(const std::string &fileName,int number,int grid);  //< Map a file if it matches the given key.
+	void close();                                            //< Unmap the current file.
+	template <class number,int Rank>
+	bool find(const char *name,Tensor<number,Rank> &values) const; //< Make a tensor that is a view of an entry.
+
+	// Define the methods used to write a file.
+	template <class number,int Rank>
+	void add(const char *name,const Tensor<number,Rank> &values); //< Add a tensor to the next file to be saved.
+	bool save(const std::string &fileName,int number,int grid);   //< Write the added tensors to a file.
+
+	// Define the methods used to find the files.
+	static void setDirectory(const std::string &directory);  //< Set the directory used for the files.
+	static std::string getDirectory();                       //< The directory used for the files.
+	static std::string fileName(const char *kind,int number,int grid); //< The file for a given kind of matrix.
+
+	/**
+		 Method to determine whether or not a file is mapped.
+
+		 @return True if a file is mapped.
+	 */
+	bool isOpen() const
+	{
+		return(mapping!=NULL);
+	}
+
+
+protected:
+
+	/**
+		 The rows of a tensor that has been added but not yet saved.
+	 */
+	struct Pending
+	{
+		MatrixStoreEntry entry;      //< The entry for the table.
+		const char *values;          //< The first row.
+		std::size_t rows;            //< The number of rows.
+		std::size_t rowBytes;        //< The number of bytes in a row without the padding.
+		std::size_t strideBytes;     //< The number of bytes between the start of two rows.
+	};
+
+	const MatrixStoreEntry *lookup(const char *name,int rank,int entryBytes) const; //< Find an entry in the table.
+	static std::uint64_t checksum(const void *data,std::size_t bytes,std::uint64_t hash); //< FNV-1a checksum.
+	static std::uint64_t keyFor(const MatrixStoreHeader &header,const MatrixStoreEntry *table);
+	static std::string &directorySetting();                  //< The directory given to setDirectory.
+
+
+private:
+	MatrixStore(const MatrixStore& oldCopy);                 //< The mapping cannot be shared by copying.
+	MatrixStore& operator=(const MatrixStore& oldCopy);
+
+	char *mapping;                    //< The start of the mapped file.
+	std::size_t mappedBytes;          //< The size of the mapped file.
+	std::vector<Pending> pending;     //< The tensors waiting to be saved.
+
+};
+
+
+#include "store.cpp"
+
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef TENSORROUTINEDEFINITIONS
+#define TENSORROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file tensor.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep a multi-dimensional array in a single block of memory.
+ *
+ * This is the code file for the Tensor class. It includes the code
+ * to allocate, copy, and release the memory for a tensor.
+ *
+ *
+ * @brief Code file for the contiguous multi-dimensional array.
+ *
+ * ********************************************************************************* */
+
+
+#include "pool.h"
+#include "tensor.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the Tensor class.
+ *
+ * The tensor is empty and has no memory.
+ *
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>::Tensor()
+{
+	int lupe;
+	for(lupe=0;lupe<Rank;++lupe)
+		{
+			extent[lupe] = 0;
+			stride[lupe] = 0;
+		}
+	values = NULL;
+	size   = 0;
+	owner  = true;
+}
+
+
+/** ************************************************************************
+ * Constructor for a tensor with a given shape.
+ *
+ * Every entry is set to zero.
+ *
+ * @param n1 The number of entries in the first dimension.
+ * @param extents The number of entries in the remaining dimensions.
+ * ************************************************************************ */
+template <class number,int Rank>
+template <class... Extent>
+Tensor<number,Rank>::Tensor(int n1,Extent... extents)
+{
+	static_assert(1+sizeof...(Extent)==Rank,"The number of extents must match the rank.");
+	int shape[Rank] = {n1,extents...};
+	define(shape);
+	allocate();
+	zero();
+}
+
+
+/** ************************************************************************
+ * Constructor for a tensor with a given shape whose entries are not
+ * set. Every entry must be written before it is read.
+ *
+ * @param n1 The number of entries in the first dimension.
+ * @param extents The number of entries in the remaining dimensions.
+ * ************************************************************************ */
+template <class number,int Rank>
+template <class... Extent>
+Tensor<number,Rank>::Tensor(TensorUninitialized,int n1,Extent... extents)
+{
+	static_assert(1+sizeof...(Extent)==Rank,"The number of extents must match the rank.");
+	int shape[Rank] = {n1,extents...};
+	define(shape);
+	allocate();
+}
+
+
+/** ************************************************************************
+ * Constructor for a tensor with a given shape whose entries are zero
+ * pages from an anonymous mapping. The pages are first touched by
+ * the routine that first uses them rather than by the constructor.
+ *
+ * @param n1 The number of entries in the first dimension.
+ * @param extents The number of entries in the remaining dimensions.
+ * ************************************************************************ */
+template <class number,int Rank>
+template <class... Extent>
+Tensor<number,Rank>::Tensor(TensorZeroOnDemand,int n1,Extent... extents)
+{
+	static_assert(1+sizeof...(Extent)==Rank,"The number of extents must match the rank.");
+	int shape[Rank] = {n1,extents...};
+	define(shape);
+	allocate(true);
+}
+
+
+/** ************************************************************************
+ * Copy constructor  for the Tensor class.
+ *
+ * The copy always owns its memory even if the original is a view.
+ *
+ * @param oldCopy The tensor to make a copy of.
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>::Tensor(const Tensor& oldCopy)
+{
+	define(oldCopy.extent);
+	allocate();
+	copyEntries(oldCopy);
+}
+
+
+/** ************************************************************************
+ * Move constructor  for the Tensor class.
+ *
+ * The new tensor takes over the memory of the old one, and the old
+ * one is left empty.
+ *
+ * @param oldCopy The tensor to take the memory from.
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>::Tensor(Tensor&& oldCopy)
+{
+	int lupe;
+	for(lupe=0;lupe<Rank;++lupe)
+		{
+			extent[lupe] = oldCopy.extent[lupe];
+			stride[lupe] = oldCopy.stride[lupe];
+		}
+	size   = oldCopy.size;
+	values = oldCopy.values;
+	owner  = oldCopy.owner;
+	oldCopy.values = NULL;
+	oldCopy.size   = 0;
+	oldCopy.owner  = true;
+}
+
+
+/** ************************************************************************
+ * Destructor for the Tensor class.
+ *
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>::~Tensor()
+{
+	release();
+}
+
+
+/** ************************************************************************
+ * Define a tensor that is a view of memory that belongs to something
+ * else. The memory is not released when the tensor is destroyed, and
+ * the last dimension is not padded.
+ *
+ * @param memory The block of memory to use.
+ * @param n1 The number of entries in the first dimension.
+ * @param extents The number of entries in the remaining dimensions.
+ * @return The tensor that uses the memory.
+ * ************************************************************************ */
+template <class number,int Rank>
+template <class... Extent>
+Tensor<number,Rank> Tensor<number,Rank>::view(number *memory,int n1,Extent... extents)
+{
+	static_assert(1+sizeof...(Extent)==Rank,"The number of extents must match the rank.");
+	int shape[Rank] = {n1,extents...};
+	return(view(memory,shape));
+}
+
+
+/** ************************************************************************
+ * Define a tensor that is a view of memory that belongs to something
+ * else when the shape is only known when the program runs.
+ *
+ * @param memory The block of memory to use.
+ * @param shape The number of entries in every dimension.
+ * @return The tensor that uses the memory.
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank> Tensor<number,Rank>::view(number *memory,const int *shape)
+{
+	Tensor<number,Rank> result;
+	int lupe;
+
+	for(lupe=0;lupe<Rank;++lupe)
+		result.extent[lupe] = shape[lupe];
+	result.stride[Rank-1] = 1;
+	for(lupe=Rank-2;lupe>=0;--lupe)
+		result.stride[lupe] = result.stride[lupe+1]*shape[lupe+1];
+	result.size   = result.stride[0]*shape[0];
+	result.values = memory;
+	result.owner  = false;
+	return(result);
+}
+
+
+/** ************************************************************************
+ * The assignment operator for the Tensor class.
+ *
+ * If the shapes are the same the entries are copied into the current
+ * memory. Otherwise the current memory is released and new memory is
+ * allocated, and a view becomes a tensor that owns its memory.
+ *
+ * @param oldCopy The tensor to copy.
+ * @return A reference to the current object.
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>& Tensor<number,Rank>::operator=(const Tensor& oldCopy)
+{
+	if(this == &oldCopy)
+		return(*this);
+
+	int lupe;
+	bool same = true;
+	for(lupe=0;lupe<Rank;++lupe)
+		same = same && (extent[lupe]==oldCopy.extent[lupe]);
+
+	if(!same)
+		{
+			release();
+			define(oldCopy.extent);
+			allocate();
+		}
+
+	copyEntries(oldCopy);
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * The move assignment operator for the Tensor class.
+ *
+ * The current memory is released, and the memory of the other tensor
+ * is taken over.
+ *
+ * @param oldCopy The tensor to take the memory from.
+ * @return A reference to the current object.
+ * ************************************************************************ */
+template <class number,int Rank>
+Tensor<number,Rank>& Tensor<number,Rank>::operator=(Tensor&& oldCopy)
+{
+	if(this == &oldCopy)
+		return(*this);
+
+	release();
+	int lupe;
+	for(lupe=0;lupe<Rank;++lupe)
+		{
+			extent[lupe] = oldCopy.extent[lupe];
+			stride[lupe] = oldCopy.stride[lupe];
+		}
+	size   = oldCopy.size;
+	values = oldCopy.values;
+	owner  = oldCopy.owner;
+	oldCopy.values = NULL;
+	oldCopy.size   = 0;
+	oldCopy.owner  = true;
+	return(*this);
+}
+
+
+/** ************************************************************************
+ * Set the extents and the strides for a given shape.
+ *
+ * The last dimension is padded so that every row starts on an
+ * ARRAYALIGNMENT byte boundary.
+ *
+ * @param extents The number of entries in each dimension.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int Rank>
+void Tensor<number,Rank>::define(const int *extents)
+{
+	int lupe;
+	int perLine = ARRAYALIGNMENT/sizeof(number);
+	if(perLine<1)
+		perLine = 1;
+
+	for(lupe=0;lupe<Rank;++lupe)
+		extent[lupe] = extents[lupe];
+
+	stride[Rank-1] = 1;
+	if(Rank>1)
+		stride[Rank-2] = ((extent[Rank-1]+perLine-1)/perLine)*perLine;
+	for(lupe=Rank-3;lupe>=0;--lupe)
+		stride[lupe] = stride[lupe+1]*extent[lupe+1];
+
+	size   = stride[0]*extent[0];
+	values = NULL;
+	owner  = true;
+}
+
+
+/** ************************************************************************
+ * Copy the entries from a tensor of the same shape.
+ *
+ * If the two tensors have the same strides the block is copied in one
+ * pass. Otherwise it is copied one row at a time, where a row is the
+ * set of entries that only differ in the last index, and the padding
+ * at the end of each row is set to zero. The padding is always zero so
+ * that the routines that work on the whole block, like the dot product
+ * and the norm, do not need to skip it.
+ *
+ * @param from The tensor to copy.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int Rank>
+void Tensor<number,Rank>::copyEntries(const Tensor& from)
+{
+	int lupe;
+	bool same = true;
+	for(lupe=0;lupe<Rank;++lupe)
+		same = same && (stride[lupe]==from.stride[lupe]);
+
+	number * TENSORRESTRICT to = values;
+	const number * TENSORRESTRICT source = from.values;
+	if(same)
+		{
+			std::size_t entry;
+			for(entry=0;entry<size;++entry)
+				to[entry] = source[entry];
+			return;
+		}
+
+	// Go through every row. The row number is split into the indices
+	// for the first Rank-1 dimensions.
+	std::size_t rows = 1;
+	for(lupe=0;lupe<Rank-1;++lupe)
+		rows *= extent[lupe];
+
+	std::size_t rowLength = (Rank>1) ? stride[Rank-2] : (std::size_t)extent[Rank-1];
+	std::size_t row;
+	for(row=0;row<rows;++row)
+		{
+			std::size_t position = row;
+			std::size_t toOffset = 0;
+			std::size_t fromOffset = 0;
+			for(lupe=Rank-2;lupe>=0;--lupe)
+				{
+					std::size_t index = position%extent[lupe];
+					position /= extent[lupe];
+					toOffset   += index*stride[lupe];
+					fromOffset += index*from.stride[lupe];
+				}
+
+			std::size_t inner;
+			for(inner=0;inner<(std::size_t)extent[Rank-1];++inner)
+				to[toOffset+inner] = source[fromOffset+inner];
+			for(;inner<rowLength;++inner)
+				to[toOffset+inner] = 0.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Get the memory for the entries. The memory is not initialized
+ * unless zero pages are mapped on demand.
+ *
+ * @param lazy Flag to indicate whether or not to map zero pages.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int Rank>
+void Tensor<number,Rank>::allocate(bool lazy)
+{
+	if(lazy)
+		values = static_cast<number*>(MemoryPool::allocateZeroed(size*sizeof(number)));
+	else
+		values = static_cast<number*>(MemoryPool::allocate(size*sizeof(number)));
+	owner  = true;
+}
+
+
+/** ************************************************************************
+ * Set every entry to zero.
+ *
+ * For a new block this is the first time the memory is touched. The
+ * slices for the first index are split between the threads with a
+ * static schedule so that the pages are placed near the threads that
+ * use them. A block reused from a pool keeps the pages it already has.
+ *
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int Rank>
+void Tensor<number,Rank>::zero()
+{
+	int lupe;
+	int slices = extent[0];
+	std::size_t length = stride[0];
+
+#pragma omp parallel for schedule(static)
+	for(lupe=0;lupe<slices;++lupe)
+		{
+			number *entry = values + lupe*length;
+			for(std::size_t inner=0;inner<length;++inner)
+				entry[inner] = 0.0;
+		}
+}
+
+
+/** ************************************************************************
+ * Give the memory back if the tensor owns it.
+ *
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int Rank>
+void Tensor<number,Rank>::release()
+{
+	if(owner && (values!=NULL))
+		MemoryPool::release(values);
+	values = NULL;
+	size   = 0;
+}
+
+
+
+#endif
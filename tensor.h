@@ -0,0 +1,262 @@
+#ifndef TENSORROUTINE
+#define TENSORROUTINE
+
+
+/** *********************************************************************************
+ * @file tensor.h
+ * @class Tensor
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to keep a multi-dimensional array in a single block of memory.
+ *
+ * This is the definition (header) file for the Tensor class. The
+ * rank is fixed at compile time, and an entry is found from its
+ * indices and the strides of the dimensions, so there is no table of
+ * row pointers to load. The last dimension is padded so that every
+ * row starts on an ARRAYALIGNMENT byte boundary. The memory comes
+ * from the active MemoryPool if there is one, and it is released when
+ * the object is destroyed. A tag can be given to the constructor to
+ * leave the entries unset or to map zero pages that are touched on
+ * demand. A tensor can also be a view of memory
+ * that belongs to something else, in which case the memory is not
+ * released.
+ *
+ *
+ * @brief Header file for the contiguous multi-dimensional array.
+ *
+ * ********************************************************************************* */
+
+#include <cstddef>
+#include "pool.h"
+
+// Qualifier used for pointers that do not alias any other pointer in
+// the same loop.
+#if defined(__GNUC__)
+#define TENSORRESTRICT __restrict__
+#else
+#define TENSORRESTRICT
+#endif
+
+// Tags used to select how the entries of a new tensor are set. By
+// default every entry is set to zero.
+struct TensorUninitialized {};  //< The entries are not set and must be written before they are read.
+struct TensorZeroOnDemand {};   //< The entries are zero pages that are not touched until first used.
+
+
+template <class number,int Rank>
+class Tensor
+{
+
+public:
+	Tensor();                                                   //< Constructor for an empty tensor
+	template <class... Extent>
+	explicit Tensor(int n1,Extent... extents);                  //< Constructor for a tensor of a given shape
+	template <class... Extent>
+	Tensor(TensorUninitialized,int n1,Extent... extents);       //< Constructor that does not set the entries
+	template <class... Extent>
+	Tensor(TensorZeroOnDemand,int n1,Extent... extents);        //< Constructor with zero pages mapped on demand
+	Tensor(const Tensor& oldCopy);                              //< Constructor for making a copy/duplicate
+	Tensor(Tensor&& oldCopy);                                   //< Constructor that takes over the memory of another tensor
+	~Tensor();                                                  //< Destructor for the class
+
+	Tensor& operator=(const Tensor& oldCopy);                   //< Assignment operator for copying another tensor
+	Tensor& operator=(Tensor&& oldCopy);                        //< Assignment operator that takes over the memory of another tensor
+
+	template <class... Extent>
+	static Tensor view(number *values,int n1,Extent... extents); //< A tensor that uses memory it does not own
+	static Tensor view(number *values,const int *extents);       //< A view with a shape given by an array
+
+	/**
+		 The parenthesis operator used to access an entry.
+
+		 @param index The indices of the entry, one for every dimension.
+		 @return A reference to the entry.
+	 */
+	template <class... Index>
+	number& operator()(Index... index)
+	{
+		static_assert(sizeof...(Index)==Rank,"The number of indices must match the rank.");
+		return(values[offset(index...)]);
+	}
+
+	/**
+		 The parenthesis operator used to access an entry.
+
+		 @param index The indices of the entry, one for every dimension.
+		 @return A constant reference to the entry.
+	 */
+	template <class... Index>
+	const number& operator()(Index... index) const
+	{
+		static_assert(sizeof...(Index)==Rank,"The number of indices must match the rank.");
+		return(values[offset(index...)]);
+	}
+
+	/**
+		 Method to get the pointer to the first entry.
+
+		 @return A pointer to the block of memory.
+	 */
+	number *data()
+	{
+		return(values);
+	}
+
+	/**
+		 Method to get the pointer to the first entry.
+
+		 @return A constant pointer to the block of memory.
+	 */
+	const number *data() const
+	{
+		return(values);
+	}
+
+	/**
+		 Method to get the pointer to the first entry with a given value
+		 of the first index.
+
+		 @param lupe The value of the first index.
+		 @return A pointer to the start of the slice.
+	 */
+	number *slice(int lupe)
+	{
+		return(values+lupe*stride[0]);
+	}
+
+	/**
+		 Method to get the pointer to the first entry with a given value
+		 of the first index.
+
+		 @param lupe The value of the first index.
+		 @return A constant pointer to the start of the slice.
+	 */
+	const number *slice(int lupe) const
+	{
+		return(values+lupe*stride[0]);
+	}
+
+	/**
+		 Method to get the number of entries in a dimension.
+
+		 @param dimension The dimension.
+		 @return The number of entries.
+	 */
+	int getExtent(int dimension) const
+	{
+		return(extent[dimension]);
+	}
+
+	/**
+		 Method to get the distance between consecutive entries in a
+		 dimension.
+
+		 @param dimension The dimension.
+		 @return The stride in entries.
+	 */
+	std::size_t getStride(int dimension) const
+	{
+		return(stride[dimension]);
+	}
+
+	/**
+		 Method to get the number of entries in the block including
+		 the padding at the end of every row.
+
+		 @return The number of entries stored.
+	 */
+	std::size_t getSize() const
+	{
+		return(size);
+	}
+
+	/**
+		 Method to determine whether or not the tensor owns its memory.
+
+		 @return True if the tensor is a view of memory it does not own.
+	 */
+	bool isView() const
+	{
+		return(!owner);
+	}
+
+
+protected:
+
+	void define(const int *extents);                            //< Set the extents and strides.
+	void copyEntries(const Tensor& from);                       //< Copy the entries from a tensor of the same shape.
+	void allocate(bool lazy=false);                             //< Get the memory for the entries.
+	void zero();                                                //< Set every entry to zero.
+	void release();                                             //< Give the memory back.
+
+	/**
+		 Determine the position of an entry from the last index.
+
+		 @param index The last index.
+		 @return The offset of the entry.
+	 */
+	std::size_t offset(int index) const
+	{
+		return(index);
+	}
+
+	/**
+		 Determine the position of an entry from its indices.
+
+		 @param index The index for the current dimension.
+		 @param rest The indices for the remaining dimensions.
+		 @return The offset of the entry.
+	 */
+	template <class... Index>
+	std::size_t offset(int index,Index... rest) const
+	{
+		return(index*stride[Rank-1-sizeof...(Index)] + offset(rest...));
+	}
+
+
+private:
+
+	number *values;               //< The block of memory for the entries.
+	int extent[Rank];             //< The number of entries in each dimension.
+	std::size_t stride[Rank];     //< The distance between consecutive entries in each dimension.
+	std::size_t size;             //< The number of entries in the block.
+	bool owner;                   //< Flag to indicate whether or not the memory is released.
+
+};
+
+
+#include "tensor.cpp"
+
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef TRACEROUTINEDEFINITIONS
+#define TRACEROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file trace.cpp
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to record a timeline of a GMRES solve.
+ *
+ * This is the code file for the TraceBuffer and Tracer classes. The
+ * file is included by the header, so every method is declared inline.
+ *
+ *
+ * @brief Code file for the timeline of a solve.
+ *
+ * ********************************************************************************* */
+
+
+#include <ios>
+#include <iomanip>
+#include "trace.h"
+
+
+/** ************************************************************************
+ * Constructor for a buffer that belongs to the calling thread.
+ *
+ * @param number The number assigned to the thread.
+ * @param capacity The number of events in the ring. It must be a power of two.
+ * ************************************************************************ */
+inline TraceBuffer::TraceBuffer(int number,int capacity) :
+	ring(capacity), head(0)
+{
+	thread = number;
+	owner  = std::this_thread::get_id();
+	mask   = (unsigned long long)(capacity-1);
+}
+
+
+/** ************************************************************************
+ * Add an event to the ring. Only the thread that owns the buffer adds
+ * events, so the slot is written and then the new count is published
+ * for a reader.
+ *
+ * @param type The type of the event.
+ * @param name The name of the event.
+ * @param time The nanoseconds since the tracer was made.
+ * @param value The value of a counter event.
+ * ************************************************************************ */
+inline void TraceBuffer::record(char type,const char *name,unsigned long long time,double value)
+{
+	unsigned long long position = head.load(std::memory_order_relaxed);
+	TraceEvent &event = ring[position&mask];
+	event.time  = time;
+	event.name  = name;
+	event.value = value;
+	event.type  = type;
+	head.store(position+1,std::memory_order_release);
+}
+
+
+/** ************************************************************************
+ * Copy the events that are still in the ring, oldest first.
+ *
+ * @param list The vector the events are added to.
+ * ************************************************************************ */
+inline void TraceBuffer::events(std::vector<TraceEvent> &list) const
+{
+	unsigned long long last  = head.load(std::memory_order_acquire);
+	unsigned long long first = (last>ring.size()) ? last-ring.size() : 0;
+	for(;first<last;++first)
+		list.push_back(ring[first&mask]);
+}
+
+
+/** ************************************************************************
+ * Remove every event. The owner must not be recording.
+ *
+ * ************************************************************************ */
+inline void TraceBuffer::clear()
+{
+	head.store(0,std::memory_order_release);
+}
+
+
+/** ************************************************************************
+ * Base constructor for the Tracer class. The time of every event is
+ * measured from the time the tracer is made.
+ *
+ * @param events The number of events kept for each thread. It is rounded up to a power of two.
+ * ************************************************************************ */
+inline Tracer::Tracer(int events)
+{
+	capacity = 1;
+	while(capacity<events)
+		capacity *= 2;
+	identity = nextIdentity();
+	epoch    = std::chrono::steady_clock::now();
+}
+
+
+/** ************************************************************************
+ * Destructor for the Tracer class.
+ *
+ * The buffer for every thread is deleted. The threads must have
+ * stopped recording.
+ * ************************************************************************ */
+inline Tracer::~Tracer()
+{
+	std::vector<TraceBuffer*>::iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		delete *ptr;
+}
+
+
+/** ************************************************************************
+ * Get a number that is different for every tracer. A thread remembers
+ * the number of the last tracer it used rather than its address,
+ * since a new tracer can be made at the address of an old one.
+ *
+ * @return The next number.
+ * ************************************************************************ */
+inline unsigned long long Tracer::nextIdentity()
+{
+	static std::atomic<unsigned long long> count(0);
+	return(++count);
+}
+
+
+/** ************************************************************************
+ * The slot that holds the active tracer for the calling thread.
+ *
+ * @return A reference to the thread local pointer.
+ * ************************************************************************ */
+inline Tracer *&Tracer::activeSlot()
+{
+	static thread_local Tracer *tracer = NULL;
+	return(tracer);
+}
+
+
+/** ************************************************************************
+ * Get the tracer that is active for the calling thread.
+ *
+ * @return A pointer to the active tracer or NULL if there is not one.
+ * ************************************************************************ */
+inline Tracer *Tracer::active()
+{
+	return(activeSlot());
+}
+
+
+/** ************************************************************************
+ * Set the tracer that is active for the calling thread.
+ *
+ * @param tracer The tracer to make active. It can be NULL.
+ * @return N/A
+ * ************************************************************************ */
+inline void Tracer::setActive(Tracer *tracer)
+{
+	activeSlot() = tracer;
+}
+
+
+/** ************************************************************************
+ * Get the buffer for the calling thread. The last buffer used by the
+ * thread is kept in a thread local pointer, and the lock is only taken
+ * when the thread uses a different tracer. A thread that already has a
+ * buffer in this tracer gets the same one back.
+ *
+ * @return The buffer for the calling thread.
+ * ************************************************************************ */
+inline TraceBuffer *Tracer::buffer()
+{
+	static thread_local unsigned long long lastIdentity = 0;
+	static thread_local TraceBuffer *lastBuffer = 0;
+	if(lastIdentity==identity)
+		return(lastBuffer);
+
+	std::lock_guard<std::mutex> guard(lock);
+	std::thread::id self = std::this_thread::get_id();
+	TraceBuffer *found = 0;
+	std::vector<TraceBuffer*>::iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		if((*ptr)->getOwner()==self)
+			found = *ptr;
+
+	if(found==0)
+		{
+			found = new TraceBuffer((int)buffers.size(),capacity);
+			buffers.push_back(found);
+		}
+
+	lastIdentity = identity;
+	lastBuffer   = found;
+	return(found);
+}
+
+
+/** ************************************************************************
+ * Get the time since the tracer was made.
+ *
+ * @return The time in nanoseconds.
+ * ************************************************************************ */
+inline unsigned long long Tracer::now() const
+{
+	return((unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>
+				 (std::chrono::steady_clock::now()-epoch).count());
+}
+
+
+/** ************************************************************************
+ * Record the start of a span for the calling thread.
+ *
+ * @param name The name of the span.
+ * ************************************************************************ */
+inline void Tracer::begin(const char *name)
+{
+	buffer()->record(TRACEBEGIN,name,now(),0.0);
+}
+
+
+/** ************************************************************************
+ * Record the end of a span for the calling thread.
+ *
+ * @param name The name of the span.
+ * ************************************************************************ */
+inline void Tracer::end(const char *name)
+{
+	buffer()->record(TRACEEND,name,now(),0.0);
+}
+
+
+/** ************************************************************************
+ * Record a single point in time for the calling thread.
+ *
+ * @param name The name of the event.
+ * ************************************************************************ */
+inline void Tracer::instant(const char *name)
+{
+	buffer()->record(TRACEINSTANT,name,now(),0.0);
+}
+
+
+/** ************************************************************************
+ * Record the value of a counter.
+ *
+ * @param name The name of the counter.
+ * @param value The value of the counter.
+ * ************************************************************************ */
+inline void Tracer::counter(const char *name,double value)
+{
+	buffer()->record(TRACECOUNTER,name,now(),value);
+}
+
+
+/** ************************************************************************
+ * Remove the events from every buffer. No thread may be recording.
+ *
+ * ************************************************************************ */
+inline void Tracer::clear()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	std::vector<TraceBuffer*>::iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		(*ptr)->clear();
+}
+
+
+/** ************************************************************************
+ * Get the number of events that were overwritten in every buffer.
+ *
+ * @return The total number of events dropped.
+ * ************************************************************************ */
+inline unsigned long long Tracer::getDropped() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	unsigned long long dropped = 0;
+	std::vector<TraceBuffer*>::const_iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		dropped += (*ptr)->getDropped();
+	return(dropped);
+}
+
+
+/** ************************************************************************
+ * Write every event in the Chrome trace event format. The times are
+ * given in microseconds, and every thread is named by its number. If
+ * a ring was full the first events for the thread may end spans that
+ * were overwritten, and the viewers ignore them.
+ *
+ * @param output The stream to write to.
+ * ************************************************************************ */
+inline void Tracer::writeJSON(std::ostream &output) const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	std::ios_base::fmtflags flags = output.flags();
+	std::streamsize precision     = output.precision();
+	unsigned long long dropped    = 0;
+	bool first = true;
+
+	output << "{\"traceEvents\": [" << std::endl;
+	std::vector<TraceBuffer*>::const_iterator ptr;
+	for(ptr=buffers.begin();ptr!=buffers.end();++ptr)
+		{
+			int thread = (*ptr)->getThread();
+			dropped += (*ptr)->getDropped();
+			output << (first ? "  " : ",\n  ")
+						 << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+						 << ", \"args\": {\"name\": \"thread " << thread << "\"}}";
+			first = false;
+
+			std::vector<TraceEvent> list;
+			(*ptr)->events(list);
+			std::vector<TraceEvent>::const_iterator event;
+			for(event=list.begin();event!=list.end();++event)
+				{
+					output << ",\n  {\"name\": \"" << event->name << "\", \"cat\": \"gmres\", \"ph\": \""
+								 << event->type << "\", \"ts\": " << std::fixed << std::setprecision(3)
+								 << ((double)event->time)*1.0e-3 << ", \"pid\": 1, \"tid\": " << thread;
+					if(event->type==TRACECOUNTER)
+						output << ", \"args\": {\"" << event->name << "\": " << std::scientific
+									 << std::setprecision(6) << event->value << "}";
+					else if(event->type==TRACEINSTANT)
+						output << ", \"s\": \"t\"";
+					output << "}";
+				}
+		}
+	output << std::endl << "], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped\": "
+				 << dropped << "}}" << std::endl;
+
+	output.flags(flags);
+	output.precision(precision);
+}
+
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef TRACEROUTINE
+#define TRACEROUTINE
+
+
+/** *********************************************************************************
+ * @file trace.h
+ * @class Tracer
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Classes to record a timeline of a GMRES solve.
+ *
+ * This is the definition (header) file for the TraceBuffer, Tracer,
+ * and TraceMonitor classes. A Tracer keeps a TraceBuffer for every
+ * thread that records an event. A buffer is a ring of a fixed size
+ * that is only written by its own thread, so recording an event takes
+ * no lock and does not allocate. When a ring is full the oldest
+ * events are overwritten and counted as dropped. The buffer for a
+ * thread is found through a thread local pointer, and a lock is only
+ * taken the first time a thread records an event.
+ *
+ * The events are written in the Chrome trace event format, which can
+ * be read by chrome://tracing or Perfetto. The buffers should be
+ * written after the threads have stopped recording.
+ *
+ * The TraceMonitor class is a monitor for the GMRES routine. Every
+ * phase of the routine is recorded as a span, so each Arnoldi step
+ * holds its operator, preconditioner, Gram-Schmidt, and least squares
+ * spans, and each restart holds its update and the new residual. The
+ * relative residual is recorded as a counter.
+ *
+ * While a TraceMonitor is running its tracer is the active tracer for
+ * the thread that calls GMRES. The OpenMP parallel regions in the
+ * operators and preconditioners read the active tracer before the
+ * region starts, and every thread in the region records a TraceSpan
+ * for its share of the work. The spans of the worker threads appear
+ * under their own thread in the trace. A region that is entered when
+ * no tracer is active records nothing.
+ *
+ *
+ * @brief Header file for the timeline of a solve.
+ *
+ * ********************************************************************************* */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "monitor.h"
+
+// The number of events kept for each thread. It must be a power of two.
+#define TRACEBUFFEREVENTS 65536
+
+// The types of events, using the letters from the trace event format.
+#define TRACEBEGIN   'B'
+#define TRACEEND     'E'
+#define TRACEINSTANT 'i'
+#define TRACECOUNTER 'C'
+
+
+/**
+	 One event in a timeline. The name must be a string that lives as
+	 long as the tracer, usually a literal.
+ */
+struct TraceEvent
+{
+	unsigned long long time;    //< The nanoseconds since the tracer was made.
+	const char *name;           //< The name of the event.
+	double value;               //< The value of a counter event.
+	char type;                  //< The type of the event.
+};
+
+
+class TraceBuffer
+{
+
+public:
+	TraceBuffer(int thread,int capacity=TRACEBUFFEREVENTS); //< Constructor for a buffer that belongs to a thread
+
+	void record(char type,const char *name,unsigned long long time,double value); //< Add an event.
+	void events(std::vector<TraceEvent> &list) const;        //< Copy the events in the order they were recorded.
+	void clear();                                            //< Remove every event.
+
+	/**
+		 Method to get the number assigned to the thread that owns the buffer.
+
+		 @return The number of the thread.
+	 */
+	int getThread() const
+	{
+		return(thread);
+	}
+
+	/**
+		 Method to get the thread that owns the buffer.
+
+		 @return The id of the thread.
+	 */
+	std::thread::id getOwner() const
+	{
+		return(owner);
+	}
+
+	/**
+		 Method to get the number of events that have been recorded.
+
+		 @return The number of events including the ones overwritten.
+	 */
+	unsigned long long getRecorded() const
+	{
+		return(head.load(std::memory_order_acquire));
+	}
+
+	/**
+		 Method to get the number of events that were overwritten.
+
+		 @return The number of events lost when the ring was full.
+	 */
+	unsigned long long getDropped() const
+	{
+		unsigned long long recorded = getRecorded();
+		return((recorded>ring.size()) ? recorded-ring.size() : 0);
+	}
+
+
+private:
+	TraceBuffer(const TraceBuffer& oldCopy);              //< The buffer cannot be shared by copying.
+	TraceBuffer& operator=(const TraceBuffer& oldCopy);
+
+	int thread;                                 //< The number assigned to the thread.
+	std::thread::id owner;                      //< The thread that writes to the buffer.
+	std::vector<TraceEvent> ring;               //< The events.
+	unsigned long long mask;                    //< The size of the ring less one.
+	std::atomic<unsigned long long> head;       //< The number of events recorded.
+
+};
+
+
+class Tracer
+{
+
+public:
+	Tracer(int capacity=TRACEBUFFEREVENTS);     //< Default constructor for the class
+	~Tracer();                                  //< Destructor for the class
+
+	void begin(const char *name);               //< Record the start of a span.
+	void end(const char *name);                 //< Record the end of a span.
+	void instant(const char *name);             //< Record a single point in time.
+	void counter(const char *name,double value); //< Record the value of a counter.
+
+	void writeJSON(std::ostream &output) const; //< Write every event in the trace event format.
+	void clear();                               //< Remove every event.
+	unsigned long long getDropped() const;      //< The number of events overwritten in every buffer.
+	unsigned long long now() const;             //< The nanoseconds since the tracer was made.
+
+	// Define the methods used to keep track of the active tracer.
+	static Tracer *active();
+	static void setActive(Tracer *tracer);
+
+	/**
+		 Method to get the number of threads that have recorded an event.
+
+		 @return The number of buffers.
+	 */
+	int getThreads() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return((int)buffers.size());
+	}
+
+
+protected:
+	TraceBuffer *buffer();                      //< The buffer for the calling thread.
+	static unsigned long long nextIdentity();   //< A number that is different for every tracer.
+	static Tracer *&activeSlot();               //< The active tracer for the calling thread.
+
+
+private:
+	Tracer(const Tracer& oldCopy);              //< The buffers cannot be shared by copying.
+	Tracer& operator=(const Tracer& oldCopy);
+
+	unsigned long long identity;                //< The number that identifies the tracer to the threads.
+	int capacity;                               //< The number of events in each buffer.
+	std::chrono::steady_clock::time_point epoch; //< The time the tracer was made.
+	mutable std::mutex lock;                    //< Held while a buffer is added or the buffers are read.
+	std::vector<TraceBuffer*> buffers;          //< The buffer for every thread.
+
+};
+
+
+/**
+	 A span that is recorded for as long as the object exists. The
+	 tracer is given by the caller so that the threads in a parallel
+	 region can record into the tracer that was active on the thread
+	 that started the region. Nothing is recorded if it is NULL.
+ */
+class TraceSpan
+{
+
+public:
+	/**
+		 Constructor that records the start of the span.
+
+		 @param traceTo The tracer that keeps the events. It can be NULL.
+		 @param spanName The name of the span.
+	 */
+	TraceSpan(Tracer *traceTo,const char *spanName) : tracer(traceTo), name(spanName)
+	{
+		if(tracer)
+			tracer->begin(name);
+	}
+
+	/**
+		 Destructor that records the end of the span.
+	 */
+	~TraceSpan()
+	{
+		if(tracer)
+			tracer->end(name);
+	}
+
+
+private:
+	TraceSpan(const TraceSpan& oldCopy);        //< A span cannot be copied.
+
+	Tracer *tracer;                             //< The tracer that keeps the events, or NULL.
+	const char *name;                           //< The name of the span.
+
+};
+
+
+/**
+	 The monitor that records every phase of a GMRES solve in a Tracer.
+	 Its tracer is the active tracer for the calling thread from the
+	 start of the solve until it finishes.
+ */
+class TraceMonitor
+{
+
+public:
+	/**
+		 Constructor for a monitor that records into a tracer.
+
+		 @param traceTo The tracer that keeps the events.
+	 */
+	TraceMonitor(Tracer &traceTo) : tracer(traceTo), previous(NULL) {}
+
+	void start(int,int)
+	{
+		previous = Tracer::active();
+		Tracer::setActive(&tracer);
+		tracer.begin("solve");
+	}
+
+	void begin(int phase)
+	{
+		tracer.begin(SolveReport::phaseName(phase));
+	}
+
+	void end(int phase)
+	{
+		tracer.end(SolveReport::phaseName(phase));
+	}
+
+	void residual(int,double relative)
+	{
+		tracer.counter("residual",relative);
+	}
+
+	void restart()
+	{
+		tracer.instant("restart");
+	}
+
+	void finish(int,double,bool)
+	{
+		tracer.end("solve");
+		Tracer::setActive(previous);
+	}
+
+
+private:
+
+	Tracer &tracer;                             //< The tracer that keeps the events.
+	Tracer *previous;                           //< The tracer that was active before the solve.
+
+};
+
+
+#include "trace.cpp"
+
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef TRIDIAGONALROUTINEDEFINITIONS
+#define TRIDIAGONALROUTINEDEFINITIONS
+
+
+/* *********************************************************************************
+ * @file tridiagonal.cpp
+ * @class BatchedTridiagonal
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to solve many tridiagonal systems that share the same matrix.
+ *
+ * This is the code file for the BatchedTridiagonal class. It includes
+ * the Cholesky decomposition and the interleaved forward and
+ * backwards solves.
+ *
+ *
+ * @brief Code file for solving a batch of tridiagonal systems.
+ *
+ * ********************************************************************************* */
+
+
+#include <cmath>
+#include "util.h"
+#include "trace.h"
+#include "tridiagonal.h"
+
+
+/** ************************************************************************
+ * Base constructor  for the BatchedTridiagonal class.
+ *
+ * The decomposition is set to the identity until factor is called.
+ *
+ * @param size The number of unknowns in each line.
+ * ************************************************************************ */
+template <class number,int width>
+BatchedTridiagonal<number,width>::BatchedTridiagonal(int size)
+{
+	N = size;
+	reciprocal = ArrayUtils<number>::onetensor(N);
+	lower      = ArrayUtils<number>::onetensor(N);
+
+	int lupe;
+	for(lupe=0;lupe<N;++lupe)
+		reciprocal[lupe] = 1.0;
+}
+
+
+/** ************************************************************************
+ *	Copy constructor  for the BatchedTridiagonal class.
+ *
+ *	@param oldCopy The BatchedTridiagonal class member to make a copy of.
+ * ************************************************************************ */
+template <class number,int width>
+BatchedTridiagonal<number,width>::BatchedTridiagonal(const BatchedTridiagonal& oldCopy)
+{
+	N = oldCopy.getN();
+	reciprocal = ArrayUtils<number>::onetensor(N);
+	lower      = ArrayUtils<number>::onetensor(N);
+
+	int lupe;
+	for(lupe=0;lupe<N;++lupe)
+		{
+			reciprocal[lupe] = oldCopy.getReciprocal(lupe);
+			lower[lupe]      = oldCopy.getLower(lupe);
+		}
+}
+
+
+/** ************************************************************************
+ *	Destructor for the BatchedTridiagonal class.
+ *  ************************************************************************ */
+template <class number,int width>
+BatchedTridiagonal<number,width>::~BatchedTridiagonal()
+{
+	ArrayUtils<number>::delonetensor(reciprocal);
+	ArrayUtils<number>::delonetensor(lower);
+}
+
+
+/** ************************************************************************
+ * Find the Cholesky decomposition of a symmetric tridiagonal matrix.
+ *
+ * The matrix must be positive definite. The reciprocal of each
+ * diagonal entry of the decomposition is kept.
+ *
+ * @param diagonal The N diagonal entries of the matrix.
+ * @param offDiagonal The N-1 entries that couple row k to row k+1.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedTridiagonal<number,width>::factor(const number *diagonal,const number *offDiagonal)
+{
+	int lupe;
+	number root = sqrt(diagonal[0]);
+	reciprocal[0] = 1.0/root;
+	lower[0] = 0.0;
+	for(lupe=1;lupe<N;++lupe)
+		{
+			lower[lupe] = offDiagonal[lupe-1]*reciprocal[lupe-1];
+			root = sqrt(diagonal[lupe]-lower[lupe]*lower[lupe]);
+			reciprocal[lupe] = 1.0/root;
+		}
+}
+
+
+/** ************************************************************************
+ * Solve a set of interleaved tridiagonal systems.
+ *
+ * Entry k of line l is at lines[k*stride+l], and the solution replaces
+ * the right hand side. The lines are taken width at a time, and the
+ * lines left over at the end are solved one at a time. The groups are
+ * independent and are divided among the threads, and every thread
+ * records its share in the active tracer.
+ *
+ * @param lines The interleaved right hand sides.
+ * @param stride The distance between consecutive entries of a line.
+ * @param count The number of lines to solve.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedTridiagonal<number,width>::solve(number *lines,int stride,int count) const
+{
+	int groups = count/width;
+	int group;
+	int lupe;
+
+	Tracer *tracer = Tracer::active();
+#pragma omp parallel
+	{
+		TraceSpan span(tracer,"tridiagonal");
+#pragma omp for
+		for(group=0;group<groups;++group)
+			solveGroup(lines+group*width,stride);
+	}
+
+	for(lupe=groups*width;lupe<count;++lupe)
+		solveLine(lines+lupe,stride);
+}
+
+
+/** ************************************************************************
+ * Solve width interleaved tridiagonal systems.
+ *
+ * The previous entry for every line is kept in a small array so that
+ * each step of the recurrence is one vector operation over the group.
+ *
+ * @param lines The first line in the group.
+ * @param stride The distance between consecutive entries of a line.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedTridiagonal<number,width>::solveGroup(number *lines,int stride) const
+{
+	number previous[width];
+	number *row;
+	int lupe;
+	int lane;
+
+	// Perform the forward solve.
+	row = lines;
+#pragma omp simd
+	for(lane=0;lane<width;++lane)
+		{
+			row[lane] *= reciprocal[0];
+			previous[lane] = row[lane];
+		}
+
+	for(lupe=1;lupe<N;++lupe)
+		{
+			row = lines + lupe*stride;
+			number multiplier = lower[lupe];
+			number scale = reciprocal[lupe];
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				{
+					row[lane] = (row[lane]-multiplier*previous[lane])*scale;
+					previous[lane] = row[lane];
+				}
+		}
+
+	// Perform the backwards solve.
+	row = lines + (N-1)*stride;
+#pragma omp simd
+	for(lane=0;lane<width;++lane)
+		{
+			row[lane] *= reciprocal[N-1];
+			previous[lane] = row[lane];
+		}
+
+	for(lupe=N-2;lupe>=0;--lupe)
+		{
+			row = lines + lupe*stride;
+			number multiplier = lower[lupe+1];
+			number scale = reciprocal[lupe];
+#pragma omp simd
+			for(lane=0;lane<width;++lane)
+				{
+					row[lane] = (row[lane]-multiplier*previous[lane])*scale;
+					previous[lane] = row[lane];
+				}
+		}
+}
+
+
+/** ************************************************************************
+ * Solve a single tridiagonal system.
+ *
+ * @param line The first entry in the line.
+ * @param stride The distance between consecutive entries of the line.
+ * @return N/A
+ * ************************************************************************ */
+template <class number,int width>
+void BatchedTridiagonal<number,width>::solveLine(number *line,int stride) const
+{
+	int lupe;
+
+	line[0] *= reciprocal[0];
+	for(lupe=1;lupe<N;++lupe)
+		line[lupe*stride] = (line[lupe*stride]-lower[lupe]*line[(lupe-1)*stride])*reciprocal[lupe];
+
+	line[(N-1)*stride] *= reciprocal[N-1];
+	for(lupe=N-2;lupe>=0;--lupe)
+		line[lupe*stride] = (line[lupe*stride]-lower[lupe+1]*line[(lupe+1)*stride])*reciprocal[lupe];
+}
+
+
+#endif
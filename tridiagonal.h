@@ -0,0 +1,133 @@
+#ifndef TRIDIAGONALROUTINE
+#define TRIDIAGONALROUTINE
+
+
+/** *********************************************************************************
+ * @file tridiagonal.h
+ * @class BatchedTridiagonal
+ * @author Kelly Black <kjblack@gmail.com>
+ * @version 0.1
+ * @copyright BSD 2-Clause License
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2014, Kelly Black
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ *
+ * Class to solve many tridiagonal systems that share the same matrix.
+ *
+ * This is the definition (header) file for the BatchedTridiagonal
+ * class. The matrix is symmetric and positive definite, and its
+ * Cholesky decomposition is kept with the reciprocals of the diagonal
+ * so that the forward and backwards solves do not divide. The right
+ * hand sides are interleaved so that entry k of line l is at
+ * position k*stride+l. The lines are solved in groups of width lines
+ * at a time, and the inner loop over a group is a vector operation
+ * while the recurrence runs along k.
+ *
+ *
+ * @brief Header file for solving a batch of tridiagonal systems.
+ *
+ * ********************************************************************************* */
+
+
+template <class number,int width=8>
+class BatchedTridiagonal
+{
+
+public:
+	BatchedTridiagonal(int size);                               //< Default constructor for the class
+	BatchedTridiagonal(const BatchedTridiagonal& oldCopy);      //< Constructor for making a copy/duplicate
+	~BatchedTridiagonal();                                      //< Destructor for the class
+
+	// Define the methods to define the decomposition and to solve
+	// the systems.
+	void factor(const number *diagonal,const number *offDiagonal);
+	void solve(number *lines,int stride,int count) const;
+
+	/**
+		 Method to get the number of unknowns in each line.
+
+		 @return The number of rows in the matrix.
+	 */
+	int getN() const
+	{
+		return(N);
+	}
+
+	/**
+		 Method to get the number of lines that are solved together.
+
+		 @return The number of lines in each group.
+	 */
+	static int getWidth()
+	{
+		return(width);
+	}
+
+	/**
+		 Method to get the reciprocal of a diagonal entry of the
+		 Cholesky decomposition.
+
+		 @param row The row in the decomposition.
+		 @return The reciprocal of the diagonal entry.
+	 */
+	number getReciprocal(int row) const
+	{
+		return(reciprocal[row]);
+	}
+
+	/**
+		 Method to get the entry just below the diagonal of the
+		 Cholesky decomposition.
+
+		 @param row The row in the decomposition.
+		 @return The entry in the given row and the previous column.
+	 */
+	number getLower(int row) const
+	{
+		return(lower[row]);
+	}
+
+protected:
+
+	void solveGroup(number *lines,int stride) const;            //< Solve one full group of lines.
+	void solveLine(number *line,int stride) const;              //< Solve one line on its own.
+
+private:
+
+	int N;                 //< The number of unknowns in each line.
+	number *reciprocal;    //< The reciprocals of the diagonal of the Cholesky decomposition.
+	number *lower;         //< The entries just below the diagonal of the decomposition.
+
+};
+
+
+#include "tridiagonal.cpp"
+
+
+#endif
@@ -399,4 +399,260 @@ void ArrayUtils<number>::delonetensor(number *u) {
 
 
 
+/** ************************************************************************
+ * Template for allocating a block of aligned memory.
+ *
+ * The block is aligned on an ARRAYALIGNMENT byte boundary and comes
+ * from the active MemoryPool if there is one. If huge pages are
+ * requested and the block is at least as big as a huge page, then
+ * the block comes directly from the system, and the kernel is asked
+ * to back it with transparent huge pages. The memory is not
+ * initialized.
+ *
+ * @param length Number of entries in the block.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the block created.
+ *
+ * ************************************************************************ */
+template <class number>
+number *ArrayUtils<number>::alignedblock(std::size_t length,bool hugePages) {
+
+  return(static_cast<number*>(MemoryPool::allocate(length*sizeof(number),hugePages)));
+
+}
+
+
+/** ************************************************************************
+ * Template for determining the padded length of a row.
+ *
+ * The length of a row is rounded up so that every row starts on an
+ * ARRAYALIGNMENT byte boundary.
+ *
+ * @param n2 Number of entries in a row.
+ * @return The number of entries between the starts of two rows.
+ *
+ * ************************************************************************ */
+template <class number>
+int ArrayUtils<number>::rowstride(int n2) {
+  int perLine = ARRAYALIGNMENT/sizeof(number);
+
+  if(perLine<1)
+    perLine = 1;
+  return(((n2+perLine-1)/perLine)*perLine);
+
+}
+
+
+/** ************************************************************************
+ * Template for determining the space for the table of row pointers.
+ *
+ * The length is rounded up so the entries after the table start on
+ * an aligned boundary.
+ *
+ * @param n1 Number of rows.
+ * @return The number of bytes used by the table.
+ *
+ * ************************************************************************ */
+template <class number>
+std::size_t ArrayUtils<number>::tablebytes(int n1) {
+
+  return(((n1*sizeof(number*)+ARRAYALIGNMENT-1)/ARRAYALIGNMENT)*ARRAYALIGNMENT);
+
+}
+
+
+/** ************************************************************************
+ * Template for defining the table of row pointers in a block.
+ *
+ * The row pointers come first in the block, and the entries follow.
+ *
+ * @param block The block of memory with room for the table and entries.
+ * @param n1 Number of entries for the first dimension.
+ * @param n2 Number of entries for the second dimension.
+ * @return A pointer to the array.
+ *
+ * ************************************************************************ */
+template <class number>
+number **ArrayUtils<number>::rowtable(void *block,int n1,int n2) {
+  number **u = static_cast<number**>(block);
+  int stride = rowstride(n2);
+  int s;
+
+  u[0] = reinterpret_cast<number*>(reinterpret_cast<char*>(u)+tablebytes(n1));
+  for(s=1;s<n1;++s)
+    u[s] = u[0] + ((std::size_t) s)*stride;
+
+  return(u);
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned two dimensional array.
+ *
+ * The table of row pointers and the entries are kept in a single
+ * block. The length of every row is rounded up so that every row
+ * starts on an ARRAYALIGNMENT byte boundary. The rows are zeroed in
+ * parallel with a static schedule so that the pages for a block of
+ * rows are placed near the thread that works on those rows.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @param n2 Number of entries for the second dimension.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number **ArrayUtils<number>::alignedtwotensor(int n1,int n2,bool hugePages) {
+  number **u = uninitializedtwotensor(n1,n2,hugePages);
+  int stride = rowstride(n2);
+  int s;
+
+#pragma omp parallel for schedule(static)
+  for(s=0;s<n1;++s)
+    for(int i=0;i<stride;++i)
+      u[s][i] = 0.0;
+
+  return(u);
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned one dimensional array.
+ *
+ * The entries are zeroed in parallel with a static schedule.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number *ArrayUtils<number>::alignedonetensor(int n1,bool hugePages) {
+  number *u = uninitializedonetensor(n1,hugePages);
+  int i;
+
+#pragma omp parallel for schedule(static)
+  for(i=0;i<n1;++i)
+    u[i] = 0.0;
+
+  return(u);
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned two dimensional array that is
+ * not initialized.
+ *
+ * The layout is the same as for alignedtwotensor, but the entries are
+ * not written. It is up to the caller to write every entry before it
+ * is read.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @param n2 Number of entries for the second dimension.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number **ArrayUtils<number>::uninitializedtwotensor(int n1,int n2,bool hugePages) {
+  std::size_t bytes = tablebytes(n1)+((std::size_t) n1)*rowstride(n2)*sizeof(number);
+
+  return(rowtable(MemoryPool::allocate(bytes,hugePages),n1,n2));
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned one dimensional array that is
+ * not initialized.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @param hugePages Flag to indicate whether or not to request huge pages.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number *ArrayUtils<number>::uninitializedonetensor(int n1,bool hugePages) {
+
+  return(alignedblock(n1,hugePages));
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned two dimensional array whose
+ * pages are zeroed on demand.
+ *
+ * The memory is an anonymous mapping, so every entry is zero but the
+ * pages are not touched until they are first used. Only the table of
+ * row pointers is written here.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @param n2 Number of entries for the second dimension.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number **ArrayUtils<number>::lazytwotensor(int n1,int n2) {
+  std::size_t bytes = tablebytes(n1)+((std::size_t) n1)*rowstride(n2)*sizeof(number);
+
+  return(rowtable(MemoryPool::allocateZeroed(bytes),n1,n2));
+
+}
+
+
+/** ************************************************************************
+ * Template for allocating an aligned one dimensional array whose
+ * pages are zeroed on demand.
+ *
+ * @param n1 Number of entries for the first dimension.
+ * @return A pointer to the array created.
+ *
+ * ************************************************************************ */
+template <class number>
+number *ArrayUtils<number>::lazyonetensor(int n1) {
+
+  return(static_cast<number*>(MemoryPool::allocateZeroed(((std::size_t) n1)*sizeof(number))));
+
+}
+
+
+/** *************************************************************
+ * Template for deleting an aligned two dimensional array.
+ *
+ * @param u pointer to the array to be deleted.
+ * 
+ * ************************************************************** */
+template <class number>
+void ArrayUtils<number>::delalignedtwotensor(number **u) {
+
+  if(u==NULL)
+    return;
+
+  MemoryPool::release(u);
+
+}
+
+
+/** *************************************************************
+ * Template for deleting an aligned one dimensional array.
+ *
+ * @param u pointer to the array to be deleted.
+ * 
+ * ************************************************************** */
+template <class number>
+void ArrayUtils<number>::delalignedonetensor(number *u) {
+
+  if(u==NULL)
+    return;
+
+  MemoryPool::release(u);
+
+}
+
+
+
 #endif
@@ -52,6 +52,9 @@
  * ********************************************************************************* */
 
 
+#include <cstddef>
+#include "pool.h"
+
 template <class number>
 class ArrayUtils
 {
@@ -82,6 +85,31 @@ public:
 	static void deltwotensor(number **u);
 	static void delonetensor(number *u);
 
+	// Define the methods used to allocate aligned memory. The memory
+	// comes from the active MemoryPool if there is one, and it is
+	// first touched in parallel using the same static partition of
+	// the rows that is used by the compute kernels.
+	static number **alignedtwotensor(int n1,int n2,bool hugePages=false);
+	static number *alignedonetensor(int n1,bool hugePages=false);
+	static void delalignedtwotensor(number **u);
+	static void delalignedonetensor(number *u);
+
+	// Define the methods used to allocate aligned memory that is not
+	// initialized. These are for arrays that are written before they
+	// are read. The lazy versions map pages that are zero and are not
+	// touched until they are first used. All of them are deleted with
+	// the aligned delete routines.
+	static number **uninitializedtwotensor(int n1,int n2,bool hugePages=false);
+	static number *uninitializedonetensor(int n1,bool hugePages=false);
+	static number **lazytwotensor(int n1,int n2);
+	static number *lazyonetensor(int n1);
+
+protected:
+	static number *alignedblock(std::size_t length,bool hugePages);
+	static int rowstride(int n2);
+	static std::size_t tablebytes(int n1);
+	static number **rowtable(void *block,int n1,int n2);
+
 };
 
 